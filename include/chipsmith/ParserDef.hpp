@@ -16,6 +16,7 @@ class def_component;
 class def_net;
 
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <vector>
 #include <cmath> 		 // abs
@@ -23,6 +24,7 @@ class def_net;
 #include <set>
 #include <ctime>
 #include "chipsmith/genFunc.hpp"
+#include "chipsmith/dbCache.hpp"
 // #include "chipsmith/ParserBlif.hpp"
 
 using namespace std;
@@ -46,6 +48,10 @@ class def_file{
 		set<string> validNBlkWords = {"COMPONENTS", "SPECIALNETS", "NETS"};
 
 		void createAuto(vector<string> &inLine);
+		size_t parseStatements(const vector<string_view> &compStmts,
+		                       const vector<string_view> &netStmts,
+		                       const vector<string_view> &snetStmts,
+		                       unsigned int threads);
 
 	public:
 		def_file(){};
@@ -55,13 +61,17 @@ class def_file{
 		vector<def_net> nets;
 		vector<def_net> snets;
 
-		int importFile(const string &fileName);
+		int importFile(const string &fileName, unsigned int threads = 0);
 		// int importNodesNets(vector<BlifNode> inNodes,
   //                      vector<BlifNet> inNets);
 		vector<def_component> getComps(){return this->comps;};
 		vector<def_net> getNets(){return this->nets;};
 
 
+		int saveCache(const string &fileName, const string &cacheDir);
+		int loadCache(const string &fileName, const string &cacheDir);
+		bool operator==(const def_file &other) const;
+
 		int to_def(const string &fileName);
 		int to_jpg(const string &fileName);
 		void to_str();
@@ -89,7 +99,7 @@ class def_component{
 		string compType = "\0"; // uhm?
 
 
-		int createAuto(vector<string> &inLine);
+		int createAuto(const vector<string_view> &inLine);
 
 		string getName(){return name;}
 		string getCompType(){return compName;}
@@ -108,6 +118,7 @@ class def_component{
 									+ to_string(corX) + " "
 									+ to_string(corY) + " ) N ;";
 		}
+		bool operator==(const def_component &other) const;
 		void to_str();
 };
 
@@ -123,6 +134,8 @@ struct net_route{
 
 	vector<int> ptX;
 	vector<int> ptY;
+
+	bool operator==(const net_route &other) const;
 };
 
 class def_net{
@@ -149,14 +162,15 @@ class def_net{
 		// tracks
 		std::vector<net_route> routes;
 
-		int createAuto(vector<vector<string> > &inBlock);
-		int createAutoSpecial(vector<vector<string> > &inBlock); // use with special nets
+		int createAuto(const vector<vector<string_view> > &inBlock);
+		int createAutoSpecial(const vector<vector<string_view> > &inBlock); // use with special nets
 
 		string to_def(){
 			return "- " + name
 					 + "\n( " + fromComp + " " + fromPin + " )"
 					 + "\n( " + ToComp + " " + ToPin + " )"  + " ;";
 		}
+		bool operator==(const def_net &other) const;
 		void to_str();
 		void get_route(vector<net_route> &VecOut){VecOut = this->routes;};
 		string get_varName(){return name;}
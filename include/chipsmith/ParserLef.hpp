@@ -18,6 +18,7 @@
 #include <set>
 #include "toml/toml.hpp"
 #include "chipsmith/genFunc.hpp"
+#include "chipsmith/dbCache.hpp"
 #include <ctime>
 // #include <map>
 
@@ -59,6 +60,9 @@ class lef_file{
 		int importFile(const string &fileName);
 		int importGDF(const string &fileName);
 		int exportLef(const string &fileName);
+		int saveCache(const string &fileName, const string &cacheDir);
+		int loadCache(const string &fileName, const string &cacheDir);
+		bool operator==(const lef_file &other) const;
 
 		void to_str();
 };
@@ -72,12 +76,16 @@ struct macro_port{
 	string layer = "\0";
 	vector<double> ptsX;
 	vector<double> ptsY;
+
+	bool operator==(const macro_port &other) const;
 };
 
 struct macro_pin{
 	string name = "\0";
 	string direction = "\0";
 	vector<macro_port> ports;
+
+	bool operator==(const macro_pin &other) const;
 };
 
 class lef_macro{
@@ -106,6 +114,7 @@ class lef_macro{
 		double getOriginY(){return originY;}
 		void get_varPIN(vector<macro_pin> &VecOut){VecOut = pins;};
 		int get_noPIN(){return pins.size();}
+		bool operator==(const lef_macro &other) const;
 		void to_str();
 };
 
@@ -134,6 +143,7 @@ class lef_layer{
     float get_varPitch() {return pitch;}
     float get_varWidth() {return width;}
 
+    bool operator==(const lef_layer &other) const;
     void to_str();
 };
 
@@ -158,6 +168,7 @@ class lef_via{
 		// void get_varLayerNames(string arrayIn){arrayIn = *LayerNames;}
 		// void get_varLayerDim(float *arrayIn){arrayIn = *layerDim;}
 
+		bool operator==(const lef_via &other) const;
 		void to_str();
 };
 
@@ -18,14 +18,24 @@
 #include <set>
 #include <iostream>
 #include <cmath>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <algorithm>
 #include "toml/toml.hpp"
 #include "chipsmith/ParserLef.hpp"
 #include "chipsmith/ParserDef.hpp"
+#include "chipsmith/fillGrid.hpp"
+#include "chipsmith/spatialIndex.hpp"
+#include "chipsmith/gdsCache.hpp"
 #include "gdscpp/gdsCpp.hpp"
 
 using namespace std;
 
 int constrain(int inVal, int lowerLimit, int upperLimit);
+// maxCnt - COLROW is a signed 2 byte integer
+int placeFillArray(const fillGrid &grid, const gdsName &fillName, int originX, int originY,
+                   int pitch, gdsSTR &target, unsigned int maxCnt = 32767);
 
 class chipSmith{
   private:
@@ -43,10 +53,16 @@ class chipSmith{
     map<string, string> gdsFillFileLoc;
 
     // map<string, vector<int>> cellSize;
-    vector<vector<vector<bool>>> grid;
+    vector<fillGrid> grid;
     // grid[0] - All; grid[n] - M_n;
 
+    spatialIndex placed; // Gates, nets, vias and biases, see indexPlacement()
+
     bool fillEnable = true;
+    bool cacheEnable = false; // Keep binary snapshots of the inputs, see dbCache/gdsCache
+    string cacheDir; // Where the snapshots go, "" - next to the inputs
+    bool fillArray = false; // Fill as AREFs instead of an SREF per grid cell
+    bool biasFromSpecialNets = false; // Main bias grid from the DEF SPECIALNETS
     unsigned int gateHeight = 0;
     float PTLwidth = 0;
     vector<int> fillCor;
@@ -58,13 +74,24 @@ class chipSmith{
     unsigned int gridLY = 0;
 
     map<string, vector<int>> cellSizes;
+    vector<vector<int>> cellSizeOf; // cellSizes indexed by the gate name ID
+
+    const vector<int> *cellSize(const gdsName &gateName) const;
 
+    int importGDS(const string &fileName);
     int importGates();
     int importFill();
     int placeGates();
     int placeNets();
     int placeFill();
+    int fillAroundGates(unsigned int compIndex, const vector<unsigned int> &layers);
+    int fillAroundVias(unsigned int viaIndex, const int viaSize[4]);
+    int fillAroundTracks(unsigned int pathIndex, const vector<unsigned int> &layers, unsigned int forceLayer);
+    int plotFill(unsigned int layer, const string &fillName, gdsSTR &target);
     int placeBias();
+    int placeBiasGrid(const gdsSREFcolumns &comps, gdsSTR &GDSbias);
+    int placeSpecialNets(gdsSTR &GDSbias, spatialIndex &tracks);
+    int indexPlacement();
 
   public:
     chipSmith(){};
@@ -75,6 +102,8 @@ class chipSmith{
                    const string &conFileName);
 
     int toGDS(const string &gdsFileName);
+
+    const spatialIndex &placement() const { return this->placed; };
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,122 @@
+/**
+ * Author:      Jude de Villiers
+ * Origin:      E&E Engineering - Stellenbosch University
+ * For:         Supertools, Coldflux Project - IARPA
+ * Created:     2020-04-21
+ * Modified:
+ * license:
+ * Description: Binary snapshots of parsed input files, kept next to them or
+ *              in a cache directory
+ * File:        dbCache.hpp
+ */
+
+#ifndef dbcache
+#define dbcache
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "gdscpp/gdsReader.hpp"
+
+using namespace std;
+
+#define cacheVersion 3
+
+/**
+ * [cacheKind - What a snapshot holds, a snapshot is only read back as the
+ * same kind]
+ */
+enum cacheKind{ cacheLEF = 1, cacheDEF, cacheGDS };
+
+/**
+ * [cacheKey - Identifies the contents of a source file. The size and the
+ * modification time are checked first, only if they differ is the file
+ * hashed to find out whether it really changed.]
+ */
+struct cacheKey{
+  uint64_t size = 0;
+  int64_t mtime = 0;  // Nano seconds
+  uint64_t hash = 0;
+};
+
+string cacheFileName(const string &sourceName, const string &cacheDir);
+int cacheKeyOf(const string &sourceName, cacheKey &key, bool withHash);
+
+/**
+ * [cacheWriter - Builds a snapshot in memory and writes it out in one go.
+ * Values are stored in the byte order of the machine, the header tells a
+ * machine with another byte order that the snapshot is not for it.]
+ */
+class cacheWriter{
+  private:
+    vector<char> buffer;
+
+  public:
+    cacheWriter(){};
+    ~cacheWriter(){};
+
+    template <typename T> void put(const T &val){
+      static_assert(is_trivially_copyable<T>::value, "Plain values only");
+      const char *bytes = (const char *)&val;
+      this->buffer.insert(this->buffer.end(), bytes, bytes + sizeof(T));
+    };
+    template <typename T> void put(const vector<T> &vec){
+      static_assert(is_trivially_copyable<T>::value, "Plain values only");
+      this->put((uint32_t)vec.size());
+      const char *bytes = (const char *)vec.data();
+      this->buffer.insert(this->buffer.end(), bytes, bytes + vec.size() * sizeof(T));
+    };
+    void put(const string &str);
+    void put(const vector<string> &vec);
+    void append(const cacheWriter &other){
+      this->buffer.insert(this->buffer.end(), other.buffer.begin(), other.buffer.end());
+    };
+
+    int save(const string &sourceName, cacheKind kind, const string &cacheDir);
+};
+
+/**
+ * [cacheReader - Maps a snapshot and reads it front to back. Reading past
+ * the end gives zeros and marks the reader as failed, so a damaged snapshot
+ * is never trusted.]
+ */
+class cacheReader{
+  private:
+    gdsMap file;
+    const char *cur = nullptr;
+    const char *end = nullptr;
+    bool failed = false;
+
+    const char *take(size_t bytes);
+
+  public:
+    cacheReader(){};
+    ~cacheReader(){};
+
+    int open(const string &sourceName, cacheKind kind, const string &cacheDir);
+    void close();
+    bool ok() const { return !this->failed; };
+
+    template <typename T> T get(){
+      static_assert(is_trivially_copyable<T>::value, "Plain values only");
+      T val{};
+      const char *bytes = this->take(sizeof(T));
+      if(bytes != nullptr) memcpy((void *)&val, bytes, sizeof(T));
+      return val;
+    };
+    template <typename T> void get(vector<T> &vec){
+      static_assert(is_trivially_copyable<T>::value, "Plain values only");
+      uint32_t cnt = this->get<uint32_t>();
+      const char *bytes = this->take((size_t)cnt * sizeof(T));
+      vec.resize(bytes != nullptr ? cnt : 0);
+      if(bytes != nullptr && cnt > 0) memcpy((void *)vec.data(), bytes, (size_t)cnt * sizeof(T));
+    };
+    void get(string &str);
+    void get(vector<string> &vec);
+    // Number of elements that follow, 0 once the reader failed
+    uint32_t count();
+};
+
+#endif
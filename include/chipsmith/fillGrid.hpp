@@ -0,0 +1,57 @@
+/**
+ * Author:      Jude de Villiers
+ * Origin:      E&E Engineering - Stellenbosch University
+ * For:         Supertools, Coldflux Project - IARPA
+ * Created:     2020-04-21
+ * Modified:
+ * license:
+ * Description: Bit-packed occupancy grid of a single fill layer
+ * File:        fillGrid.hpp
+ */
+
+#ifndef fillgrid
+#define fillgrid
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+/**
+ * [fillGrid - One bit per grid cell, set where fill may be placed. The grid is
+ * stored row-major with a row per x index, every row starts on a new 64 bit
+ * word and holds the y cells. Bits past the end of a row are always clear.]
+ */
+class fillGrid{
+  private:
+    unsigned int sizeX = 0;
+    unsigned int sizeY = 0;
+    unsigned int wordsPerRow = 0;
+    vector<uint64_t> bits;
+
+    uint64_t *row(unsigned int x){ return bits.data() + (size_t)x * wordsPerRow; };
+    const uint64_t *row(unsigned int x) const { return bits.data() + (size_t)x * wordsPerRow; };
+
+  public:
+    fillGrid(){};
+    ~fillGrid(){};
+
+    void reset(unsigned int lx, unsigned int ly, bool value);
+
+    unsigned int size() const { return sizeX; };
+    unsigned int sizeOfRow() const { return sizeY; };
+
+    bool get(unsigned int x, unsigned int y) const {
+      return (row(x)[y >> 6] >> (y & 63)) & 1;
+    };
+
+    void clearRect(int x0, int y0, int x1, int y1);
+    void clearArea(long long x0, long long y0, long long x1, long long y1, int pitch);
+    int clearSegment(int x0, int y0, int x1, int y1, unsigned int width, bool extendEnds, int pitch);
+    bool allSet(unsigned int x, unsigned int y0, unsigned int y1) const;
+    unsigned int nextSet(unsigned int x, unsigned int y) const;
+    unsigned int nextClear(unsigned int x, unsigned int y) const;
+    size_t count() const;
+};
+
+#endif
@@ -0,0 +1,23 @@
+/**
+ * Author:      Jude de Villiers
+ * Origin:      E&E Engineering - Stellenbosch University
+ * For:         Supertools, Coldflux Project - IARPA
+ * Created:     2020-04-21
+ * Modified:
+ * license:
+ * Description: Binary snapshots of the structure index of GDS cell libraries
+ * File:        gdsCache.hpp
+ */
+
+#ifndef gdscache
+#define gdscache
+
+#include <string>
+#include "chipsmith/dbCache.hpp"
+#include "gdscpp/gdsCpp.hpp"
+
+using namespace std;
+
+int importCachedGDS(gdscpp &target, const string &fileName, bool compact, const string &cacheDir);
+
+#endif
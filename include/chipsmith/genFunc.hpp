@@ -17,6 +17,8 @@
 #include <iomanip>
 #include <vector>
 #include <fstream>
+#include <string_view>
+#include "gdscpp/gdsReader.hpp"
 
 using namespace std;
 
@@ -38,5 +40,45 @@ string removeLTwhite(string inStr);
 string fileRenamer(string inName, string preFix, string suffix);
 string fileExtensionRenamer(string inName, string suffix);
 string makeHeader(string HeaderName);
+int svToInt(string_view inStr);
+double svToDouble(string_view inStr);
+
+/**
+ * [fileTokenizer - Splits a text file into whitespace separated tokens, a line
+ * at a time. The file is memory mapped and the tokens point straight into it,
+ * they stay valid until the tokenizer is closed. Empty lines and lines starting
+ * with '#' are skipped, as splitFileLine does. A piece of text that is already
+ * in memory, such as a statement found in rest(), can be split the same way.]
+ */
+class fileTokenizer{
+	private:
+		gdsMap file;
+		const char *cur = nullptr;
+		const char *end = nullptr;
+		vector<string_view> tokens;
+
+	public:
+		fileTokenizer(){};
+		~fileTokenizer(){};
+
+		int open(const string &fileName);
+		int open(string_view text);
+		void close();
+		bool nextLine();
+
+		// Unread part of the file, seek() continues from a position inside it
+		string_view rest() const { return string_view(this->cur, this->end - this->cur); };
+		void seek(const char *pos){ this->cur = pos; };
+
+		const vector<string_view> &line() const { return this->tokens; };
+		size_t size() const { return this->tokens.size(); };
+		// Tokens past the end of the line are empty
+		string_view operator[](size_t i) const {
+			return i < this->tokens.size() ? this->tokens[i] : string_view();
+		};
+		string_view back() const {
+			return this->tokens.empty() ? string_view() : this->tokens.back();
+		};
+};
 
 #endif
\ No newline at end of file
@@ -0,0 +1,72 @@
+/**
+ * Author:      Jude de Villiers
+ * Origin:      E&E Engineering - Stellenbosch University
+ * For:         Supertools, Coldflux Project - IARPA
+ * Created:     2020-04-21
+ * Modified:
+ * license:
+ * Description: Uniform bin grid over the bounding boxes of placed geometry
+ * File:        spatialIndex.hpp
+ */
+
+#ifndef spatialindex
+#define spatialindex
+
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+/**
+ * [spatialItem - Bounding box of a placed element and where it came from]
+ */
+struct spatialItem{
+  int box[4];         // x_0, y_0, x_1, y_1, edges included
+  unsigned int kind;  // spatialIndex::itemKind
+  unsigned int index; // Element in its structure (SREF column or PATH arena)
+};
+
+/**
+ * [spatialIndex - Bulk loaded bin grid for box and point queries. Items are
+ * inserted, then build() sorts them into square bins in one pass (counting
+ * sort, the bins are stored back to back). An item is listed in every bin it
+ * overlaps, a query reports it only from the bin that holds the lower left
+ * corner of the overlap, so results have no duplicates and queries need no
+ * scratch state and may run on several threads at once.]
+ */
+class spatialIndex{
+  private:
+    vector<spatialItem> items;
+    vector<unsigned int> binStart; // Items of bin b: binItems[binStart[b], binStart[b + 1])
+    vector<unsigned int> binItems;
+    long long originX = 0;
+    long long originY = 0;
+    long long binSize = 1;
+    unsigned int binsX = 0;
+    unsigned int binsY = 0;
+
+    unsigned int binX(long long x) const;
+    unsigned int binY(long long y) const;
+
+  public:
+    enum itemKind{ gate = 0, net, via, bias };
+
+    spatialIndex(){};
+    ~spatialIndex(){};
+
+    void clear();
+    void reserve(size_t itemCnt){ this->items.reserve(itemCnt); };
+    void insert(int x0, int y0, int x1, int y1, unsigned int kind, unsigned int index);
+    void build(unsigned int itemsPerBin = 4);
+
+    size_t size() const { return this->items.size(); };
+    bool built() const { return !this->binStart.empty(); };
+    const spatialItem &item(unsigned int i) const { return this->items[i]; };
+
+    size_t queryBox(int x0, int y0, int x1, int y1, vector<unsigned int> &found) const;
+    size_t queryPoint(int x, int y, vector<unsigned int> &found) const {
+      return this->queryBox(x, y, x, y, found);
+    };
+};
+
+#endif
@@ -15,6 +15,10 @@
 // ==================== Class declarations =====================
 class gdscpp;      // All encompassing master class
 class gdsSTR;      // Subclass containing all structures
+class gdsSREFcolumns; // Compact SREF storage belonging to gdsSTR
+class gdsPointArena;  // Compact BOUNDARY/PATH storage belonging to gdsSTR
+class gdsOwner;       // Structure of a library an element container is in
+template <class T> class gdsElements; // Watched element vector of gdsSTR
 class gdsBOUNDARY; // x2subclass belonging to gdsSTR
 class gdsPATH;     // ''
 class gdsSREF;     // ''
@@ -24,23 +28,32 @@ class gdsNODE;     // ''
 class gdsBOX;      // ''
 
 // ========================== Includes ========================
+#include "gdscpp/gdsFlatten.hpp"
 #include "gdscpp/gdsForge.hpp"
+#include "gdscpp/gdsName.hpp"
 #include "gdscpp/gdsParser.hpp"
+#include "gdscpp/gdsReader.hpp"
+#include "gdscpp/gdsRefGraph.hpp"
+#include "gdscpp/gdsVisitor.hpp"
 #include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <sstream>
 #include <stdio.h>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 // ================== Function Declarations ===================
 
 int gdsToText(const std::string &fileName);
-int gdsRecordToText(char *recIn);
+int gdsRecordToText(const char *recIn);
 
 // ================= Structure Declarations ===================
 
@@ -53,6 +66,9 @@ int gdsRecordToText(char *recIn);
 class gdscpp
 { // (GDS file)
 private:
+  friend class gdsImportVisitor; // Fills the library from decoded records
+  friend class gdsOwner;         // Reports elements added to a structure
+
   int version_number = 7;             // GDS version number. Default to 7
   int generations = 3;                // Default generations. Don't really use
   int highest_heirarchical_level = 0; // Zero_indexed
@@ -62,12 +78,32 @@ private:
       STR_Lookup;                 // Allows for searching by name
   std::vector<int> last_modified; // TODO: Default to current datetime
   std::string library_name = "Untitled_library"; // Default libname
+  bool compact_geometry = false; // Imported BOUNDARY and PATH go in arenas
 
   std::vector<std::string> GDSfileName;
 
+  gdsRefGraph STR_graph; // References between the structures in STR
+  std::vector<bool> STR_indexed; // References of STR[i] are in STR_graph
+  void index_STR_references(unsigned int index);
+  void sync_STR_nodes();
+  void own_STR(unsigned int first);
+  void STR_changed(unsigned int index, const gdsName *reference);
+
+  // Cache state of STR[i].bounding_box
+  struct bboxState {
+    bool valid = false;
+    bool busy = false; // Being calculated, guards circular references
+  };
+  std::vector<bboxState> STR_bbox;
+  int compute_STR_bounding_box(int structure_index, int *destination);
+  const int *reference_bounding_box(int structure_index);
+
 public:
   gdscpp(){};
   ~gdscpp(){};
+  // The structures point back at the library, see gdsOwner
+  gdscpp(const gdscpp &) = delete;
+  gdscpp &operator=(const gdscpp &) = delete;
 
   std::vector<gdsSTR> STR; // Holds all the structures of the gds file
 
@@ -80,6 +116,7 @@ public:
   void getSTR(std::vector<gdsSTR> &exVec,
               std::unordered_map<std::string, int> &exMap)
   {
+    load_all_STR();
     exVec = STR;
     exMap = STR_Lookup;
   };
@@ -87,16 +124,26 @@ public:
   {
     return highest_heirarchical_level;
   };
+  void set_compact_geometry(bool enable) { compact_geometry = enable; };
   int import(std::string fileName);
-  bool check_name(std::string name, std::vector<std::string> ref_vector);
+  int import_parallel(std::string fileName, unsigned int threads = 0);
+  int import_lazy(std::string fileName);
+  int load_STR(unsigned int index);
+  int load_all_STR();
+  bool check_name(const std::string &name,
+                  const std::vector<std::string> &ref_vector);
 
   int resolve_heirarchy_and_bounding_boxes();
   int calculate_STR_bounding_box(int structure_index, int *destination);
+  int restore_bounding_box(int structure_index, const int *b_box);
+  int restore_bounding_box(int structure_index, const int *b_box,
+                           const std::vector<gdsName> &references);
+  void invalidate_bounding_box(unsigned int structure_index);
   int fetch_boundary_bounding_box(gdsBOUNDARY target_boundary,
                                   int *destination);
   int fetch_box_bounding_box(gdsBOX target_box, int *destination);
 
-  int write(const std::string &fileName);
+  int write(const std::string &fileName, unsigned int threads = 1);
   double get_database_units();
   double get_database_units_in_m();
   void to_str();
@@ -107,10 +154,265 @@ public:
     this->GDSfileName.push_back(fileName);
   }
 
+  int STR_index(const gdsName &name);
+  const gdsRefGraph &reference_graph();
+  void rebuild_reference_graph();
   std::vector<unsigned int> findRootSTR();
+  int flatten(unsigned int root, gdsFlatSink &sink, unsigned int threads = 1);
+  int flatten(unsigned int root, gdsSTR &dest, unsigned int threads = 1);
   int genDot(const std::string &fileName);
 };
 
+/*
+ * [gdsOwner - The library and index of the structure an element container
+ * belongs to. Adding elements through the container marks the cached
+ * bounding box of that structure, and of every structure above it, as out of
+ * date. A copy belongs to no structure, a moved container keeps its owner and
+ * an assigned one keeps the owner it had. Elements of a gdsSTR in a library
+ * that are changed in place need gdscpp::invalidate_bounding_box.]
+ */
+class gdsOwner
+{
+private:
+  gdscpp *library = nullptr;
+  unsigned int index = 0;
+
+public:
+  gdsOwner(){};
+  ~gdsOwner(){};
+  gdsOwner(const gdsOwner &){};
+  gdsOwner(gdsOwner &&foo) noexcept : library(foo.library), index(foo.index){};
+  gdsOwner &operator=(const gdsOwner &) { return *this; };
+  gdsOwner &operator=(gdsOwner &&) noexcept { return *this; };
+
+  void set(gdscpp *lib, unsigned int structure_index)
+  {
+    library = lib;
+    index = structure_index;
+  };
+  gdscpp *lib() const { return library; };
+  unsigned int structure() const { return index; };
+  void changed(const gdsName *reference = nullptr) const;
+};
+
+// Name of the structure an element references, nullptr for the other elements
+const gdsName *gdsElementReference(const gdsSREF &element);
+const gdsName *gdsElementReference(const gdsAREF &element);
+template <class T> const gdsName *gdsElementReference(const T &)
+{
+  return nullptr;
+}
+
+/*
+ * [gdsElements - Vector of the BOUNDARY, PATH, SREF, AREF or BOX elements of a
+ * gdsSTR. Adding, removing or assigning elements goes through its owner, like
+ * the arenas do, so cached bounding boxes follow. Reading it is a plain
+ * std::vector.]
+ */
+template <class T> class gdsElements : public std::vector<T>
+{
+private:
+  typedef std::vector<T> base;
+  // Elements from first on are new
+  void added(size_t first) const
+  {
+    for (size_t i = first; i < this->size(); i++)
+      owner.changed(gdsElementReference((*this)[i]));
+  };
+
+public:
+  gdsOwner owner;
+
+  gdsElements(){};
+  ~gdsElements(){};
+  gdsElements(const gdsElements &) = default;
+  gdsElements(gdsElements &&) = default;
+  gdsElements &operator=(const gdsElements &foo)
+  {
+    base::operator=(foo);
+    owner.changed();
+    added(0);
+    return *this;
+  };
+  gdsElements &operator=(gdsElements &&foo)
+  {
+    base::operator=(std::move(foo));
+    owner.changed();
+    added(0);
+    return *this;
+  };
+
+  void push_back(const T &element)
+  {
+    base::push_back(element);
+    added(this->size() - 1);
+  };
+  void push_back(T &&element)
+  {
+    base::push_back(std::move(element));
+    added(this->size() - 1);
+  };
+  template <class... Args> T &emplace_back(Args &&...args)
+  {
+    base::emplace_back(std::forward<Args>(args)...);
+    added(this->size() - 1);
+    return this->back();
+  };
+  typename base::iterator insert(typename base::const_iterator pos,
+                                 const T &element)
+  {
+    auto it = base::insert(pos, element);
+    owner.changed(gdsElementReference(*it));
+    return it;
+  };
+  template <class InputIt>
+  typename base::iterator insert(typename base::const_iterator pos,
+                                 InputIt first, InputIt last)
+  {
+    size_t at = pos - this->cbegin(), cnt = this->size();
+    auto it = base::insert(pos, first, last);
+    for (size_t i = at; i < at + this->size() - cnt; i++)
+      owner.changed(gdsElementReference((*this)[i]));
+    return it;
+  };
+  typename base::iterator erase(typename base::const_iterator pos)
+  {
+    auto it = base::erase(pos);
+    owner.changed();
+    return it;
+  };
+  typename base::iterator erase(typename base::const_iterator first,
+                                typename base::const_iterator last)
+  {
+    auto it = base::erase(first, last);
+    owner.changed();
+    return it;
+  };
+  void resize(size_t count)
+  {
+    size_t cnt = this->size();
+    base::resize(count);
+    owner.changed();
+    added(cnt);
+  };
+  void clear()
+  {
+    base::clear();
+    owner.changed();
+  };
+};
+
+/*
+ * [gdsSREFcolumns - Plain structure references of a gdsSTR stored column by
+ * column: name ID, x, y and a packed transform, 13 bytes a reference. Only
+ * references with a scale of 1, a multiple of 90 degrees rotation and no
+ * properties fit, the rest stay in gdsSTR::SREF. A reference is expanded to a
+ * gdsSREF only when asked.]
+ */
+class gdsSREFcolumns
+{
+private:
+public:
+  gdsSREFcolumns(){};
+  ~gdsSREFcolumns(){};
+  gdsSREFcolumns(const gdsSREFcolumns &) = default;
+  gdsSREFcolumns(gdsSREFcolumns &&) = default;
+  gdsSREFcolumns &operator=(const gdsSREFcolumns &) = default;
+  gdsSREFcolumns &operator=(gdsSREFcolumns &&) = default;
+
+  std::vector<gdsName> name;
+  std::vector<int> xCor;
+  std::vector<int> yCor;
+  std::vector<uint8_t> transform; // bits 0-1: quarter turns, bit 2: reflection
+  gdsOwner owner;
+
+  size_t size() const { return name.size(); };
+  bool empty() const { return name.empty(); };
+  void clear();
+  void reserve(size_t count);
+
+  void push_back(const gdsName &STRname, int Xcor, int Ycor,
+                 unsigned int quarterTurns = 0, bool mirror = false);
+  bool push_back(const gdsSREF &target_ref);
+  static bool fits(const gdsSREF &target_ref);
+
+  unsigned int quarter_turns(size_t index) const
+  {
+    return transform[index] & 3;
+  };
+  bool reflection(size_t index) const { return transform[index] & 4; };
+  gdsSREF expand(size_t index) const;
+};
+
+/*
+ * [gdsPointArena - BOUNDARY or PATH elements of a gdsSTR with the points of
+ * all of them in one buffer of interleaved x, y pairs. Every element is a span
+ * of that buffer plus its attributes, so adding one does not allocate. PLEX and
+ * property values are seldom used and are kept aside for the few elements
+ * that have them.]
+ */
+class gdsPointArena
+{
+private:
+  struct extraAttr {
+    size_t element = 0;
+    int plex = 0;
+    unsigned int propattr = 0;
+    std::string propvalue;
+  };
+  std::vector<extraAttr> extra; // Sorted by element
+  const extraAttr *find_extra(size_t index) const;
+  void push_back_extra(int plex, unsigned int propattr,
+                       const std::string &propvalue);
+
+public:
+  gdsPointArena(){};
+  ~gdsPointArena(){};
+  gdsPointArena(const gdsPointArena &) = default;
+  gdsPointArena(gdsPointArena &&) = default;
+  gdsPointArena &operator=(const gdsPointArena &) = default;
+  gdsPointArena &operator=(gdsPointArena &&) = default;
+
+  std::vector<int> points; // x_0, y_0, x_1, y_1, ...
+  std::vector<size_t> end; // Element i ends at points[end[i]]
+  std::vector<uint16_t> layer;
+  std::vector<uint16_t> dataType;
+  std::vector<uint16_t> pathtype;  // 0 for boundaries
+  std::vector<unsigned int> width; // 0 for boundaries
+  gdsOwner owner;
+
+  size_t size() const { return layer.size(); };
+  bool empty() const { return layer.empty(); };
+  void clear();
+  void reserve(size_t elements, size_t point_count);
+
+  size_t begin(size_t index) const { return index ? end[index - 1] : 0; };
+  size_t point_count(size_t index) const
+  {
+    return (end[index] - begin(index)) / 2;
+  };
+  const int *xy(size_t index) const { return points.data() + begin(index); };
+  int plex(size_t index) const;
+  unsigned int propattr(size_t index) const;
+  const std::string &propvalue(size_t index) const;
+
+  void push_back(unsigned int layerNum, unsigned int type,
+                 unsigned int path_type, unsigned int path_width,
+                 const std::vector<int> &xCor, const std::vector<int> &yCor);
+  void push_back(unsigned int layerNum, unsigned int type,
+                 unsigned int path_type, unsigned int path_width,
+                 const int *corXY, size_t cnt);
+  void push_back(const gdsBOUNDARY &target_boundary);
+  void push_back(const gdsPATH &target_path);
+  void push_back_tail(unsigned int layerNum, unsigned int type,
+                      unsigned int path_type, unsigned int path_width,
+                      int plex = 0, unsigned int propattr = 0,
+                      const std::string &propvalue = "\0");
+  void drop_tail() { points.resize(begin(size())); };
+  gdsBOUNDARY boundary(size_t index) const;
+  gdsPATH path(size_t index) const;
+};
+
 /*
  * [gdsSTR - Subclass of gdscpp which holds a structure's information.]
  */
@@ -120,12 +422,25 @@ private:
 public:
   gdsSTR(){};
   ~gdsSTR(){};
+  gdsSTR(const gdsSTR &) = default;
+  gdsSTR(gdsSTR &&) = default;
+  gdsSTR &operator=(const gdsSTR &) = default;
+  gdsSTR &operator=(gdsSTR &&) = default;
 
   void to_str();
   void reset();
+  int load();
+  bool is_loaded() const { return lazy_source == nullptr; };
+  void set_owner(gdscpp *lib, unsigned int index);
 
   std::string name = "\0";
 
+  // Set by gdscpp::import_lazy, the elements are still in the mapped file
+  std::shared_ptr<const gdsMap> lazy_source;
+  size_t lazy_offset = 0; // Offset of the BGNSTR record in lazy_source
+  // Decode BOUNDARYs and PATHs into the arenas, kept by reset()
+  bool compact_geometry = false;
+
   unsigned int heirarchical_level = 0;
   int bounding_box[4] = {
       0, 0, 0, 0}; // x1,y1,x2,y2 (minimum number of points to represent box)
@@ -139,13 +454,16 @@ public:
   };
 
   std::vector<int> last_modified;
-  std::vector<gdsBOUNDARY> BOUNDARY;
-  std::vector<gdsPATH> PATH;
-  std::vector<gdsSREF> SREF;
-  std::vector<gdsAREF> AREF;
+  gdsElements<gdsBOUNDARY> BOUNDARY;
+  gdsPointArena BOUNDARYarena; // Compact BOUNDARYs, written after BOUNDARY
+  gdsElements<gdsPATH> PATH;
+  gdsPointArena PATHarena; // Compact PATHs, written after PATH
+  gdsElements<gdsSREF> SREF;
+  gdsSREFcolumns SREFcols; // Compact SREFs, written after SREF
+  gdsElements<gdsAREF> AREF;
   std::vector<gdsTEXT> TEXT;
   std::vector<gdsNODE> NODE;
-  std::vector<gdsBOX> BOX;
+  gdsElements<gdsBOX> BOX;
 };
 
 /*
@@ -213,9 +531,10 @@ public:
 
   void to_str();
   void reset();
+  void classify();
 
   int plex = 0;
-  std::string name = "\0";
+  gdsName name; // Interned, see gdsName.hpp
   std::bitset<16> sref_flags;
   bool reflection = false; // boolean,    flag at bit 0
   double scale = 1;        // multiplier, flag at bit 13
@@ -224,6 +543,10 @@ public:
   int yCor = 0;
   unsigned int propattr = 0;
   std::string propvalue = "\0";
+  // Manhattan orientation, bits 0-1 quarter turns and bit 2 reflection as in
+  // gdsSREFcolumns; -1 if unclassified, scaled or not a multiple of 90
+  // degrees. Set by classify(), call it again after changing the placement.
+  int orientation = -1;
 };
 
 /*
@@ -241,7 +564,7 @@ public:
   void reset();
 
   int plex = 0;
-  std::string name = "\0"; // SNAME
+  gdsName name; // SNAME, interned
   std::bitset<16> aref_transformation_flags;
   bool reflection = false; // STRANS
   double angle = 0;        // subSTRANS
@@ -0,0 +1,94 @@
+/**
+ * Author:      J.F. de Villiers & H.F. Herbst
+ * Origin:  		E&E Engineering - Stellenbosch University
+ * For:					Supertools, Coldflux Project - IARPA
+ * Created: 		2019-10-14
+ * Modified:
+ * license:     MIT License
+ * Description: Flattens a structure hierarchy into polygons on the top level.
+ * File:				gdsFlatten.hpp
+ */
+
+#ifndef GDSFlatten
+#define GDSFlatten
+
+// ========================== Includes ========================
+#include <cstddef>
+#include <vector>
+
+class gdscpp;
+class gdsSTR;
+
+// ===================== Class Definitions ====================
+
+/*
+ * [gdsTransform - Placement of a referenced structure in its parent:
+ * x' = xx*x + xy*y + dx and y' = yx*x + yy*y + dy. GDS reflects about the
+ * x-axis first, then magnifies, rotates and translates. As long as the angles
+ * are multiples of 90 degrees and the scales are whole numbers the matrix
+ * stays integral and points are transformed exactly with integer math.]
+ */
+class gdsTransform
+{
+private:
+  double m[6] = {1, 0, 0, 1, 0, 0}; // xx, xy, yx, yy, dx, dy
+  long long im[6] = {1, 0, 0, 1, 0, 0};
+  bool is_integral = true;
+  void update();
+
+public:
+  gdsTransform(){};
+  gdsTransform(int x, int y, double angle = 0, double scale = 1,
+               bool reflection = false);
+  static gdsTransform manhattan(int x, int y, unsigned int orientation);
+
+  gdsTransform operator*(const gdsTransform &inner) const;
+  void apply(const int *inXY, int *outXY, size_t cnt) const;
+  double magnification() const;
+  bool integral() const { return is_integral; };
+};
+
+/*
+ * [gdsFlatSink - Receives the flattened polygons of gdscpp::flatten.
+ * Coordinates are interleaved (x0, y0, x1, y1, ...) and only valid for the
+ * duration of the call. Layers for which wants_layer returns false are
+ * skipped before they are transformed. The callbacks are always made from
+ * the thread that called gdscpp::flatten.]
+ */
+class gdsFlatSink
+{
+public:
+  gdsFlatSink(){};
+  virtual ~gdsFlatSink(){};
+
+  virtual bool wants_layer(unsigned int /*layer*/) { return true; };
+  virtual void onBoundary(unsigned int /*layer*/, unsigned int /*dataType*/,
+                          const int * /*corXY*/, size_t /*cnt*/){};
+  virtual void onPath(unsigned int /*layer*/, unsigned int /*dataType*/,
+                      unsigned int /*pathtype*/, unsigned int /*width*/,
+                      const int * /*corXY*/, size_t /*cnt*/){};
+};
+
+/*
+ * [gdsFlatSTR - Collects the flattened polygons in the arenas of a structure,
+ * optionally only those on the given layers.]
+ */
+class gdsFlatSTR : public gdsFlatSink
+{
+private:
+  gdsSTR &dest;
+  std::vector<bool> layer_mask; // Empty - every layer
+
+public:
+  gdsFlatSTR(gdsSTR &target) : dest(target){};
+  gdsFlatSTR(gdsSTR &target, const std::vector<unsigned int> &layers);
+
+  bool wants_layer(unsigned int layer) override;
+  void onBoundary(unsigned int layer, unsigned int dataType,
+                  const int *corXY, size_t cnt) override;
+  void onPath(unsigned int layer, unsigned int dataType,
+              unsigned int pathtype, unsigned int width, const int *corXY,
+              size_t cnt) override;
+};
+
+#endif
@@ -15,15 +15,20 @@
 // ============================ Includes ============================
 #include "gdscpp/gdsCpp.hpp"
 #include "gdscpp/gdsParser.hpp"
+#include "gdscpp/gdsWriter.hpp"
 #include <bitset>
+#include <atomic>
 #include <cmath>
+#include <condition_variable>
 #include <cstring>
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <set>
 #include <stdio.h>
 #include <string>
+#include <thread>
 #include <vector>
 
 // ===================== Function Declarations ======================
@@ -34,6 +39,13 @@ gdsBOUNDARY drawBoundary(int layer, std::vector<int> &corX,
                          std::vector<int> &corY);
 gdsPATH drawPath(int layer, unsigned int width, std::vector<int> &corX,
                  std::vector<int> &corY);
+// Straight into the arena of a structure, no element is built in between
+void draw2ptBox(gdsPointArena &dest, int layer, int blX, int blY, int trX,
+                int trY);
+void drawBoundary(gdsPointArena &dest, int layer,
+                  const std::vector<int> &corX, const std::vector<int> &corY);
+void drawPath(gdsPointArena &dest, int layer, unsigned int width,
+              const std::vector<int> &corX, const std::vector<int> &corY);
 gdsSREF drawSREF(const std::string &STRname, int Xcor, int Ycor);
 gdsSREF drawSREF(const std::string &STRname, int Xcor, int Ycor, double angle,
                  double mag, bool mirror);
@@ -47,11 +59,10 @@ class gdsForge
 {
 private:
   std::string fileName;
-  FILE *gdsFile;
-
-  std::vector<gdsSTR> STR;
+  gdsWriter gdsOut;
 
   std::vector<std::string> GDSfileNameToBeImport;
+  std::set<std::string> copiedSTR; // Structures copied into this output file
 
   // Surface level
 
@@ -60,11 +71,17 @@ private:
   void gdsEnd();
   void gdsStrStart(const std::string &strName);
   void gdsStrEnd();
+  void gdsStructure(const gdsSTR &gds_str, size_t from, size_t to,
+                    bool minimal);
+  void gdsStructuresParallel(const std::vector<gdsSTR> &inVec, bool minimal,
+                             unsigned int threads);
 
   int gdsCopyFile(const std::string &fileName);
 
   void gdsPath(const gdsPATH &in_PATH, bool minimal);
+  void gdsPath(const gdsPointArena &in_arena, size_t index, bool minimal);
   void gdsBoundary(const gdsBOUNDARY &in_BOUNDARY, bool minimal);
+  void gdsBoundary(const gdsPointArena &in_arena, size_t index, bool minimal);
   void gdsSRef(const gdsSREF &in_SREF, bool minimal);
   void gdsARef(const gdsAREF &in_AREF, bool minimal);
   void gdsNode(const gdsNODE &in_NODE, bool minimal);
@@ -74,17 +91,20 @@ private:
   // Lower level
   int GDSwriteRec(int record);
   int GDSwriteInt(int record, int arrInt[], int cnt);
-  int GDSwriteStr(int record, std::string inStr);
+  int GDSwriteXY(const std::vector<int> &xCor, const std::vector<int> &yCor);
+  int GDSwriteXY(const int *corXY, size_t cnt);
+  int GDSwriteStr(int record, const std::string &inStr);
   int GDSwriteBitArr(int record, std::bitset<16> inBits);
   int GDSwriteRea(int record, double arrInt[], int cnt);
   void GDSwriteUnits(); // <--- must be removed...
 
 public:
   gdsForge();
+  gdsForge(size_t capacity);
   ~gdsForge() {}
 
   int gdsCreate(const std::string &FileName, std::vector<gdsSTR> &inVec,
-                double units[2]);
+                double units[2], unsigned int threads = 1);
 
   void importGDSfile(std::vector<std::string> &fileNames)
   {
@@ -0,0 +1,65 @@
+/**
+ * Author:      J.F. de Villiers & H.F. Herbst
+ * Origin:  		E&E Engineering - Stellenbosch University
+ * For:					Supertools, Coldflux Project - IARPA
+ * Created: 		2019-08-26
+ * Modified:
+ * license:     MIT License
+ * Description: Interned structure names, each distinct name is stored once
+ *              and referred to by a small integer ID.
+ * File:				gdsName.hpp
+ */
+
+#ifndef GDSName
+#define GDSName
+
+// ========================== Includes ========================
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// ================== Function Declarations ===================
+
+// The table is shared by all gdscpp objects and is safe to use from several
+// threads. ID 0 is always the empty name.
+uint32_t gdsIntern(const std::string &name);
+const std::string &gdsNameOf(uint32_t nameID);
+uint32_t gdsNameCount();
+
+// ===================== Class Definitions ====================
+
+/*
+ * [gdsName - A structure name held as its ID in the interning table. Reads
+ * like a const std::string, comparing two names compares the IDs.]
+ */
+class gdsName
+{
+private:
+  uint32_t nameID = 0;
+
+public:
+  gdsName(){};
+  gdsName(const std::string &name) : nameID(gdsIntern(name)){};
+  gdsName(const char *name) : nameID(gdsIntern(name)){};
+
+  uint32_t id() const { return nameID; };
+  const std::string &str() const { return gdsNameOf(nameID); };
+  operator const std::string &() const { return gdsNameOf(nameID); };
+
+  const char *c_str() const { return str().c_str(); };
+  size_t size() const { return str().size(); };
+  bool empty() const { return nameID == 0; };
+  int compare(const std::string &name) const { return str().compare(name); };
+
+  bool operator==(const gdsName &rhs) const { return nameID == rhs.nameID; };
+  bool operator!=(const gdsName &rhs) const { return nameID != rhs.nameID; };
+  bool operator==(const std::string &rhs) const { return str() == rhs; };
+  bool operator!=(const std::string &rhs) const { return str() != rhs; };
+};
+
+inline std::ostream &operator<<(std::ostream &out, const gdsName &name)
+{
+  return out << name.str();
+}
+
+#endif
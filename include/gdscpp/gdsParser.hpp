@@ -23,7 +23,7 @@
 #include <string>
 #include <vector>
 
-int GDSdistill(char *recIn, uint32_t &GDSKey, std::bitset<16> &bitarr,
+int GDSdistill(const char *recIn, uint32_t &GDSKey, std::bitset<16> &bitarr,
                std::vector<int> &integer, std::vector<double> &B8Real,
                std::string &words);
 
@@ -32,8 +32,8 @@ uint64_t bitShiftR(uint64_t inVar,
                    int cnt); // ultra low level - should be removed
 uint64_t bitShiftL(uint64_t inVar,
                    int cnt); // ultra low level - should be removed
-int conBytes(char inArry[], int start, int cnt); // ultra low level
-uint64_t conBytesLL(char inArry[], int start,
+int conBytes(const char inArry[], int start, int cnt); // ultra low level
+uint64_t conBytesLL(const char inArry[], int start,
                     int cnt); // ultra low level
 
 int *gsdTime();
@@ -0,0 +1,89 @@
+/**
+ * Author:      J.F. de Villiers & H.F. Herbst
+ * Origin:  		E&E Engineering - Stellenbosch University
+ * For:					Supertools, Coldflux Project - IARPA
+ * Created: 		2019-08-26
+ * Modified:
+ * license:     MIT License
+ * Description: Memory mapped GDS file access and an in place record cursor.
+ * File:				gdsReader.hpp
+ */
+
+#ifndef GDSReader
+#define GDSReader
+
+// ========================== Includes ========================
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+// ================== Function Declarations ===================
+
+/*
+ * [gdsRecSize - Size in bytes of the record starting at recIn, header
+ * included]
+ */
+inline uint32_t gdsRecSize(const char *recIn)
+{
+  return ((unsigned char)recIn[0] << 8) | (unsigned char)recIn[1];
+}
+
+/*
+ * [gdsRecKey - The GDS key (record type and data type) of the record]
+ */
+inline uint32_t gdsRecKey(const char *recIn)
+{
+  return ((unsigned char)recIn[2] << 8) | (unsigned char)recIn[3];
+}
+
+// ===================== Class Definitions ====================
+
+/*
+ * [gdsMap - Read-only memory map of a complete GDS file. The mapping lives
+ * until close() or destruction, records may be pointed into directly.]
+ */
+class gdsMap
+{
+private:
+  const char *data = nullptr;
+  size_t dataSize = 0;
+
+public:
+  gdsMap(){};
+  ~gdsMap() { close(); };
+  gdsMap(const gdsMap &) = delete;
+  gdsMap &operator=(const gdsMap &) = delete;
+
+  int open(const std::string &fileName);
+  void close();
+
+  const char *begin() const { return data; };
+  size_t size() const { return dataSize; };
+};
+
+/*
+ * [gdsReader - Cursor which walks the records of a GDS byte range in place.
+ * It does not own the memory, several cursors may share one gdsMap.]
+ */
+class gdsReader
+{
+private:
+  const char *start = nullptr;
+  const char *cur = nullptr;
+  const char *end = nullptr;
+
+public:
+  gdsReader(const char *buffer, size_t length)
+      : start(buffer), cur(buffer), end(buffer + length){};
+  ~gdsReader(){};
+
+  const char *next();
+  const char *peek() const;
+
+  bool eof() const { return cur >= end; };
+  size_t tell() const { return cur - start; };
+  void seek(size_t offset) { cur = start + offset; };
+};
+
+#endif
@@ -0,0 +1,80 @@
+/**
+ * Author:      J.F. de Villiers & H.F. Herbst
+ * Origin:  		E&E Engineering - Stellenbosch University
+ * For:					Supertools, Coldflux Project - IARPA
+ * Created: 		2019-08-26
+ * Modified:
+ * license:     MIT License
+ * Description: Index of the references between the structures of a library.
+ * File:				gdsRefGraph.hpp
+ */
+
+#ifndef GDSRefGraph
+#define GDSRefGraph
+
+// ========================== Includes ========================
+#include "gdscpp/gdsName.hpp"
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// ===================== Class Definitions ====================
+
+/*
+ * [gdsRefGraph - Directed graph of the structure references (SREF and AREF)
+ * of a library. Nodes have the same index as the structure in gdscpp::STR and
+ * are found by name ID with a plain array index. References to names that are
+ * not in the graph yet are kept aside and connected as soon as a node with
+ * that name is added.]
+ */
+class gdsRefGraph
+{
+private:
+  std::vector<unsigned int> node_of_name; // Indexed by name ID
+  std::vector<std::vector<unsigned int>> child_list;
+  std::vector<std::vector<unsigned int>> parent_list;
+  std::vector<unsigned int> reference_count;
+  // Parents (and their number of references) waiting on a structure that
+  // does not exist yet
+  std::unordered_map<uint32_t,
+                     std::vector<std::pair<unsigned int, unsigned int>>>
+      unresolved;
+
+public:
+  static constexpr unsigned int no_node = ~0u;
+
+  gdsRefGraph(){};
+  ~gdsRefGraph(){};
+
+  void clear();
+  unsigned int add_node(const gdsName &name);
+  void add_reference(unsigned int parent, const gdsName &child_name);
+  void add_late_reference(unsigned int parent, const gdsName &child_name);
+
+  size_t size() const { return child_list.size(); };
+  // Node of the structure name, no_node if it is not in the graph
+  unsigned int find(const gdsName &name) const
+  {
+    return name.id() < node_of_name.size() ? node_of_name[name.id()] : no_node;
+  };
+  // Distinct structures referenced by node
+  const std::vector<unsigned int> &children(unsigned int node) const
+  {
+    return child_list[node];
+  };
+  // Distinct structures referencing node
+  const std::vector<unsigned int> &parents(unsigned int node) const
+  {
+    return parent_list[node];
+  };
+  // Number of SREF and AREF records pointing at node
+  unsigned int references(unsigned int node) const
+  {
+    return reference_count[node];
+  };
+  std::vector<unsigned int> roots() const;
+  std::vector<std::string> unresolved_names() const;
+};
+
+#endif
@@ -0,0 +1,77 @@
+/**
+ * Author:      J.F. de Villiers & H.F. Herbst
+ * Origin:  		E&E Engineering - Stellenbosch University
+ * For:					Supertools, Coldflux Project - IARPA
+ * Created: 		2019-10-14
+ * Modified:
+ * license:     MIT License
+ * Description: Streaming (callback) interface to the GDS record decoder.
+ * File:				gdsVisitor.hpp
+ */
+
+#ifndef GDSVisitor
+#define GDSVisitor
+
+// ========================== Includes ========================
+#include "gdscpp/gdsReader.hpp"
+#include <string>
+#include <vector>
+
+class gdsBOUNDARY;
+class gdsPATH;
+class gdsSREF;
+class gdsAREF;
+class gdsTEXT;
+class gdsNODE;
+class gdsBOX;
+class gdsPointArena;
+
+// ===================== Class Definitions ====================
+
+/*
+ * [gdsVisitor - Receives the contents of a GDS file as it is decoded.
+ * Override only the events that are needed, the rest are ignored.
+ * The element objects handed to the callbacks are reused by the decoder and
+ * are only valid for the duration of the call, copy what must be kept.
+ * A visitor that keeps its boundaries or paths in a gdsPointArena can return
+ * it from boundaryArena or pathArena, those elements are then decoded straight
+ * into it and onBoundary or onPath is not called for them.]
+ */
+class gdsVisitor
+{
+public:
+  gdsVisitor(){};
+  virtual ~gdsVisitor(){};
+
+  // Library level records
+  virtual void onHeader(int /*version*/){};
+  virtual void onBeginLib(const std::vector<int> & /*last_modified*/){};
+  virtual void onLibName(const std::string & /*name*/){};
+  virtual void onGenerations(int /*generations*/){};
+  virtual void onUnits(double /*user_units*/, double /*meter_units*/){};
+  virtual void onEndLib(){};
+
+  // Structure level records, onBeginStr fires once the name is known
+  virtual void onBeginStr(const std::string & /*name*/,
+                          const std::vector<int> & /*last_modified*/){};
+  virtual void onBoundary(const gdsBOUNDARY & /*boundary*/){};
+  virtual void onPath(const gdsPATH & /*path*/){};
+  virtual gdsPointArena *boundaryArena() { return nullptr; };
+  virtual gdsPointArena *pathArena() { return nullptr; };
+  virtual void onSref(const gdsSREF & /*sref*/){};
+  virtual void onAref(const gdsAREF & /*aref*/){};
+  virtual void onText(const gdsTEXT & /*text*/){};
+  virtual void onNode(const gdsNODE & /*node*/){};
+  virtual void onBox(const gdsBOX & /*box*/){};
+  virtual void onEndStr(){};
+};
+
+// ================== Function Declarations ===================
+
+int gdsVisit(const std::string &fileName, gdsVisitor &visitor);
+int gdsDecodeLib(gdsReader &gdsIn, gdsVisitor &visitor);
+int gdsIndexLib(gdsReader &gdsIn, gdsVisitor &visitor,
+                std::vector<size_t> &str_offsets);
+int gdsDecodeSTR(gdsReader &gdsIn, gdsVisitor &visitor);
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * Author:      J.F. de Villiers & H.F. Herbst
+ * Origin:  		E&E Engineering - Stellenbosch University
+ * For:					Supertools, Coldflux Project - IARPA
+ * Created: 		2019-08-26
+ * Modified:
+ * license:     MIT License
+ * Description: Buffered output of GDS records with big endian bulk stores.
+ * File:				gdsWriter.hpp
+ */
+
+#ifndef GDSWriter
+#define GDSWriter
+
+// ========================== Includes ========================
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// ===================== Class Definitions ====================
+
+/*
+ * [gdsWriter - Collects GDS records in a large contiguous buffer and hands
+ * them to the file in big chunks. Values are stored big endian, as GDS
+ * requires, directly into the buffer.]
+ */
+class gdsWriter
+{
+private:
+  FILE *outFile = nullptr;
+  std::vector<unsigned char> buffer;
+  size_t used = 0;
+  bool failed = false;
+
+  void grow(size_t cnt);
+
+public:
+  gdsWriter(size_t capacity = 4 << 20) : buffer(capacity){};
+  ~gdsWriter() { close(); };
+  gdsWriter(const gdsWriter &) = delete;
+  gdsWriter &operator=(const gdsWriter &) = delete;
+
+  int open(const std::string &fileName);
+  int flush();
+  int close();
+
+  // Records still in the buffer; without a file the buffer holds them all
+  const unsigned char *data() const { return buffer.data(); };
+  size_t size() const { return used; };
+  void clear() { used = 0; };
+
+  /*
+   * [reserve - Returns room for cnt bytes at the end of the buffer, the
+   * caller must fill all of it]
+   */
+  unsigned char *reserve(size_t cnt)
+  {
+    if (used + cnt > buffer.size())
+      grow(cnt);
+    unsigned char *dest = buffer.data() + used;
+    used += cnt;
+    return dest;
+  };
+
+  void putBytes(const void *src, size_t cnt)
+  {
+    std::memcpy(reserve(cnt), src, cnt);
+  };
+  void putBlock(const void *src, size_t cnt);
+
+  // [putRecord - Record header: total length (header included) and key]
+  void putRecord(uint32_t length, uint32_t key)
+  {
+    unsigned char *dest = reserve(4);
+    dest[0] = length >> 8 & 0xff;
+    dest[1] = length & 0xff;
+    dest[2] = key >> 8 & 0xff;
+    dest[3] = key & 0xff;
+  };
+};
+
+// ================== Function Declarations ===================
+
+/*
+ * [gdsStore16/32/64 - Big endian stores of the low bits of value]
+ */
+inline void gdsStore16(unsigned char *dest, uint32_t value)
+{
+  dest[0] = value >> 8 & 0xff;
+  dest[1] = value & 0xff;
+}
+
+inline void gdsStore32(unsigned char *dest, uint32_t value)
+{
+  value = __builtin_bswap32(value);
+  std::memcpy(dest, &value, 4);
+}
+
+inline void gdsStore64(unsigned char *dest, uint64_t value)
+{
+  value = __builtin_bswap64(value);
+  std::memcpy(dest, &value, 8);
+}
+
+#endif
@@ -10,6 +10,10 @@
  */
 
 #include "chipsmith/ParserDef.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
 
 /**
  * DEF file class functions
@@ -42,90 +46,188 @@ void def_file::createAuto(vector<string> &inLine){
 }
 
 /**
- * [def_file::importFile description]
+ * [findStatements - Finds the statements of a COMPONENTS, NETS or SPECIALNETS
+ * section. A statement runs up to the line that ends in a ";" token, the
+ * section ends at a line starting with END. Only the line ends are looked at,
+ * nothing is split.]
+ * @param  text  [The text following the section header]
+ * @param  stmts [Receives the text of every statement]
+ * @return       [Where the line after the END line starts]
+ */
+
+static const char *findStatements(string_view text, vector<string_view> &stmts){
+	const char *pos = text.data();
+	const char *end = text.data() + text.size();
+	const char *stmtStart = nullptr;
+
+	while(pos < end){
+		const char *lineEnd = (const char *)memchr(pos, '\n', end - pos);
+		if(lineEnd == nullptr) lineEnd = end;
+		const char *next = lineEnd < end ? lineEnd + 1 : end;
+
+		const char *first = pos;
+		const char *last = lineEnd;
+		while(first < last && isspace((unsigned char)*first)) first++;
+		while(last > first && isspace((unsigned char)last[-1])) last--;
+		if(first == last || *pos == '#'){ // skips commented and empty lines
+			pos = next;
+			continue;
+		}
+
+		if(stmtStart == nullptr){
+			if(last - first >= 3 && !memcmp(first, "END", 3) && (last - first == 3 || isspace((unsigned char)first[3])))
+				return next;
+			stmtStart = pos;
+		}
+		if(last[-1] == ';' && (last - 1 == first || isspace((unsigned char)last[-2]))){
+			stmts.emplace_back(stmtStart, next - stmtStart);
+			stmtStart = nullptr;
+		}
+		pos = next;
+	}
+	if(stmtStart != nullptr) stmts.emplace_back(stmtStart, end - stmtStart);
+	return end;
+}
+
+/**
+ * [def_file::parseStatements - Second phase of importFile, creates the
+ * components, nets and special nets from their statements. The statements are handed out in
+ * chunks to the threads, every statement is written to its own pre-sized slot.]
+ * @param compStmts [Statements of the COMPONENTS section]
+ * @param netStmts  [Statements of the NETS section]
+ * @param snetStmts [Statements of the SPECIALNETS section]
+ * @param threads   [Number of threads, 0 - every hardware thread]
+ * @return          [Number of statements that failed to be parsed]
+ */
+
+size_t def_file::parseStatements(const vector<string_view> &compStmts, const vector<string_view> &netStmts,
+                               const vector<string_view> &snetStmts, unsigned int threads){
+	const size_t netsEnd = compStmts.size() + netStmts.size();
+	const size_t stmtCnt = netsEnd + snetStmts.size();
+	if(threads == 0) threads = thread::hardware_concurrency();
+	if(threads == 0) threads = 1;
+	threads = (unsigned int)min<size_t>(threads, max<size_t>(1, stmtCnt / 256));
+	const size_t chunk = max<size_t>(64, stmtCnt / (8 * threads));
+
+	atomic<size_t> nextChunk(0);
+	atomic<size_t> failed(0);
+	auto worker = [&](){
+		fileTokenizer stmt;
+		vector<string_view> lineVec;
+		vector<vector<string_view> > strBlock;
+
+		while(1){
+			size_t from = nextChunk.fetch_add(chunk);
+			if(from >= stmtCnt) break;
+			size_t to = min(stmtCnt, from + chunk);
+
+			for(size_t i = from; i < to; i++){
+				if(i < compStmts.size()){
+					// A component on more than one line is joined into one
+					stmt.open(compStmts[i]);
+					lineVec.clear();
+					while(stmt.nextLine()){
+						lineVec.insert(lineVec.end(), stmt.line().begin(), stmt.line().end());
+					}
+					if(!this->comps[i].createAuto(lineVec)) failed++;
+				}
+				else{
+					// The line vectors are reused from net to net
+					stmt.open(i < netsEnd ? netStmts[i - compStmts.size()] : snetStmts[i - netsEnd]);
+					size_t blockLines = 0;
+					while(stmt.nextLine()){
+						if(strBlock.size() <= blockLines) strBlock.emplace_back();
+						strBlock[blockLines++].assign(stmt.line().begin(), stmt.line().end());
+					}
+					strBlock.resize(blockLines);
+					// disVectorBlk(strBlock);
+					int parsed;
+					if(i < netsEnd) parsed = this->nets[i - compStmts.size()].createAuto(strBlock);
+					else parsed = this->snets[i - netsEnd].createAutoSpecial(strBlock);
+					if(!parsed) failed++;
+				}
+			}
+		}
+	};
+
+	vector<thread> workers;
+	for(unsigned int t = 1; t < threads; t++){
+		workers.emplace_back(worker);
+	}
+	worker();
+	for(auto &foo: workers){
+		foo.join();
+	}
+	return failed;
+}
+
+/**
+ * [def_file::importFile - Imports the DEF file in two phases. The first reads
+ * the file in order, handles the overheads and only finds where the
+ * statements of the COMPONENTS, NETS and SPECIALNETS sections are. The second parses the
+ * statements in parallel, see parseStatements.]
  * @param  fileName [File name of the def file to be imported]
+ * @param  threads  [Number of threads, 0 - every hardware thread]
  * @return          [1 - All good, 0 - Error]
  */
 
-int def_file::importFile(const string &fileName){
-	vector<string> lineVec;
-	vector<vector<string> > strBlock;
+int def_file::importFile(const string &fileName, unsigned int threads){
 	string keyword;
+	vector<string_view> compStmts;
+	vector<string_view> netStmts;
+	vector<string_view> snetStmts;
 
-	ifstream defFile;
+	fileTokenizer defFile;
 
 	bool proOH = false;
 
 	cout << "Importing DEF file \""  << fileName << "\"" << endl;
 
-	defFile.open(fileName);
-
-	if(!defFile.is_open()){
+	if(defFile.open(fileName)){
 		cout << "DEF file \""  << fileName << "\" failed to be opened." << endl;
 		return 0;
 	}
 
 	while(1){
-		lineVec = splitFileLine(defFile);
-		keyword = lineVec[0];
+		if(!defFile.nextLine()){
+			cout << "Unexpected end of DEF file." << endl;
+			return 0;
+		}
+		keyword = defFile[0];
 
 		if(this->validNBlkWords.find(keyword) != this->validNBlkWords.end()){
 			if(keyword == "COMPONENTS"){
 				cout << "Processing components..." << endl;
-				this->comps.resize(stoi(lineVec[1]));
+				this->comps.resize(svToInt(defFile[1]));
 
-				unsigned int compIndex = 0;
-				lineVec = splitFileLine(defFile);
-				while(lineVec[0] != "END" && lineVec[1] != "COMPONENTS"){
-					this->comps[compIndex++].createAuto(lineVec);
-					lineVec = splitFileLine(defFile);
+				compStmts.clear();
+				defFile.seek(findStatements(defFile.rest(), compStmts));
+				if(compStmts.size() > this->comps.size()){
+					cout << "More components than the " << this->comps.size() << " declared." << endl;
+					return 0;
 				}
 			}
 			else if(keyword == "NETS"){
 				cout << "Processing nets..." << endl;
-				this->nets.resize(stoi(lineVec[1]));
-
-				unsigned int netIndex = 0;
-				lineVec = splitFileLine(defFile);
-
-				while(lineVec[0] != "END" && lineVec[1] != "NETS"){
-					while(lineVec[lineVec.size()-1] != ";"){
-						strBlock.push_back(lineVec);
-						lineVec = splitFileLine(defFile);
-					}
-					strBlock.push_back(lineVec);
-
-					// disVectorBlk(strBlock);
-					this->nets[netIndex++].createAuto(strBlock);
+				this->nets.resize(svToInt(defFile[1]));
 
-					strBlock.clear();
-					lineVec = splitFileLine(defFile);
+				netStmts.clear();
+				defFile.seek(findStatements(defFile.rest(), netStmts));
+				if(netStmts.size() > this->nets.size()){
+					cout << "More nets than the " << this->nets.size() << " declared." << endl;
+					return 0;
 				}
 			}
 			else if(keyword == "SPECIALNETS"){
-				cout << "Skipping special nets..." << endl;
-				// this->snets.resize(stoi(lineVec[1]));
-
-				// unsigned int snetIndex = 0;
-				// lineVec = splitFileLine(defFile);
-
-				// while(lineVec[0] != "END" && lineVec[1] != "SPECIALNETS"){
-        while(lineVec[0] != "END"){
-          lineVec = splitFileLine(defFile);
-
-					// while(lineVec[lineVec.size()-1] != ";"){
-					// 	strBlock.push_back(lineVec);
-					// 	lineVec = splitFileLine(defFile);
-					// }
-					// strBlock.push_back(lineVec);
-
-					// // disVectorBlk(strBlock);
-					// this->snets[snetIndex++].createAutoSpecial(strBlock);
-
-					// strBlock.clear();
-					// lineVec = splitFileLine(defFile);
+				cout << "Processing special nets..." << endl;
+				this->snets.resize(svToInt(defFile[1]));
+
+				snetStmts.clear();
+				defFile.seek(findStatements(defFile.rest(), snetStmts));
+				if(snetStmts.size() > this->snets.size()){
+					cout << "More special nets than the " << this->snets.size() << " declared." << endl;
+					return 0;
 				}
-        cout << "Special nets, done." << endl;
 			}
 			else{
 				cout << "Check for smoke." << endl;
@@ -138,18 +240,25 @@ int def_file::importFile(const string &fileName){
 			// }
 			// this->createAuto(lineVec);
 		}
-		else if(lineVec[0] == "END" && lineVec[1] == "DESIGN"){
-			cout << "Importing DEF file done." << endl;
+		else if(defFile[0] == "END" && defFile[1] == "DESIGN"){
 			break;
 		}
 		else{
 			cout << "Unknown word." << endl;
-      disVector(lineVec);
+			vector<string> lineVec(defFile.line().begin(), defFile.line().end());
+			disVector(lineVec);
 			return 0;
 		}
 	}
 
+	// The statements point into the mapped file, it is closed afterwards
+	size_t failed = this->parseStatements(compStmts, netStmts, snetStmts, threads);
 	defFile.close();
+	if(failed > 0){
+		cout << failed << " statements of DEF file \""  << fileName << "\" failed to be parsed." << endl;
+		return 0;
+	}
+	cout << "Importing DEF file done." << endl;
 
 	return 1;
 }
@@ -253,6 +362,152 @@ int def_file::importFile(const string &fileName){
 // 	return errorVec;
 // }
 
+/**
+ * [putCachedNets/getCachedNets - Nets and their routes in a snapshot]
+ */
+
+static void putCachedNets(cacheWriter &cache, const vector<def_net> &nets){
+	cache.put((uint32_t)nets.size());
+	for(const auto &net: nets){
+		cache.put(net.name);
+		cache.put(net.fromComp);
+		cache.put(net.fromPin);
+		cache.put(net.ToComp);
+		cache.put(net.ToPin);
+		cache.put((uint32_t)net.routes.size());
+		for(const auto &route: net.routes){
+			cache.put(route.LAYER);
+			cache.put(route.VIA);
+			cache.put(route.trackWidth);
+			cache.put(route.ptX);
+			cache.put(route.ptY);
+		}
+	}
+}
+
+static void getCachedNets(cacheReader &cache, vector<def_net> &nets){
+	nets.resize(cache.count());
+	for(auto &net: nets){
+		cache.get(net.name);
+		cache.get(net.fromComp);
+		cache.get(net.fromPin);
+		cache.get(net.ToComp);
+		cache.get(net.ToPin);
+		net.routes.resize(cache.count());
+		for(auto &route: net.routes){
+			cache.get(route.LAYER);
+			cache.get(route.VIA);
+			route.trackWidth = cache.get<unsigned int>();
+			cache.get(route.ptX);
+			cache.get(route.ptY);
+		}
+	}
+}
+
+/**
+ * [def_file::saveCache - Writes a binary snapshot of the imported DEF file]
+ * @param  fileName [The DEF file that was imported]
+ * @param  cacheDir [Directory of the snapshot; "" - Next to the file]
+ * @return          [0 - All good; 1 - Error]
+ */
+
+int def_file::saveCache(const string &fileName, const string &cacheDir){
+	cacheWriter cache;
+
+	cache.put(this->name);
+	cache.put(this->DESIGN);
+	cache.put(this->unitsUnits);
+	cache.put(this->unitsVar);
+	cache.put(this->DIEAREA);
+
+	cache.put((uint32_t)this->comps.size());
+	for(const auto &comp: this->comps){
+		cache.put(comp.name);
+		cache.put(comp.compName);
+		cache.put(comp.posType);
+		cache.put(comp.corX);
+		cache.put(comp.corY);
+		cache.put(comp.orient);
+		cache.put(comp.compType);
+	}
+
+	putCachedNets(cache, this->nets);
+	putCachedNets(cache, this->snets);
+
+	return cache.save(fileName, cacheDEF, cacheDir);
+}
+
+/**
+ * [def_file::loadCache - Reads the snapshot of a DEF file instead of parsing
+ * it, the snapshot is only used while the DEF file is unchanged]
+ * @param  fileName [The DEF file to be imported]
+ * @param  cacheDir [Directory of the snapshot; "" - Next to the file]
+ * @return          [0 - All good; 1 - No valid snapshot, nothing changed]
+ */
+
+int def_file::loadCache(const string &fileName, const string &cacheDir){
+	cacheReader cache;
+	if(cache.open(fileName, cacheDEF, cacheDir)) return 1;
+
+	def_file cached;
+	cache.get(cached.name);
+	cache.get(cached.DESIGN);
+	cache.get(cached.unitsUnits);
+	cached.unitsVar = cache.get<int>();
+	for(auto &foo: cached.DIEAREA){
+		foo = cache.get<int>();
+	}
+
+	cached.comps.resize(cache.count());
+	for(auto &comp: cached.comps){
+		cache.get(comp.name);
+		cache.get(comp.compName);
+		cache.get(comp.posType);
+		comp.corX = cache.get<int>();
+		comp.corY = cache.get<int>();
+		cache.get(comp.orient);
+		cache.get(comp.compType);
+	}
+
+	getCachedNets(cache, cached.nets);
+	getCachedNets(cache, cached.snets);
+
+	if(!cache.ok()) return 1;
+
+	*this = move(cached);
+	cout << "Imported DEF file \"" << fileName << "\" from its cache." << endl;
+	return 0;
+}
+
+/**
+ * [def_file::operator== - Same contents, e.g. parsed and read from the cache]
+ */
+
+bool def_file::operator==(const def_file &other) const{
+	return this->name == other.name && this->DESIGN == other.DESIGN &&
+	       this->unitsUnits == other.unitsUnits && this->unitsVar == other.unitsVar &&
+	       equal(this->DIEAREA, this->DIEAREA + 4, other.DIEAREA) &&
+	       this->comps == other.comps && this->nets == other.nets && this->snets == other.snets;
+}
+
+bool def_component::operator==(const def_component &other) const{
+	return this->name == other.name && this->compName == other.compName &&
+	       this->posType == other.posType && this->corX == other.corX &&
+	       this->corY == other.corY && this->orient == other.orient &&
+	       this->compType == other.compType;
+}
+
+bool net_route::operator==(const net_route &other) const{
+	return this->LAYER == other.LAYER && this->VIA == other.VIA &&
+	       this->trackWidth == other.trackWidth && this->ptX == other.ptX && this->ptY == other.ptY;
+}
+
+bool def_net::operator==(const def_net &other) const{
+	return this->name == other.name && this->fromComp == other.fromComp &&
+	       this->fromPin == other.fromPin && this->ToComp == other.ToComp &&
+	       this->ToPin == other.ToPin && this->routes == other.routes;
+}
+
 /**
  * [def_file::to_def description]
  * @param  fileName [The file name of the to be created def file]
@@ -417,12 +672,16 @@ void def_file::to_str(){
  * Components class functions
  */
 
-int def_component::createAuto(vector<string> &inLine){
+int def_component::createAuto(const vector<string_view> &inLine){
+	if(inLine.size() < 10){
+		cout << "Component syntax error." << endl;
+		return 0;
+	}
 	this->name = inLine[1];
 	this->compName = inLine[2];
 	this->posType = inLine[4];
-	this->corX = (int)stod(inLine[6]);
-	this->corY = (int)stod(inLine[7]);
+	this->corX = (int)svToDouble(inLine[6]);
+	this->corY = (int)svToDouble(inLine[7]);
 	this->orient = inLine[9];
 
 	return 1;
@@ -441,7 +700,7 @@ void def_component::to_str(){
  * Net class functions
  */
 
-int def_net::createAuto(vector<vector<string> > &inBlock){
+int def_net::createAuto(const vector<vector<string_view> > &inBlock){
 	this->name = inBlock[0][1];
 	this->fromComp = inBlock[1][1];
 	this->fromPin = inBlock[1][2];
@@ -450,7 +709,7 @@ int def_net::createAuto(vector<vector<string> > &inBlock){
 
 	for(int i = 3; i < inBlock.size(); i++){
 		net_route tempRoute;
-		string tempChar;
+		string_view tempChar;
 
 		int k = 1;
 
@@ -461,31 +720,31 @@ int def_net::createAuto(vector<vector<string> > &inBlock){
 
 		tempRoute.LAYER = inBlock[i][k++];
 
-		while(inBlock[i][k] == "("){
+		while(k < inBlock[i].size() && inBlock[i][k] == "("){
 			if(inBlock[i][++k] != "*")
-				tempRoute.ptX.push_back((int)stod(inBlock[i][k]));
+				tempRoute.ptX.push_back((int)svToDouble(inBlock[i][k]));
 			else{
 				int j = 4;
 				while(inBlock[i][k-j] == "*"){
 					j = j + 4;
 				}
-				tempRoute.ptX.push_back((int)stod(inBlock[i][k-j]));
+				tempRoute.ptX.push_back((int)svToDouble(inBlock[i][k-j]));
 			}
 
 			if(inBlock[i][++k] != "*")
-				tempRoute.ptY.push_back((int)stod(inBlock[i][k]));
+				tempRoute.ptY.push_back((int)svToDouble(inBlock[i][k]));
 			else{
 				int j = 4;
 				while(inBlock[i][k-j] == "*"){
 					j = j + 4;
 				}
-				tempRoute.ptY.push_back((int)stod(inBlock[i][k-j]));
+				tempRoute.ptY.push_back((int)svToDouble(inBlock[i][k-j]));
 			}
 
 			k = k + 2;
 			if(k < inBlock[i].size()){
 				tempChar = inBlock[i][k];
-				if(tempChar != "(" && tempChar != ";" && tempChar != "\0"){
+				if(tempChar != "(" && tempChar != ";" && !tempChar.empty()){
 					tempRoute.VIA = inBlock[i][k];
 					break;
 				}
@@ -551,68 +810,88 @@ void def_net::to_str(){
  * Specialnet class functions
  */
 
- int def_net::createAutoSpecial(vector<vector<string> > &inBlock){
-	this->name = inBlock[0][1];
-
-	for(int i = 1; i < inBlock.size(); i++){
-		net_route tempRoute;
-		string tempChar;
-		int k;
-
-		k = 1;
-
-		tempChar = inBlock[i][0];
-		if(tempChar == "+"){
-			k++;
-		}
+/**
+ * [def_net::createAutoSpecial - Creates a special net from its statement.
+ * Every "+ ROUTED" (FIXED, COVER or SHIELD) and NEW part of the wiring becomes
+ * a route with its layer and width. The statement is read as one stream of
+ * tokens, so where the lines break does not matter. A "*" repeats the
+ * coordinate of the previous point, other attributes such as "+ USE POWER"
+ * are skipped.]
+ * @param  inBlock [The lines of the statement]
+ * @return         [1 - All good, 0 - Error]
+ */
 
-		tempRoute.LAYER = inBlock[i][k++];
-		tempRoute.trackWidth = stoi(inBlock[i][k++]);
+int def_net::createAutoSpecial(const vector<vector<string_view> > &inBlock){
+	if(inBlock.empty() || inBlock[0].size() < 2){
+		cout << "Special net syntax error." << endl;
+		return 0;
+	}
+	this->name = inBlock[0][1];
+	this->routes.clear();
 
-		disVector(inBlock[i]);
+	vector<string_view> tokens(inBlock[0].begin() + 2, inBlock[0].end());
+	for(size_t i = 1; i < inBlock.size(); i++){
+		tokens.insert(tokens.end(), inBlock[i].begin(), inBlock[i].end());
+	}
 
-		while(inBlock[i][k] == "("){
-			if(inBlock[i][++k] != "*")
-				tempRoute.ptX.push_back((int)stod(inBlock[i][k]));
-			else{
-				int j = 4;
-				while(inBlock[i][k-j] == "*"){
-					j = j + 4;
-				}
-				tempRoute.ptX.push_back((int)stod(inBlock[i][k-j]));
+	bool wiring = false; // In the points and vias of a route
+	size_t k = 0;
+	while(k < tokens.size() && tokens[k] != ";"){
+		size_t layerAt = 0;
+		if(tokens[k] == "+" && k + 1 < tokens.size()){
+			string_view keyword = tokens[k + 1];
+			if(keyword == "ROUTED" || keyword == "FIXED" || keyword == "COVER" || keyword == "SHIELD"){
+				layerAt = k + (keyword == "SHIELD" ? 3 : 2); // SHIELD names the shielded net first
+			}
+			else if(wiring && (keyword == "SHAPE" || keyword == "STYLE")){
+				k += 3;
+				continue;
 			}
-
-			if(inBlock[i][++k] != "*")
-				tempRoute.ptY.push_back((int)stod(inBlock[i][k]));
 			else{
-				int j = 4;
-				while(inBlock[i][k-j] == "*"){
-					j = j + 4;
-				}
-				tempRoute.ptY.push_back((int)stod(inBlock[i][k-j]));
+				wiring = false;          // + USE POWER, + SOURCE NETLIST, ...
+				k += 2;
+				continue;
 			}
+		}
+		else if(tokens[k] == "NEW" && wiring){
+			layerAt = k + 1;
+		}
 
-			k = k + 2;
-
-			unsigned int fooSize;
-			fooSize = inBlock[i].size();
-
-			if(k >= fooSize){
-				k = inBlock[i].size() - 1;
+		if(layerAt > 0){
+			if(layerAt + 1 >= tokens.size()){
+				cout << "Special net \"" << this->name << "\" has wiring without a layer and width." << endl;
+				return 0;
 			}
-			// unsigned int fooSize;
-			// fooSize = inBlock[i].size();
-
-			// if(k < fooSize){
-			// 	tempChar = inBlock[i][k];
-			// 	if(tempChar != "(" && tempChar != ";" && tempChar != "\0"){
-			// 		tempRoute.VIA = inBlock[i][k];
-			// 		break;
-			// 	}
-			// }
+			net_route tempRoute;
+			tempRoute.LAYER = tokens[layerAt];
+			tempRoute.trackWidth = svToInt(tokens[layerAt + 1]);
+			this->routes.push_back(tempRoute);
+			wiring = true;
+			k = layerAt + 2;
+		}
+		else if(!wiring){
+			k++;                       // Connections and attribute values
+		}
+		else if(tokens[k] == "(" && k + 2 < tokens.size()){
+			net_route &route = this->routes.back();
+			string_view x = tokens[k + 1];
+			string_view y = tokens[k + 2];
+			if((x == "*" || y == "*") && route.ptX.empty()){
+				cout << "Special net \"" << this->name << "\" repeats a missing point." << endl;
+				return 0;
+			}
+			route.ptX.push_back(x == "*" ? route.ptX.back() : (int)svToDouble(x));
+			route.ptY.push_back(y == "*" ? route.ptY.back() : (int)svToDouble(y));
+			k += 3;
+			while(k < tokens.size() && tokens[k] != ")") k++; // Extension value
+			k++;
+		}
+		else if(tokens[k] == "MASK"){
+			k += 2;
+		}
+		else{
+			this->routes.back().VIA = tokens[k++];
 		}
-		this->routes.push_back(tempRoute);
-
 	}
 	return 1;
-}
\ No newline at end of file
+}
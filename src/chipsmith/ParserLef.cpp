@@ -14,7 +14,7 @@
 /**
  * [lef_file::importFile - Imports a LEF file]
  * @param  fileName [The lef file to be imported]
- * @return          [0 - All good; 1 - Error]
+ * @return          [1 - All good; 0 - Error]
  */
 
 int lef_file::importFile(const string &fileName){
@@ -25,28 +25,34 @@ int lef_file::importFile(const string &fileName){
   string tempDis;
   string blockName;
 
-  ifstream lefFile;
-
-  lefFile.open(fileName);
+  fileTokenizer lefFile;
 
-  if(!lefFile.is_open()){
+  if(lefFile.open(fileName)){
     cout << "LEF file FAILED to be properly opened" << endl;
     return 0;
   }
 
+  // Only the block lines are kept as strings, the rest is compared in place
+  auto blockLine = [&](){
+    strBlock.emplace_back(lefFile.line().begin(), lefFile.line().end());
+  };
+
   while(1){
-    lineVec = splitFileLine(lefFile);
-    keyword = lineVec[0];
+    if(!lefFile.nextLine()){
+      cout << "Unexpected end of LEF file." << endl;
+      return 0;
+    }
+    keyword = lefFile[0];
     if(blkEndWithName.find(keyword) != blkEndWithName.end()){
 
       //Creating a sub block
       strBlock.clear();
-      strBlock.push_back(lineVec);
-      string blockName = lineVec[1];
+      blockLine();
+      string blockName(lefFile[1]);
       for(int i = 0; i < 254; i++){          // can use while loop, but for loop is used for safety
-        lineVec = splitFileLine(lefFile);
-        strBlock.push_back(lineVec);
-        if(lineVec[0] == "END" && lineVec[1] == blockName)
+        if(!lefFile.nextLine()) break;
+        blockLine();
+        if(lefFile[0] == "END" && lefFile[1] == blockName)
           break;
       }
 
@@ -63,11 +69,11 @@ int lef_file::importFile(const string &fileName){
 
       //Creating a sub block
       strBlock.clear();
-      strBlock.push_back(lineVec);
+      blockLine();
       for(int i = 0; i < 64; i++){
-        lineVec = splitFileLine(lefFile);
-        strBlock.push_back(lineVec);
-        if(lineVec[0] == "END" && lineVec[1] == keyword)
+        if(!lefFile.nextLine()) break;
+        blockLine();
+        if(lefFile[0] == "END" && lefFile[1] == keyword)
           break;
       }
 
@@ -79,7 +85,7 @@ int lef_file::importFile(const string &fileName){
         // cout << "Stuffs is cases sensitive." << endl;
       }
       else if(keyword == "END"){
-        if(lineVec[1] == "LIBRARY"){
+        if(lefFile[1] == "LIBRARY"){
           cout << "Importing LEF file done." << endl;
           break;
         }
@@ -92,6 +98,7 @@ int lef_file::importFile(const string &fileName){
       // word not in the library, out error;
 
       cout << "Error with line ->" << endl;
+      lineVec.assign(lefFile.line().begin(), lefFile.line().end());
       disVector(lineVec);
       cout << "<--------------------" << endl;
 
@@ -103,7 +110,7 @@ int lef_file::importFile(const string &fileName){
 
   }
   lefFile.close();
-  return 0;
+  return 1;
 }
 
 /**
@@ -515,6 +522,163 @@ int lef_macro::autoCreate(vector<vector<string> > &inBlock){
   return 0;
 }
 
+/**
+ * [putPorts/getPorts - Ports of a macro pin or obstruction in a snapshot]
+ */
+
+static void putPorts(cacheWriter &cache, const vector<macro_port> &ports){
+  cache.put((uint32_t)ports.size());
+  for(const auto &port: ports){
+    cache.put(port.layer);
+    cache.put(port.ptsX);
+    cache.put(port.ptsY);
+  }
+}
+
+static void getPorts(cacheReader &cache, vector<macro_port> &ports){
+  ports.resize(cache.count());
+  for(auto &port: ports){
+    cache.get(port.layer);
+    cache.get(port.ptsX);
+    cache.get(port.ptsY);
+  }
+}
+
+/**
+ * [lef_file::saveCache - Writes a binary snapshot of the imported LEF file]
+ * @param  fileName [The LEF file that was imported]
+ * @param  cacheDir [Directory of the snapshot; "" - Next to the file]
+ * @return          [0 - All good; 1 - Error]
+ */
+
+int lef_file::saveCache(const string &fileName, const string &cacheDir){
+  cacheWriter cache;
+
+  cache.put((uint32_t)this->macros.size());
+  for(const auto &macro: this->macros){
+    cache.put(macro.name);
+    cache.put(macro.sizeX);
+    cache.put(macro.sizeY);
+    cache.put(macro.originX);
+    cache.put(macro.originY);
+    cache.put((uint32_t)macro.pins.size());
+    for(const auto &pin: macro.pins){
+      cache.put(pin.name);
+      cache.put(pin.direction);
+      putPorts(cache, pin.ports);
+    }
+    putPorts(cache, macro.obs);
+  }
+
+  cache.put((uint32_t)this->layers.size());
+  for(const auto &layer: this->layers){
+    cache.put(layer.name);
+    cache.put(layer.type);
+    cache.put(layer.direction);
+    cache.put(layer.pitch);
+    cache.put(layer.width);
+    cache.put(layer.spacing);
+  }
+
+  cache.put((uint32_t)this->vias.size());
+  for(const auto &via: this->vias){
+    cache.put(via.name);
+    cache.put(via.layers);
+    cache.put(via.ptsX);
+    cache.put(via.ptsY);
+  }
+
+  return cache.save(fileName, cacheLEF, cacheDir);
+}
+
+/**
+ * [lef_file::loadCache - Reads the snapshot of a LEF file instead of parsing
+ * it, the snapshot is only used while the LEF file is unchanged]
+ * @param  fileName [The LEF file to be imported]
+ * @param  cacheDir [Directory of the snapshot; "" - Next to the file]
+ * @return          [0 - All good; 1 - No valid snapshot, nothing changed]
+ */
+
+int lef_file::loadCache(const string &fileName, const string &cacheDir){
+  cacheReader cache;
+  if(cache.open(fileName, cacheLEF, cacheDir)) return 1;
+
+  vector<lef_macro> cachedMacros(cache.count());
+  for(auto &macro: cachedMacros){
+    cache.get(macro.name);
+    macro.sizeX = cache.get<double>();
+    macro.sizeY = cache.get<double>();
+    macro.originX = cache.get<double>();
+    macro.originY = cache.get<double>();
+    macro.pins.resize(cache.count());
+    for(auto &pin: macro.pins){
+      cache.get(pin.name);
+      cache.get(pin.direction);
+      getPorts(cache, pin.ports);
+    }
+    getPorts(cache, macro.obs);
+  }
+
+  vector<lef_layer> cachedLayers(cache.count());
+  for(auto &layer: cachedLayers){
+    cache.get(layer.name);
+    cache.get(layer.type);
+    cache.get(layer.direction);
+    layer.pitch = cache.get<float>();
+    layer.width = cache.get<float>();
+    layer.spacing = cache.get<float>();
+  }
+
+  vector<lef_via> cachedVias(cache.count());
+  for(auto &via: cachedVias){
+    cache.get(via.name);
+    cache.get(via.layers);
+    cache.get(via.ptsX);
+    cache.get(via.ptsY);
+  }
+
+  if(!cache.ok()) return 1;
+
+  this->macros = move(cachedMacros);
+  this->layers = move(cachedLayers);
+  this->vias = move(cachedVias);
+  cout << "Imported LEF file \"" << fileName << "\" from its cache." << endl;
+  return 0;
+}
+
+/**
+ * [lef_file::operator== - Same contents, e.g. parsed and read from the cache]
+ */
+
+bool lef_file::operator==(const lef_file &other) const{
+  return this->macros == other.macros && this->layers == other.layers && this->vias == other.vias;
+}
+
+bool macro_port::operator==(const macro_port &other) const{
+  return this->layer == other.layer && this->ptsX == other.ptsX && this->ptsY == other.ptsY;
+}
+
+bool macro_pin::operator==(const macro_pin &other) const{
+  return this->name == other.name && this->direction == other.direction && this->ports == other.ports;
+}
+
+bool lef_macro::operator==(const lef_macro &other) const{
+  return this->name == other.name && this->sizeX == other.sizeX && this->sizeY == other.sizeY &&
+         this->originX == other.originX && this->originY == other.originY &&
+         this->pins == other.pins && this->obs == other.obs;
+}
+
+bool lef_layer::operator==(const lef_layer &other) const{
+  return this->name == other.name && this->type == other.type &&
+         this->direction == other.direction && this->pitch == other.pitch &&
+         this->width == other.width && this->spacing == other.spacing;
+}
+
+bool lef_via::operator==(const lef_via &other) const{
+  return this->name == other.name && this->layers == other.layers &&
+         this->ptsX == other.ptsX && this->ptsY == other.ptsY;
+}
+
 void lef_file::to_str(){
   for(auto foo: this->macros){
     foo.to_str();
@@ -20,11 +20,15 @@
 int chipSmith::toGDS(const string &gdsFileName){
   gdsSTR GDSmainSTR;
 
+  // Gate and fill geometry is only passed through, keep it compact
+  this->gdsF.set_compact_geometry(true);
+
   this->importGates();
   if(this->fillEnable) this->importFill();
   this->placeGates();
   this->placeNets();
   this->placeBias();
+  this->indexPlacement();
   if(this->fillEnable) this->placeFill();
 
   GDSmainSTR.name = fileRenamer(gdsFileName, "", "");
@@ -35,7 +39,7 @@ int chipSmith::toGDS(const string &gdsFileName){
   if(this->fillEnable) GDSmainSTR.SREF.push_back(drawSREF("Fill", 0, 0));
 
   gdsF.setSTR(GDSmainSTR);
-  gdsF.write(gdsFileName);
+  gdsF.write(gdsFileName, 0); // Serialize on every hardware thread
 
   return 0;
 }
@@ -51,8 +55,20 @@ int chipSmith::toGDS(const string &gdsFileName){
 int chipSmith::importData(const string &lefFileName, const string &defFileName, const string &conFileName){
   cout << "Importing data." << endl;
 
-  this->lefFile.importFile(lefFileName);
-  this->defFile.importFile(defFileName);
+  // Config file
+  const auto mainConfig = toml::parse(conFileName);
+  const auto &Para = toml::find(mainConfig, "Parameters");
+
+  // Unchanged LEF/DEF files are read from their binary snapshots
+  this->cacheEnable = toml::find_or(Para, "cache", false);
+  this->cacheDir = toml::find_or(Para, "cacheDir", string(""));
+
+  if(!this->cacheEnable || this->lefFile.loadCache(lefFileName, this->cacheDir)){
+    if(this->lefFile.importFile(lefFileName) && this->cacheEnable) this->lefFile.saveCache(lefFileName, this->cacheDir);
+  }
+  if(!this->cacheEnable || this->defFile.loadCache(defFileName, this->cacheDir)){
+    if(this->defFile.importFile(defFileName) && this->cacheEnable) this->defFile.saveCache(defFileName, this->cacheDir);
+  }
 
   // checking what cells are used
   bool fFlag;
@@ -74,8 +90,6 @@ int chipSmith::importData(const string &lefFileName, const string &defFileName,
   //   cout << itList << endl;
   // }
 
-  // Config file
-  const auto mainConfig = toml::parse(conFileName);
   this->gdsFileLoc      = toml::get<map<string, string>>(mainConfig.at("GDS_CELL_LOCATIONS"));
   this->lef2gdsNames    = toml::get<map<string, string>>(mainConfig.at("GDS_MAIN_STR_NAME"));
   this->gdsFillFileLoc  = toml::get<map<string, string>>(mainConfig.at("GDS_LOCATIONS"));
@@ -85,11 +99,13 @@ int chipSmith::importData(const string &lefFileName, const string &defFileName,
    ************************** Fill Parameters ********************************
    ***************************************************************************/
 
-  const auto &Para = toml::find(mainConfig, "Parameters");
-
   auto element = toml::find(Para, "fill");
   this->fillEnable = toml::get<bool>(element);
 
+  this->fillArray = toml::find_or(Para, "fillArray", false);
+
+  this->biasFromSpecialNets = toml::find_or(Para, "biasFromSpecialNets", false);
+
   element = toml::find(Para, "fillCor");
   this->fillCor = toml::get<vector<int>>(element);
 
@@ -109,13 +125,10 @@ int chipSmith::importData(const string &lefFileName, const string &defFileName,
 
   cout << "Defining grid." << endl;
 
-  vector<bool> yFill;
-  yFill.resize(gridLY, true);
-
   this->grid.resize(7);
 
   for(auto &foo: this->grid){
-    foo.resize(gridLX, yFill);
+    foo.reset(gridLX, gridLY, true);
   }
 
   cout << "Defining grid, done." << endl;
@@ -150,10 +163,12 @@ int chipSmith::placeGates(){
   gdsSTR GDSdefSTR;
   GDSdefSTR.name = "Components";
 
+  // Plain placements, kept in the compact reference columns
+  GDSdefSTR.SREFcols.reserve(defFile.comps.size());
   for(auto &itComps: defFile.comps){
-    GDSdefSTR.SREF.push_back(drawSREF(this->lef2gdsNames[itComps.getCompType()],
-                                      itComps.getCorX() * 10,
-                                      itComps.getCorY() * 10));
+    GDSdefSTR.SREFcols.push_back(this->lef2gdsNames[itComps.getCompType()],
+                                 itComps.getCorX() * 10,
+                                 itComps.getCorY() * 10);
   }
 
   gdsF.setSTR(GDSdefSTR);
@@ -163,6 +178,18 @@ int chipSmith::placeGates(){
   return 0;
 }
 
+/**
+ * [routeLayer - GDS layer of a DEF routing layer]
+ * @param  layer [Name of the layer in the DEF file]
+ * @return       [The GDS layer; 0 - Not a routing layer]
+ */
+
+static unsigned int routeLayer(const string &layer){
+  if(!layer.compare("metal1")) return 10;
+  if(!layer.compare("metal2")) return 30;
+  return 0;
+}
+
 /**
  * [forgedChip::placeNets - Reads the description of the nets in the DEf file and routes them in the GDS file]
  * @return [0 - All good; 1 - Error]
@@ -197,11 +224,9 @@ int chipSmith::placeNets(){
         corX.push_back(itPath.ptX[i] * 10);
         corY.push_back(itPath.ptY[i] * 10);
       }
-      if(!itPath.LAYER.compare("metal1")){
-        GDSroute.PATH.push_back(drawPath(10, this->PTLwidth, corX, corY));
-      }
-      else if(!itPath.LAYER.compare("metal2")){
-        GDSroute.PATH.push_back(drawPath(30, this->PTLwidth, corX, corY));
+      unsigned int layer = routeLayer(itPath.LAYER);
+      if(layer){
+        drawPath(GDSroute.PATHarena, layer, this->PTLwidth, corX, corY);
       }
     }
   }
@@ -210,9 +235,10 @@ int chipSmith::placeNets(){
    * VIAS
    */
 
+  const gdsName viaName("ViaM1M3");
   for(auto &itNet: this->defFile.nets){
     for(int i = 0; i < itNet.routes.size() -1; i++){
-      GDSvia.SREF.push_back(drawSREF("ViaM1M3", itNet.routes[i].ptX.back() * 10, itNet.routes[i].ptY.back() * 10));
+      GDSvia.SREFcols.push_back(viaName, itNet.routes[i].ptX.back() * 10, itNet.routes[i].ptY.back() * 10);
     }
   }
 
@@ -225,7 +251,22 @@ int chipSmith::placeNets(){
 }
 
 /**
- * [chipSmith::placeFill - Checks where fill is needed and does it...]
+ * [chipSmith::cellSize - Bounding box of a gate, found by its name ID]
+ * @param  gateName [Name of the gate structure]
+ * @return          [x_0, y_0, x_1, y_1 of the gate; nullptr - Unknown gate]
+ */
+
+const vector<int> *chipSmith::cellSize(const gdsName &gateName) const{
+  if(gateName.id() >= this->cellSizeOf.size() || this->cellSizeOf[gateName.id()].size() < 4){
+    return nullptr;
+  }
+  return &this->cellSizeOf[gateName.id()];
+}
+
+/**
+ * [chipSmith::placeFill - Checks where fill is needed and does it...
+ * Every group of layers is blocked and plotted on its own thread, the layer
+ * groups only read the placed structures and write to their own grid layers.]
  * @return [0 - All good; 1 - Error]
  */
 
@@ -238,93 +279,42 @@ int chipSmith::placeFill(){
   vector<gdsSTR> GDSfil;
   GDSfil.resize(gdsFillName.size());
 
-  /***************************************************************************
-   ******************************* Fill All **********************************
-   ***************************************************************************/
-  /*
-   * Fill the whole circuit
-   */
-
-  cout << "Filling the whole circuit." << endl;
-
   GDSfil[0].name = "FillAll";
-  GDSfill.SREF.push_back(drawSREF("FillAll", 0, 0));
-
-  cout << "Filling the whole circuit, done." << endl;
-
-  /***************************************************************************
-   ****************************** Fill M4 & M6 *******************************
-   ***************************************************************************/
-  /*
-   * Fill where there are no cells
-   */
-
-  cout << "Filling M4 & M6, around gates." << endl;
-
+  GDSfil[1].name = "FillM1";
+  GDSfil[2].name = "FillM2";
+  GDSfil[3].name = "FillM3";
   GDSfil[4].name = "FillM4";
+  GDSfil[5].name = "FillM5";
   GDSfil[6].name = "FillM6";
-  GDSfill.SREF.push_back(drawSREF("FillM4", 0, 0));
-  GDSfill.SREF.push_back(drawSREF("FillM6", 0, 0));
-
-  /**
-   * Find the index of the Components in STR vector
-   */
-
-  unsigned int compIndex;
-  for(compIndex = 0; compIndex < this->gdsF.STR.size(); compIndex++){
-    if(!this->gdsF.STR[compIndex].name.compare("Components")){
-      break;
-    }
+  for(const auto &fillName: {"FillAll", "FillM4", "FillM6", "FillM2", "FillM1", "FillM3", "FillM5"}){
+    GDSfill.SREF.push_back(drawSREF(fillName, 0, 0));
   }
 
   /**
-   * Modifying the grid
+   * Find the index of the Components, Vias, Nets and Biases in STR vector
    */
 
-  for(const auto &comps: this->gdsF.STR[compIndex].SREF){
-
-    // cout << "N: " << comps.name << " " << comps.xCor << ", " << comps.yCor << endl;
-
-    int x_0 = (comps.xCor) - (fillCor[0] *1000) + (this->cellSizes[comps.name][0]);
-    int y_0 = (comps.yCor) - (fillCor[1] *1000) + (this->cellSizes[comps.name][1]);
-    int x_1 = (comps.xCor) - (fillCor[0] *1000) + (this->cellSizes[comps.name][2]);
-    int y_1 = (comps.yCor) - (fillCor[1] *1000) + (this->cellSizes[comps.name][3]);
-
-    // cout << "x_1, y_1; x_2, y_2: " << x_0 << ", " <<  y_0 << "; "<< x_1 << ", " <<  y_1 << endl;
-
-    x_0 = constrain(x_0 / 10000, 0, gridLX);
-    y_0 = constrain(y_0 / 10000, 0, gridLY);
-    x_1 = constrain(x_1 / 10000, 0, gridLX);
-    y_1 = constrain(y_1 / 10000, 0, gridLY);
-
-
-    for(unsigned int i = x_0; i < x_1; i++){
-      for(unsigned int j = y_0; j < y_1; j++){
-        this->grid[4][i][j] = false;
-        this->grid[6][i][j] = false;
-      }
-    }
+  unsigned int compIndex, viaIndex, netIndex, biasIndex;
+  compIndex = viaIndex = netIndex = biasIndex = this->gdsF.STR.size();
+  for(unsigned int i = 0; i < this->gdsF.STR.size(); i++){
+    const string &strName = this->gdsF.STR[i].name;
+    if(!strName.compare("Components") && compIndex == this->gdsF.STR.size()) compIndex = i;
+    else if(!strName.compare("Vias") && viaIndex == this->gdsF.STR.size()) viaIndex = i;
+    else if(!strName.compare("Nets") && netIndex == this->gdsF.STR.size()) netIndex = i;
+    else if(!strName.compare("Biases") && biasIndex == this->gdsF.STR.size()) biasIndex = i;
+  }
+  if(compIndex == this->gdsF.STR.size() || viaIndex == this->gdsF.STR.size() ||
+     netIndex == this->gdsF.STR.size() || biasIndex == this->gdsF.STR.size()){
+    cout << "Error: Components, Vias, Nets and Biases must be placed before the fill." << endl;
+    return 1;
   }
-
-  cout << "Filling M4 & M6, around gates, done." << endl;
-
-  /***************************************************************************
-   ******************************* Fill M2 ***********************************
-   ***************************************************************************/
-  /*
-   * Fill where there are no vias
-   */
-
-  cout << "Filling M2, around vias." << endl;
-
-  GDSfil[2].name = "FillM2";
-  GDSfill.SREF.push_back(drawSREF("FillM2", 0, 0));
 
   /**
-   * Getting the size of the VIA Structure
+   * Getting the size of the VIA Structure, before the threads start as it
+   * may still have to be loaded from its file
    */
 
-  int viaSize[4];
+  int viaSize[4] = {0, 0, 0, 0};
 
   for(unsigned int i = 0; i < this->gdsF.STR.size(); i++){
     if(!this->gdsF.STR[i].name.compare("ViaM1M3")){
@@ -335,283 +325,239 @@ int chipSmith::placeFill(){
   }
 
   /**
-   * Find the index of the Vias in STR vector
-   */
-
-  unsigned int viaIndex;
-  for(viaIndex = 0; viaIndex < this->gdsF.STR.size(); viaIndex++){
-    if(!this->gdsF.STR[viaIndex].name.compare("Vias")){
-      break;
-    }
-  }
-
-  /**
-   * Modifying the grid
+   * Block and plot the layer groups in parallel
    */
 
-  for(const auto &vias: this->gdsF.STR[viaIndex].SREF){
-    int x_0 = (vias.xCor) - (fillCor[0] *1000) + (viaSize[0]);
-    int y_0 = (vias.yCor) - (fillCor[1] *1000) + (viaSize[1]);
-    int x_1 = (vias.xCor) - (fillCor[0] *1000) + (viaSize[2]);
-    int y_1 = (vias.yCor) - (fillCor[1] *1000) + (viaSize[3]);
-
-    x_0 = constrain(round((float)x_0 / 10000), 0, gridLX);
-    y_0 = constrain(round((float)y_0 / 10000), 0, gridLY);
-    x_1 = constrain(round((float)x_1 / 10000), 0, gridLX);
-    y_1 = constrain(round((float)y_1 / 10000), 0, gridLY);
-
-    for(unsigned int i = x_0; i < x_1; i++){
-      for(unsigned int j = y_0; j < y_1; j++){
-        this->grid[2][i][j] = false;
+  struct fillJob{
+    string description;
+    vector<unsigned int> layers;
+    function<void()> block;
+    double ms = 0;
+  };
+
+  vector<fillJob> jobs = {
+    {"the whole circuit", {0}, [](){}},
+    {"M4 & M6, around gates", {4, 6}, [&](){ this->fillAroundGates(compIndex, {4, 6}); }},
+    {"M2, around vias", {2}, [&](){ this->fillAroundVias(viaIndex, viaSize); }},
+    {"M1 & M3, around tracks", {1, 3}, [&](){ this->fillAroundTracks(netIndex, {1, 3}, 0); }},
+    {"M5, around gates and biasing tracks", {5}, [&](){
+      this->fillAroundGates(compIndex, {5});
+      this->fillAroundTracks(biasIndex, {5}, 5);
+    }}
+  };
+
+  vector<thread> workers;
+  for(auto &job: jobs){
+    workers.emplace_back([&](){
+      auto start = chrono::steady_clock::now();
+      job.block();
+      for(const auto &layer: job.layers){
+        this->plotFill(layer, gdsFillName[layer], GDSfil[layer]);
       }
-    }
+      job.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    });
+  }
+  for(auto &worker: workers){
+    worker.join();
   }
 
-  cout << "Filling M2, around vias, done." << endl;
+  for(const auto &job: jobs){
+    cout << "Filling " << job.description << ", done (" << job.ms << " ms)." << endl;
+  }
 
-  /***************************************************************************
-   ********************************* M1 & M3 *********************************
-   ***************************************************************************/
-  /**
-   * Fill where there is no routing
-   */
+  gdsF.setSTR(GDSfill);
+  gdsF.setSTR(GDSfil);
 
-  cout << "Filling M1 & M3, around tracks." << endl;
+  cout << "Placing fill, done." << endl;
 
-  GDSfil[1].name = "FillM1";
-  GDSfil[3].name = "FillM3";
-  GDSfill.SREF.push_back(drawSREF("FillM1", 0, 0));
-  GDSfill.SREF.push_back(drawSREF("FillM3", 0, 0));
+  return 0;
+}
 
-  /**
-   * Find the index of the Nets in STR vector
-   */
+/**
+ * [chipSmith::fillAroundGates - Blocks the fill where there are cells]
+ * @param  compIndex [Index of the Components structure]
+ * @param  layers    [The grid layers that are blocked]
+ * @return           [0 - All good; 1 - Error]
+ */
 
-  unsigned int netIndex;
-  for(netIndex = 0; netIndex < this->gdsF.STR.size(); netIndex++){
-    if(!this->gdsF.STR[netIndex].name.compare("Nets")){
-      break;
-    }
-  }
+int chipSmith::fillAroundGates(unsigned int compIndex, const vector<unsigned int> &layers){
+  const gdsSREFcolumns &comps = this->gdsF.STR[compIndex].SREFcols;
 
-  /**
-   * Modifying the grid
-   */
+  for(size_t i = 0; i < comps.size(); i++){
 
-  for(const auto &path: this->gdsF.STR[netIndex].PATH){
+    // cout << "N: " << comps.name[i] << " " << comps.xCor[i] << ", " << comps.yCor[i] << endl;
 
-    for(unsigned int i = 0; i < path.xCor.size() -1; i++){
+    // Read only, this runs next to other layers
+    const vector<int> *size = this->cellSize(comps.name[i]);
+    if(size == nullptr) continue;
 
-      int x_0 = (path.xCor[i]) - (fillCor[0] *1000);
-      int y_0 = (path.yCor[i]) - (fillCor[1] *1000);
-      int x_1 = (path.xCor[i+1]) - (fillCor[0] *1000);
-      int y_1 = (path.yCor[i+1]) - (fillCor[1] *1000);
+    int x_0 = (comps.xCor[i]) - (fillCor[0] *1000) + ((*size)[0]);
+    int y_0 = (comps.yCor[i]) - (fillCor[1] *1000) + ((*size)[1]);
+    int x_1 = (comps.xCor[i]) - (fillCor[0] *1000) + ((*size)[2]);
+    int y_1 = (comps.yCor[i]) - (fillCor[1] *1000) + ((*size)[3]);
 
-      // cout << "[" << path.layer/10 << "]: " << x_0 << ", " <<  y_0 << "; "<< x_1 << ", " <<  y_1 << endl;
+    // cout << "x_1, y_1; x_2, y_2: " << x_0 << ", " <<  y_0 << "; "<< x_1 << ", " <<  y_1 << endl;
 
-      x_0 /= 10000;
-      y_0 /= 10000;
-      x_1 /= 10000;
-      y_1 /= 10000;
+    x_0 = constrain(x_0 / 10000, 0, gridLX);
+    y_0 = constrain(y_0 / 10000, 0, gridLY);
+    x_1 = constrain(x_1 / 10000, 0, gridLX);
+    y_1 = constrain(y_1 / 10000, 0, gridLY);
 
-      if(x_0 == x_1){
-        //vertical
+    for(const auto &layer: layers){
+      this->grid[layer].clearRect(x_0, y_0, x_1, y_1);
+    }
+  }
 
-        if((x_0 < 0) || (x_0 >= gridLX)){
-          continue;
-        }
-        else if((y_0 < 0 && y_1 < 0) || (y_0 >= gridLY && y_1 >= gridLY)){  // if route is off grid
-          continue;
-        }
+  return 0;
+}
 
-        y_0 = constrain(y_0, 0, gridLY-1);
-        y_1 = constrain(y_1, 0, gridLY-1);
+/**
+ * [chipSmith::fillAroundVias - Blocks the M2 fill where there are vias]
+ * @param  viaIndex [Index of the Vias structure]
+ * @param  viaSize  [Bounding box of the via]
+ * @return          [0 - All good; 1 - Error]
+ */
 
-        if(y_1 > y_0){
-          for(int j = y_0; j <= y_1; j++){
-            this->grid[path.layer/10][x_0][j] = false;
-          }
-        }
-        else{
-          for(int j = y_0; j >= y_1; j--){
-            this->grid[path.layer/10][x_0][j] = false;
-          }
-        }
-      }
-      else if(y_0 == y_1){
-        //horizontal
+int chipSmith::fillAroundVias(unsigned int viaIndex, const int viaSize[4]){
+  const gdsSREFcolumns &vias = this->gdsF.STR[viaIndex].SREFcols;
 
-        if((y_0 < 0) || (y_0 >= gridLY)){
-          continue;
-        }
-        else if((x_0 < 0 && x_1 < 0) || (x_0 >= gridLX && x_1 >= gridLX)){  // if route is off grid
-          continue;
-        }
+  for(size_t i = 0; i < vias.size(); i++){
+    int x_0 = (vias.xCor[i]) - (fillCor[0] *1000) + (viaSize[0]);
+    int y_0 = (vias.yCor[i]) - (fillCor[1] *1000) + (viaSize[1]);
+    int x_1 = (vias.xCor[i]) - (fillCor[0] *1000) + (viaSize[2]);
+    int y_1 = (vias.yCor[i]) - (fillCor[1] *1000) + (viaSize[3]);
 
-        x_0 = constrain(x_0, 0, gridLX-1);
-        x_1 = constrain(x_1, 0, gridLX-1);
+    x_0 = constrain(round((float)x_0 / 10000), 0, gridLX);
+    y_0 = constrain(round((float)y_0 / 10000), 0, gridLY);
+    x_1 = constrain(round((float)x_1 / 10000), 0, gridLX);
+    y_1 = constrain(round((float)y_1 / 10000), 0, gridLY);
 
-        if(x_1 > x_0){
-          for(int j = x_0; j <= x_1; j++){
-            this->grid[path.layer/10][j][y_0] = false;
-          }
-        }
-        else{
-          for(int j = x_0; j >= x_1; j--){
-            this->grid[path.layer/10][j][y_0] = false;
-          }
-        }
-      }
-      else{
-        cout << "Error: Non Manhattan routes..." << endl;
-      }
-    }
+    this->grid[2].clearRect(x_0, y_0, x_1, y_1);
   }
 
-  cout << "Filling M1 & M3, around tracks, done." << endl;
+  return 0;
+}
 
-  /***************************************************************************
-   ******************************* Fill others *******************************
-   ***************************************************************************/
+/**
+ * [chipSmith::fillAroundTracks - Blocks the fill where there are tracks]
+ * @param  pathIndex  [Index of the structure holding the tracks]
+ * @param  layers     [The grid layers this call may write to]
+ * @param  forceLayer [Grid layer for all the tracks; 0 - the layer of each
+ * track (GDS layer / 10)]
+ * @return            [0 - All good; 1 - Error]
+ */
 
-  cout << "Filling M5, around gates and biasing tracks." << endl;
+int chipSmith::fillAroundTracks(unsigned int pathIndex, const vector<unsigned int> &layers, unsigned int forceLayer){
+  const gdsPointArena &paths = this->gdsF.STR[pathIndex].PATHarena;
 
-  GDSfil[5].name = "FillM5";
-  GDSfill.SREF.push_back(drawSREF("FillM5", 0, 0));
+  for(size_t p = 0; p < paths.size(); p++){
 
-  /**
-   * Modifying the grid
-   */
+    unsigned int layer = forceLayer ? forceLayer : paths.layer[p]/10;
+    if(find(layers.begin(), layers.end(), layer) == layers.end()) continue;
 
-  for(const auto &comps: this->gdsF.STR[compIndex].SREF){
+    // Points of the track as x, y pairs
+    const int *corXY = paths.xy(p);
 
-    // cout << "N: " << comps.name << " " << comps.xCor << ", " << comps.yCor << endl;
+    for(size_t i = 0; i + 1 < paths.point_count(p); i++){
 
-    int x_0 = (comps.xCor) - (fillCor[0] *1000) + (this->cellSizes[comps.name][0]);
-    int y_0 = (comps.yCor) - (fillCor[1] *1000) + (this->cellSizes[comps.name][1]);
-    int x_1 = (comps.xCor) - (fillCor[0] *1000) + (this->cellSizes[comps.name][2]);
-    int y_1 = (comps.yCor) - (fillCor[1] *1000) + (this->cellSizes[comps.name][3]);
+      int x_0 = (corXY[i*2]) - (fillCor[0] *1000);
+      int y_0 = (corXY[i*2 + 1]) - (fillCor[1] *1000);
+      int x_1 = (corXY[i*2 + 2]) - (fillCor[0] *1000);
+      int y_1 = (corXY[i*2 + 3]) - (fillCor[1] *1000);
 
-    // cout << "x_1, y_1; x_2, y_2: " << x_0 << ", " <<  y_0 << "; "<< x_1 << ", " <<  y_1 << endl;
+      // cout << "[" << paths.layer[p]/10 << "]: " << x_0 << ", " <<  y_0 << "; "<< x_1 << ", " <<  y_1 << endl;
 
-    x_0 = constrain(x_0 / 10000, 0, gridLX);
-    y_0 = constrain(y_0 / 10000, 0, gridLY);
-    x_1 = constrain(x_1 / 10000, 0, gridLX);
-    y_1 = constrain(y_1 / 10000, 0, gridLY);
-
-    for(unsigned int i = x_0; i < x_1; i++){
-      for(unsigned int j = y_0; j < y_1; j++){
-        this->grid[5][i][j] = false;
+      // The full width of the track is blocked, not only its centerline
+      if(this->grid[layer].clearSegment(x_0, y_0, x_1, y_1, paths.width[p], paths.pathtype[p] == 2, 10000)){
+        cout << "Error: Non Manhattan routes..." << endl;
       }
     }
   }
 
-  /**
-   * Find the index of the Biases in STR vector
-   */
-
-  unsigned int biasIndex;
-  for(biasIndex = 0; biasIndex < this->gdsF.STR.size(); biasIndex++){
-    if(!this->gdsF.STR[biasIndex].name.compare("Biases")){
-      break;
-    }
-  }
-
-  /**
-   * Modifying the grid
-   */
+  return 0;
+}
 
-  for(const auto &path: this->gdsF.STR[biasIndex].PATH){
+/**
+ * [chipSmith::plotFill - Places the fill references of a grid layer]
+ * @param  layer    [The grid layer]
+ * @param  fillName [The fill structure that is referenced]
+ * @param  target   [The structure the references are added to]
+ * @return          [0 - All good; 1 - Error]
+ */
 
-    for(unsigned int i = 0; i < path.xCor.size() -1; i++){
+int chipSmith::plotFill(unsigned int layer, const string &fillName, gdsSTR &target){
+  if(this->fillArray){
+    return placeFillArray(this->grid[layer], gdsName(fillName), fillCor[0] * 1000, fillCor[1] * 1000, 10000, target);
+  }
 
-      int x_0 = (path.xCor[i]) - (fillCor[0] *1000);
-      int y_0 = (path.yCor[i]) - (fillCor[1] *1000);
-      int x_1 = (path.xCor[i+1]) - (fillCor[0] *1000);
-      int y_1 = (path.yCor[i+1]) - (fillCor[1] *1000);
+  const gdsName fillID(fillName);
+  const fillGrid &layerGrid = this->grid[layer];
+  target.SREFcols.reserve(layerGrid.count());
+  for(unsigned int x = 0; x < layerGrid.size(); x++){
+    for(unsigned int y = layerGrid.nextSet(x, 0); y < layerGrid.sizeOfRow(); y = layerGrid.nextSet(x, y + 1)){
+      target.SREFcols.push_back(fillID, (fillCor[0] * 1000) + (x*10000), (fillCor[1] * 1000) + (y*10000));
+    }
+  }
 
-      // cout << "[" << path.layer/10 << "]: " << x_0 << ", " <<  y_0 << "; "<< x_1 << ", " <<  y_1 << endl;
+  return 0;
+}
 
-      x_0 /= 10000;
-      y_0 /= 10000;
-      x_1 /= 10000;
-      y_1 /= 10000;
+/**
+ * [placeFillArray - Covers the free cells of a fill grid with rectangles and
+ * places each rectangle as a single AREF. Rectangles are grown greedily:
+ * first up the column, then to the right for as long as the whole run is
+ * free. Lone cells are still placed as SREFs.]
+ * @param  grid     [The fill grid of a layer]
+ * @param  fillName [The fill structure that is referenced]
+ * @param  originX  [Position of cell (0, 0) in database units]
+ * @param  originY  [Position of cell (0, 0) in database units]
+ * @param  pitch    [Size of a grid cell in database units]
+ * @param  target   [The structure the references are added to]
+ * @param  maxCnt   [Most columns or rows in an AREF]
+ * @return          [0 - All good; 1 - Error]
+ */
 
-      if(x_0 == x_1){
-        //vertical
+int placeFillArray(const fillGrid &grid, const gdsName &fillName, int originX, int originY,
+                   int pitch, gdsSTR &target, unsigned int maxCnt){
+  // Cells still free and not yet part of a rectangle
+  fillGrid freeGrid = grid;
 
-        if((x_0 < 0) || (x_0 >= gridLX)){
-          continue;
-        }
-        else if((y_0 < 0 && y_1 < 0) || (y_0 >= gridLY && y_1 >= gridLY)){  // if route is off grid
-          continue;
-        }
+  gdsAREF fillAREF;
+  fillAREF.name = fillName;
 
-        y_0 = constrain(y_0, 0, gridLY-1);
-        y_1 = constrain(y_1, 0, gridLY-1);
+  for(unsigned int x = 0; x < freeGrid.size(); x++){
+    for(unsigned int y = freeGrid.nextSet(x, 0); y < freeGrid.sizeOfRow(); y = freeGrid.nextSet(x, y)){
+      // Run up the column
+      unsigned int rows = min(freeGrid.nextClear(x, y) - y, maxCnt);
 
-        if(y_1 > y_0){
-          for(int j = y_0; j <= y_1; j++){
-            this->grid[5][x_0][j] = false;
-          }
-        }
-        else{
-          for(int j = y_0; j >= y_1; j--){
-            this->grid[5][x_0][j] = false;
-          }
-        }
+      // Extend right while the complete run is free
+      unsigned int cols = 1;
+      while(x + cols < freeGrid.size() && cols < maxCnt && freeGrid.allSet(x + cols, y, y + rows)){
+        cols++;
       }
-      else if(y_0 == y_1){
-        //horizontal
 
-        if((y_0 < 0) || (y_0 >= gridLY)){
-          continue;
-        }
-        else if((x_0 < 0 && x_1 < 0) || (x_0 >= gridLX && x_1 >= gridLX)){  // if route is off grid
-          continue;
-        }
+      freeGrid.clearRect(x, y, x + cols, y + rows);
 
-        x_0 = constrain(x_0, 0, gridLX-1);
-        x_1 = constrain(x_1, 0, gridLX-1);
+      int corX = originX + (x*pitch);
+      int corY = originY + (y*pitch);
 
-        if(x_1 > x_0){
-          for(int j = x_0; j <= x_1; j++){
-            this->grid[5][j][y_0] = false;
-          }
-        }
-        else{
-          for(int j = x_0; j >= x_1; j--){
-            this->grid[5][j][y_0] = false;
-          }
-        }
-      }
-      else{
-        cout << "Error: Non Manhattan routes..." << endl;
+      if(cols == 1 && rows == 1){
+        target.SREFcols.push_back(fillAREF.name, corX, corY);
+        continue;
       }
-    }
-  }
-
-  cout << "Filling M5, around gates and biasing tracks, done." << endl;
-
-  /***************************************************************************
-   ******************************* Plot Grid *********************************
-   ***************************************************************************/
 
-  for(unsigned int i = 0; i < grid.size(); i++){
-    for(unsigned int x = 0; x < grid[i].size(); x++){
-      for(unsigned int y = 0; y < grid[i][x].size(); y++){
-        if(this->grid[i][x][y] == true){
-          GDSfil[i].SREF.push_back(drawSREF(gdsFillName[i], (fillCor[0] * 1000) + (x*10000), (fillCor[1] * 1000) + (y*10000)));
-        }
-      }
+      fillAREF.colCnt = cols;
+      fillAREF.rowCnt = rows;
+      fillAREF.xCor = corX;
+      fillAREF.yCor = corY;
+      fillAREF.xCorRow = corX + cols*pitch; // Displacement over all the columns
+      fillAREF.yCorRow = corY;
+      fillAREF.xCorCol = corX;
+      fillAREF.yCorCol = corY + rows*pitch; // Displacement over all the rows
+      target.AREF.push_back(fillAREF);
     }
   }
 
-  gdsF.setSTR(GDSfill);
-  gdsF.setSTR(GDSfil);
-
-  cout << "Placing fill, done." << endl;
-
   return 0;
 }
 
@@ -630,6 +576,78 @@ int chipSmith::placeBias(){
     }
   }
 
+  const gdsSREFcolumns &comps = this->gdsF.STR[compIndex].SREFcols;
+
+  gdsSTR GDSbias;
+  GDSbias.name = "Biases";
+
+  // The main grid follows the special nets of the DEF file when asked to and
+  // it has them
+  spatialIndex tracks;
+  bool specialGrid = this->biasFromSpecialNets && !this->placeSpecialNets(GDSbias, tracks);
+  if(!specialGrid){
+    this->placeBiasGrid(comps, GDSbias);
+  }
+
+  const gdsName padName("PAD");
+  vector<int> corX;
+  vector<int> corY;
+  vector<unsigned int> found;
+  size_t stranded = 0;
+
+  /***************************************************************************
+   *********************** Connecting Gate to Main Grid **********************
+   ***************************************************************************/
+
+  for(size_t i = 0; i < comps.size(); i++){
+    if(comps.name[i] == padName){
+      continue;
+    }
+    corX.clear();
+    corY.clear();
+    corX.push_back(comps.xCor[i] + (this->GateBiasCorX[comps.name[i]] * 1000));
+    corX.push_back(comps.xCor[i] + (this->GateBiasCorX[comps.name[i]] * 1000));
+    corY.push_back(comps.yCor[i] + this->gateHeight + (gridSize * 500));
+    corY.push_back(comps.yCor[i] + this->gateHeight - (gridSize * 500));
+    drawPath(GDSbias.PATHarena, 50, this->PTLwidth, corX, corY);
+    // The connections are made for the rows of placeBiasGrid, special net
+    // tracks elsewhere leave them unconnected. Only a track on the layer of
+    // the connection joins it, there are no vias between them.
+    if(specialGrid){
+      tracks.queryBox(corX[0], corY[1], corX[0], corY[0], found);
+      bool joined = false;
+      for(const auto &itFound: found){
+        if(GDSbias.PATHarena.layer[tracks.item(itFound).index] == 50){
+          joined = true;
+          break;
+        }
+      }
+      if(!joined){
+        stranded++;
+      }
+    }
+  }
+  if(stranded > 0){
+    cout << "Warning: " << stranded << " gate bias connections do not reach a special net track." << endl;
+  }
+
+  this->gdsF.setSTR(GDSbias);
+
+  cout << "Routing biases, done." << endl;
+
+  return 0;
+}
+
+/**
+ * [chipSmith::placeBiasGrid - Creates the main bias grid, a track above every
+ * row of gates but the first and the last, closed by a column on either side
+ * of the gates]
+ * @param  comps   [The placed gates]
+ * @param  GDSbias [The grid is added to its PATHs]
+ * @return         [0 - All good; 1 - Error]
+ */
+
+int chipSmith::placeBiasGrid(const gdsSREFcolumns &comps, gdsSTR &GDSbias){
   /***************************************************************************
    ************************** Row Calculations *******************************
    ***************************************************************************/
@@ -638,8 +656,8 @@ int chipSmith::placeBias(){
 
   int setOffset = 5000 + (this->gateHeight);
 
-  for(const auto &itSTR: this->gdsF.STR[compIndex].SREF){
-    rowCor.insert(itSTR.yCor + setOffset);
+  for(const auto &corY: comps.yCor){
+    rowCor.insert(corY + setOffset);
   }
 
   set<int>::iterator setIt;
@@ -665,16 +683,23 @@ int chipSmith::placeBias(){
   int colCorMin = 10000000;
   int colCorMax = 0;
 
-  for(const auto &itSTR: this->gdsF.STR[compIndex].SREF){
-    if(!itSTR.name.compare("PAD")){
+  const gdsName padName("PAD");
+
+  for(size_t i = 0; i < comps.size(); i++){
+    if(comps.name[i] == padName){
+      continue;
+    }
+
+    const vector<int> *size = this->cellSize(comps.name[i]);
+    if(size == nullptr){
       continue;
     }
 
-    if(colCorMin > cellSizes[itSTR.name][0] + itSTR.xCor){
-      colCorMin = cellSizes[itSTR.name][0] + itSTR.xCor;
+    if(colCorMin > (*size)[0] + comps.xCor[i]){
+      colCorMin = (*size)[0] + comps.xCor[i];
     }
-    if(colCorMax < cellSizes[itSTR.name][2] + itSTR.xCor){
-      colCorMax = cellSizes[itSTR.name][2] + itSTR.xCor;
+    if(colCorMax < (*size)[2] + comps.xCor[i]){
+      colCorMax = (*size)[2] + comps.xCor[i];
     }
   }
 
@@ -688,10 +713,6 @@ int chipSmith::placeBias(){
    *************************** Building Main Grid ****************************
    ***************************************************************************/
 
-  gdsSTR GDSbias;
-
-  GDSbias.name = "Biases";
-  
   vector<int> corX;
   vector<int> corY;
 
@@ -701,7 +722,7 @@ int chipSmith::placeBias(){
   for(setIt = rowCor.begin(); setIt != rowCor.end(); setIt++){
     corY.push_back(*setIt);
     corY.push_back(*setIt);
-    GDSbias.PATH.push_back(drawPath(50, this->PTLwidth, corX, corY));
+    drawPath(GDSbias.PATHarena, 50, this->PTLwidth, corX, corY);
     corY.clear();
   }
 
@@ -714,33 +735,122 @@ int chipSmith::placeBias(){
   corX.push_back(colCorMin);
   corY.push_back(*setIt);
   corY.push_back(*setIt2);
-  GDSbias.PATH.push_back(drawPath(50, this->PTLwidth, corX, corY));
+  drawPath(GDSbias.PATHarena, 50, this->PTLwidth, corX, corY);
 
   corX.clear();
   corX.push_back(colCorMax);
   corX.push_back(colCorMax);
-  GDSbias.PATH.push_back(drawPath(50, this->PTLwidth, corX, corY));
+  drawPath(GDSbias.PATHarena, 50, this->PTLwidth, corX, corY);
 
-  /***************************************************************************
-   *********************** Connecting Gate to Main Grid **********************
-   ***************************************************************************/
+  return 0;
+}
 
-  for(const auto &itSTR: this->gdsF.STR[compIndex].SREF){
-    if(!itSTR.name.compare("PAD")){
-      continue;
+/**
+ * [chipSmith::placeSpecialNets - Creates the main bias grid from the wiring of
+ * the special nets in the DEF file. The wiring on the routing layers is moved
+ * to the bias layer, as placeBiasGrid draws it, so the gate connections join
+ * it and the M5 fill keeps clear of it. Tracks without a width get the PTL
+ * width, tracks on other layers are skipped.]
+ * @param  GDSbias [The grid is added to its PATHs]
+ * @param  tracks  [Receives every segment of the grid, built]
+ * @return         [0 - All good; 1 - The DEF file has no special wiring]
+ */
+
+int chipSmith::placeSpecialNets(gdsSTR &GDSbias, spatialIndex &tracks){
+  vector<int> corX;
+  vector<int> corY;
+  size_t trackCnt = 0;
+
+  for(const auto &itNet: this->defFile.snets){
+    for(const auto &itPath: itNet.routes){
+      if(itPath.ptX.size() < 2 || !routeLayer(itPath.LAYER)){
+        continue;
+      }
+
+      corX.clear();
+      corY.clear();
+      for(unsigned int i = 0; i < itPath.ptX.size(); i++){
+        corX.push_back(itPath.ptX[i] * 10);
+        corY.push_back(itPath.ptY[i] * 10);
+      }
+      unsigned int width = itPath.trackWidth ? itPath.trackWidth * 10 : this->PTLwidth;
+      drawPath(GDSbias.PATHarena, 50, width, corX, corY);
+      for(size_t i = 1; i < corX.size(); i++){
+        int half = width / 2;
+        tracks.insert(min(corX[i - 1], corX[i]) - half, min(corY[i - 1], corY[i]) - half,
+                      max(corX[i - 1], corX[i]) + half, max(corY[i - 1], corY[i]) + half,
+                      spatialIndex::bias, GDSbias.PATHarena.size() - 1);
+      }
+      trackCnt++;
     }
-    corX.clear();
-    corY.clear();
-    corX.push_back(itSTR.xCor + (this->GateBiasCorX[itSTR.name] * 1000));
-    corX.push_back(itSTR.xCor + (this->GateBiasCorX[itSTR.name] * 1000));
-    corY.push_back(itSTR.yCor + this->gateHeight + (gridSize * 500));
-    corY.push_back(itSTR.yCor + this->gateHeight - (gridSize * 500));
-    GDSbias.PATH.push_back(drawPath(50, this->PTLwidth, corX, corY));
   }
 
-  this->gdsF.setSTR(GDSbias);
+  if(trackCnt == 0) return 1;
+  tracks.build();
+  cout << "Biasing grid from " << trackCnt << " special net tracks." << endl;
+  return 0;
+}
 
-  cout << "Routing biases, done." << endl;
+/**
+ * [chipSmith::indexPlacement - Builds the spatial index over the placed gates,
+ * net tracks, vias and bias tracks. Tracks are indexed by the bounding box of
+ * the whole track, widened by half its width.]
+ * @return [0 - All good; 1 - Error]
+ */
+
+int chipSmith::indexPlacement(){
+  cout << "Indexing placement." << endl;
+
+  this->placed.clear();
+
+  int viaSize[4] = {0, 0, 0, 0};
+  for(unsigned int i = 0; i < this->gdsF.STR.size(); i++){
+    if(!this->gdsF.STR[i].name.compare("ViaM1M3")){
+      this->gdsF.calculate_STR_bounding_box(i, viaSize);
+      break;
+    }
+  }
+
+  for(const auto &str: this->gdsF.STR){
+    const string &strName = str.name;
+    if(!strName.compare("Components") || !strName.compare("Vias")){
+      bool isGate = !strName.compare("Components");
+      const gdsSREFcolumns &refs = str.SREFcols;
+      for(size_t i = 0; i < refs.size(); i++){
+        const int *size = viaSize;
+        if(isGate){
+          const vector<int> *cell = this->cellSize(refs.name[i]);
+          if(cell == nullptr) continue;
+          size = cell->data();
+        }
+        this->placed.insert(refs.xCor[i] + size[0], refs.yCor[i] + size[1],
+                            refs.xCor[i] + size[2], refs.yCor[i] + size[3],
+                            isGate ? spatialIndex::gate : spatialIndex::via, i);
+      }
+    }
+    else if(!strName.compare("Nets") || !strName.compare("Biases")){
+      unsigned int kind = !strName.compare("Nets") ? spatialIndex::net : spatialIndex::bias;
+      const gdsPointArena &paths = str.PATHarena;
+      for(size_t p = 0; p < paths.size(); p++){
+        if(paths.point_count(p) == 0) continue;
+        const int *corXY = paths.xy(p);
+        int box[4] = {corXY[0], corXY[1], corXY[0], corXY[1]};
+        for(size_t i = 1; i < paths.point_count(p); i++){
+          box[0] = min(box[0], corXY[i*2]);
+          box[1] = min(box[1], corXY[i*2 + 1]);
+          box[2] = max(box[2], corXY[i*2]);
+          box[3] = max(box[3], corXY[i*2 + 1]);
+        }
+        int halfWidth = paths.width[p] / 2;
+        this->placed.insert(box[0] - halfWidth, box[1] - halfWidth,
+                            box[2] + halfWidth, box[3] + halfWidth, kind, p);
+      }
+    }
+  }
+
+  this->placed.build();
+
+  cout << "Indexing placement, done (" << this->placed.size() << " items)." << endl;
 
   return 0;
 }
@@ -770,7 +880,7 @@ int chipSmith::importGates(){
     if(itName != this->gdsFileLoc.end()){
       cout << "Importing GDS: " << itName->second << endl;
       // gdsF.importGDSfile(itName->second);
-      gdsF.import(itName->second);
+      this->importGDS(itName->second);
     }
     else{
       // lef file import
@@ -837,6 +947,12 @@ int chipSmith::importGates(){
         }
 
         this->cellSizes.insert(pair<string, vector<int>>(this->lef2gdsNames[itGates], foo));
+
+        gdsName gateName(this->lef2gdsNames[itGates]);
+        if(gateName.id() >= this->cellSizeOf.size()){
+          this->cellSizeOf.resize(gateName.id() + 1);
+        }
+        this->cellSizeOf[gateName.id()] = foo;
         break;
       }
     }
@@ -866,13 +982,27 @@ int chipSmith::importFill(){
   for(itLoc = this->gdsFillFileLoc.begin(); itLoc != this->gdsFillFileLoc.end(); itLoc++){
     cout << "Importing GDS: " << itLoc->second << endl;
     // gdsF.importGDSfile(itLoc->second);
-    gdsF.import(itLoc->second);
+    this->importGDS(itLoc->second);
   }
 
   cout << "Defining fill structures, done." << endl;
   return 0;
 }
 
+/**
+ * [chipSmith::importGDS - Imports a cell or fill library on demand. With the
+ * cache enabled the bounding boxes of an unchanged library come from its
+ * snapshot, see importCachedGDS.]
+ * @param  fileName [The GDS file]
+ * @return          [0 - All good; 1 - Error]
+ */
+
+int chipSmith::importGDS(const string &fileName){
+  if(!this->cacheEnable) return this->gdsF.import_lazy(fileName);
+  // Gate and fill geometry is kept compact, see toGDS
+  return importCachedGDS(this->gdsF, fileName, true, this->cacheDir);
+}
+
 /**
  * [constrain - Limits the value to the limits]
  * @param  inVal      [The value that must be constrained/limited]
@@ -0,0 +1,247 @@
+/**
+ * Author:      Jude de Villiers
+ * Origin:      E&E Engineering - Stellenbosch University
+ * For:         Supertools, Coldflux Project - IARPA
+ * Created:     2020-04-21
+ * Modified:
+ * license:
+ * Description: Binary snapshots of parsed input files, kept next to them or
+ *              in a cache directory
+ * File:        dbCache.cpp
+ */
+
+#include "chipsmith/dbCache.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char cacheMagic[8] = {'C', 'S', 'C', 'A', 'C', 'H', 'E', '\n'};
+
+/**
+ * [cacheHeader - Start of every snapshot]
+ */
+struct cacheHeader{
+  char magic[8];
+  uint32_t version;
+  uint16_t byteOrder;   // 0x0102 as written by the machine that made it
+  uint16_t kind;
+  cacheKey key;         // Of the source file the snapshot was made from
+  uint64_t payloadSize;
+};
+
+/**
+ * [hashBytes - 64 bit hash of a buffer, eight bytes at a time]
+ */
+
+static uint64_t hashBytes(const char *data, size_t size){
+  uint64_t h = 0x9e3779b97f4a7c15ULL ^ size;
+  size_t i = 0;
+  for(; i + 8 <= size; i += 8){
+    uint64_t word;
+    memcpy(&word, data + i, 8);
+    h = (h ^ word) * 0x100000001b3ULL;
+    h ^= h >> 29;
+  }
+  for(; i < size; i++){
+    h = (h ^ (unsigned char)data[i]) * 0x100000001b3ULL;
+  }
+  h ^= h >> 32;
+  return h * 0xff51afd7ed558ccdULL;
+}
+
+/**
+ * [cacheFileName - Name of the snapshot kept for a source file. In a cache
+ * directory the name carries a hash of the source path, so files with the
+ * same name in different directories do not share a snapshot.]
+ * @param  sourceName [The source file]
+ * @param  cacheDir   [Directory of the snapshots; "" - Next to the source]
+ * @return            [Path of the snapshot]
+ */
+
+string cacheFileName(const string &sourceName, const string &cacheDir){
+  if(cacheDir.empty()) return sourceName + ".cache";
+  char pathHash[17];
+  snprintf(pathHash, sizeof(pathHash), "%016llx",
+           (unsigned long long)hashBytes(sourceName.data(), sourceName.size()));
+  const size_t slash = sourceName.find_last_of('/');
+  const string baseName = slash == string::npos ? sourceName : sourceName.substr(slash + 1);
+  return cacheDir + "/" + baseName + "." + pathHash + ".cache";
+}
+
+/**
+ * [cacheKeyOf - Finds the key of a source file]
+ * @param  sourceName [The source file]
+ * @param  key        [Receives the key]
+ * @param  withHash   [Also hash the contents, otherwise the hash is 0]
+ * @return            [0 - All good; 1 - Error]
+ */
+
+int cacheKeyOf(const string &sourceName, cacheKey &key, bool withHash){
+  struct stat fileStat;
+  if(stat(sourceName.c_str(), &fileStat) != 0) return 1;
+  key.size = fileStat.st_size;
+  key.mtime = (int64_t)fileStat.st_mtim.tv_sec * 1000000000 + fileStat.st_mtim.tv_nsec;
+  key.hash = 0;
+  if(withHash && key.size > 0){
+    gdsMap source;
+    if(source.open(sourceName)) return 1;
+    key.hash = hashBytes(source.begin(), source.size());
+  }
+  return 0;
+}
+
+/**
+ * [cacheWriter::put - Stores a string, its length followed by the characters]
+ */
+
+void cacheWriter::put(const string &str){
+  this->put((uint32_t)str.size());
+  this->buffer.insert(this->buffer.end(), str.begin(), str.end());
+}
+
+void cacheWriter::put(const vector<string> &vec){
+  this->put((uint32_t)vec.size());
+  for(const auto &foo: vec){
+    this->put(foo);
+  }
+}
+
+/**
+ * [cacheWriter::save - Writes the snapshot of a source file. It is written to
+ * a temporary file first and then renamed, so other runs never see half of it.]
+ * @param  sourceName [The file the snapshot was made from]
+ * @param  kind       [What the snapshot holds]
+ * @param  cacheDir   [Directory of the snapshots, made if needed; "" - Next to the source]
+ * @return            [0 - All good; 1 - Error]
+ */
+
+int cacheWriter::save(const string &sourceName, cacheKind kind, const string &cacheDir){
+  cacheHeader header;
+  memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+  header.version = cacheVersion;
+  header.byteOrder = 0x0102;
+  header.kind = kind;
+  header.payloadSize = this->buffer.size();
+  if(cacheKeyOf(sourceName, header.key, true)){
+    cout << "Could not read \"" << sourceName << "\" to cache it." << endl;
+    return 1;
+  }
+
+  if(!cacheDir.empty() && mkdir(cacheDir.c_str(), 0777) != 0 && errno != EEXIST){
+    cout << "Could not create cache directory \"" << cacheDir << "\"" << endl;
+    return 1;
+  }
+  const string cacheName = cacheFileName(sourceName, cacheDir);
+  const string tempName = cacheName + "." + to_string(getpid());
+  FILE *cacheFile = fopen(tempName.c_str(), "wb");
+  if(cacheFile == nullptr){
+    cout << "Could not create cache \"" << cacheName << "\"" << endl;
+    return 1;
+  }
+  bool written = fwrite(&header, sizeof(header), 1, cacheFile) == 1;
+  if(!this->buffer.empty()){
+    written = written && fwrite(this->buffer.data(), this->buffer.size(), 1, cacheFile) == 1;
+  }
+  written = (fclose(cacheFile) == 0) && written;
+
+  if(!written || rename(tempName.c_str(), cacheName.c_str()) != 0){
+    remove(tempName.c_str());
+    cout << "Could not create cache \"" << cacheName << "\"" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * [cacheReader::open - Maps the snapshot of a source file if it is still
+ * valid for the file]
+ * @param  sourceName [The file the snapshot was made from]
+ * @param  kind       [What the snapshot has to hold]
+ * @param  cacheDir   [Directory of the snapshots; "" - Next to the source]
+ * @return            [0 - Valid snapshot; 1 - None, stale or damaged]
+ */
+
+int cacheReader::open(const string &sourceName, cacheKind kind, const string &cacheDir){
+  this->close();
+
+  cacheKey key;
+  if(cacheKeyOf(sourceName, key, false)) return 1;
+  if(this->file.open(cacheFileName(sourceName, cacheDir))) return 1;
+
+  cacheHeader header;
+  if(this->file.size() < sizeof(header)){
+    this->close();
+    return 1;
+  }
+  memcpy(&header, this->file.begin(), sizeof(header));
+  if(memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) || header.version != cacheVersion ||
+     header.byteOrder != 0x0102 || header.kind != kind ||
+     header.payloadSize != this->file.size() - sizeof(header) || header.key.size != key.size){
+    this->close();
+    return 1;
+  }
+
+  // Touched but maybe not changed, compare the contents
+  if(header.key.mtime != key.mtime){
+    if(cacheKeyOf(sourceName, key, true) || header.key.hash != key.hash){
+      this->close();
+      return 1;
+    }
+  }
+
+  this->cur = this->file.begin() + sizeof(header);
+  this->end = this->file.begin() + this->file.size();
+  this->failed = false;
+  return 0;
+}
+
+/**
+ * [cacheReader::close - Releases the snapshot]
+ */
+
+void cacheReader::close(){
+  this->file.close();
+  this->cur = this->end = nullptr;
+  this->failed = true;
+}
+
+/**
+ * [cacheReader::take - Steps over the next bytes]
+ * @return [Start of the bytes; nullptr - Not that many bytes left]
+ */
+
+const char *cacheReader::take(size_t bytes){
+  if(this->failed || (size_t)(this->end - this->cur) < bytes){
+    this->failed = true;
+    return nullptr;
+  }
+  const char *foo = this->cur;
+  this->cur += bytes;
+  return foo;
+}
+
+void cacheReader::get(string &str){
+  uint32_t len = this->get<uint32_t>();
+  const char *bytes = this->take(len);
+  if(bytes != nullptr) str.assign(bytes, len);
+  else str.clear();
+}
+
+void cacheReader::get(vector<string> &vec){
+  vec.resize(this->count());
+  for(auto &foo: vec){
+    this->get(foo);
+  }
+}
+
+uint32_t cacheReader::count(){
+  uint32_t cnt = this->get<uint32_t>();
+  // Every element takes at least a byte, anything more is damage
+  if(cnt > (size_t)(this->end - this->cur)){
+    this->failed = true;
+    return 0;
+  }
+  return cnt;
+}
@@ -0,0 +1,195 @@
+/**
+ * Author:      Jude de Villiers
+ * Origin:      E&E Engineering - Stellenbosch University
+ * For:         Supertools, Coldflux Project - IARPA
+ * Created:     2020-04-21
+ * Modified:
+ * license:
+ * Description: Bit-packed occupancy grid of a single fill layer
+ * File:        fillGrid.cpp
+ */
+
+#include "chipsmith/fillGrid.hpp"
+#include <algorithm>
+
+/**
+ * [spanMask - Bits [lo, hi) of a word, with 0 <= lo < hi <= 64]
+ */
+
+static inline uint64_t spanMask(unsigned int lo, unsigned int hi){
+  uint64_t upper = (hi == 64) ? ~0ULL : ((1ULL << hi) - 1);
+  return upper & ~((1ULL << lo) - 1);
+}
+
+/**
+ * [floorDiv/ceilDiv - Integer division rounding down/up, also for negatives]
+ */
+
+static inline long long floorDiv(long long num, long long den){
+  return (num >= 0) ? num / den : -((-num + den - 1) / den);
+}
+
+static inline long long ceilDiv(long long num, long long den){
+  return -floorDiv(-num, den);
+}
+
+/**
+ * [fillGrid::reset - Sizes the grid and sets every cell to value]
+ * @param lx    [Cells in x]
+ * @param ly    [Cells in y]
+ * @param value [Initial state of every cell]
+ */
+
+void fillGrid::reset(unsigned int lx, unsigned int ly, bool value){
+  this->sizeX = lx;
+  this->sizeY = ly;
+  this->wordsPerRow = (ly + 63) / 64;
+  this->bits.assign((size_t)lx * this->wordsPerRow, value ? ~0ULL : 0);
+
+  // Keep the padding past the end of each row clear
+  if(value && (ly & 63)){
+    for(unsigned int x = 0; x < lx; x++){
+      row(x)[this->wordsPerRow - 1] = spanMask(0, ly & 63);
+    }
+  }
+}
+
+/**
+ * [fillGrid::clearRect - Clears the cells [x0, x1) x [y0, y1), clipped to the
+ * grid. 64 cells are cleared per word operation, the words of a row in
+ * between the two masked ends are zeroed as one block.]
+ */
+
+void fillGrid::clearRect(int x0, int y0, int x1, int y1){
+  if(x0 < 0) x0 = 0;
+  if(y0 < 0) y0 = 0;
+  if(x1 > (int)this->sizeX) x1 = this->sizeX;
+  if(y1 > (int)this->sizeY) y1 = this->sizeY;
+  if(x0 >= x1 || y0 >= y1) return;
+
+  unsigned int wFirst = y0 >> 6;
+  unsigned int wLast = (y1 - 1) >> 6;
+  uint64_t maskFirst = ~spanMask(y0 & 63, (wFirst == wLast) ? ((y1 - 1) & 63) + 1 : 64);
+  uint64_t maskLast = ~spanMask(0, ((y1 - 1) & 63) + 1);
+
+  for(int x = x0; x < x1; x++){
+    uint64_t *words = row(x);
+    words[wFirst] &= maskFirst;
+    if(wFirst == wLast) continue;
+    fill(words + wFirst + 1, words + wLast, 0);
+    words[wLast] &= maskLast;
+  }
+}
+
+/**
+ * [fillGrid::clearArea - Clears every cell that overlaps the area
+ * [x0, x1) x [y0, y1). The area is in database units relative to the grid
+ * origin, an area of zero width or height still clears the cells it lies in.]
+ * @param pitch [Size of a grid cell in database units]
+ */
+
+void fillGrid::clearArea(long long x0, long long y0, long long x1, long long y1, int pitch){
+  if(x1 == x0) x1 = x0 + 1;
+  if(y1 == y0) y1 = y0 + 1;
+
+  // Clip before narrowing to the int interface of clearRect
+  auto clip = [](long long val, long long limit){
+    return (int)(val < -1 ? -1 : (val > limit ? limit : val));
+  };
+  this->clearRect(clip(floorDiv(x0, pitch), this->sizeX),
+                  clip(floorDiv(y0, pitch), this->sizeY),
+                  clip(ceilDiv(x1, pitch), this->sizeX),
+                  clip(ceilDiv(y1, pitch), this->sizeY));
+}
+
+/**
+ * [fillGrid::clearSegment - Clears the cells covered by a Manhattan track
+ * segment of the given width, in database units relative to the grid origin]
+ * @param  width      [Width of the track]
+ * @param  extendEnds [Square ends, extended by half the width (path type 2)]
+ * @param  pitch      [Size of a grid cell in database units]
+ * @return            [0 - All good; 1 - Segment is not Manhattan]
+ */
+
+int fillGrid::clearSegment(int x0, int y0, int x1, int y1, unsigned int width, bool extendEnds, int pitch){
+  if(x0 != x1 && y0 != y1) return 1;
+
+  long long half = width / 2;
+  long long ext = extendEnds ? half : 0;
+
+  if(x0 == x1){
+    // vertical
+    this->clearArea((long long)x0 - half, (long long)min(y0, y1) - ext,
+                    (long long)x0 + half, (long long)max(y0, y1) + ext, pitch);
+  }
+  else{
+    // horizontal
+    this->clearArea((long long)min(x0, x1) - ext, (long long)y0 - half,
+                    (long long)max(x0, x1) + ext, (long long)y0 + half, pitch);
+  }
+  return 0;
+}
+
+/**
+ * [fillGrid::allSet - Checks if the cells [y0, y1) of row x are all set]
+ */
+
+bool fillGrid::allSet(unsigned int x, unsigned int y0, unsigned int y1) const {
+  return y0 >= y1 || this->nextClear(x, y0) >= y1;
+}
+
+/**
+ * [fillGrid::nextSet - Finds the first set cell in row x at or after y]
+ * @return [The y index of the cell; sizeY if there is none]
+ */
+
+unsigned int fillGrid::nextSet(unsigned int x, unsigned int y) const {
+  if(y >= this->sizeY) return this->sizeY;
+
+  const uint64_t *words = row(x);
+  unsigned int w = y >> 6;
+  uint64_t word = words[w];
+  if(y & 63) word &= ~spanMask(0, y & 63);
+
+  while(true){
+    if(word) return (w << 6) + __builtin_ctzll(word);
+    if(++w >= this->wordsPerRow) return this->sizeY;
+    word = words[w];
+  }
+}
+
+/**
+ * [fillGrid::nextClear - Finds the first clear cell in row x at or after y,
+ * the end of a run of set cells]
+ * @return [The y index of the cell; sizeY if there is none]
+ */
+
+unsigned int fillGrid::nextClear(unsigned int x, unsigned int y) const {
+  if(y >= this->sizeY) return this->sizeY;
+
+  const uint64_t *words = row(x);
+  unsigned int w = y >> 6;
+  uint64_t word = ~words[w];
+  if(y & 63) word &= ~spanMask(0, y & 63);
+
+  while(true){
+    if(word){
+      unsigned int found = (w << 6) + __builtin_ctzll(word);
+      return found < this->sizeY ? found : this->sizeY;
+    }
+    if(++w >= this->wordsPerRow) return this->sizeY;
+    word = ~words[w];
+  }
+}
+
+/**
+ * [fillGrid::count - Number of set cells]
+ */
+
+size_t fillGrid::count() const {
+  size_t total = 0;
+  for(const auto &word: this->bits){
+    total += __builtin_popcountll(word);
+  }
+  return total;
+}
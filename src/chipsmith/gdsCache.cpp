@@ -0,0 +1,179 @@
+/**
+ * Author:      Jude de Villiers
+ * Origin:      E&E Engineering - Stellenbosch University
+ * For:         Supertools, Coldflux Project - IARPA
+ * Created:     2020-04-21
+ * Modified:
+ * license:
+ * Description: Binary snapshots of the structure index of GDS cell libraries
+ * File:        gdsCache.cpp
+ */
+
+#include "chipsmith/gdsCache.hpp"
+#include <memory>
+#include <unordered_map>
+
+/**
+ * [gdsSnapshotSTR - What a snapshot keeps of a structure: where it starts in
+ * the GDS file, its bounding box and the names it references. The elements
+ * stay in the file until they are needed.]
+ */
+struct gdsSnapshotSTR{
+  string name;
+  uint64_t offset = 0;  // Of the BGNSTR record
+  unsigned int heirarchicalLevel = 0;
+  int boundingBox[4] = {0, 0, 0, 0};
+  vector<gdsName> references; // One per SREF/AREF
+};
+
+/**
+ * [referenceNames - Names of the SREFs and AREFs of a decoded structure, in
+ * the order gdscpp indexes them]
+ */
+
+static void referenceNames(const gdsSTR &str, vector<gdsName> &refs){
+  refs.clear();
+  for(const auto &foo: str.SREF){
+    refs.push_back(foo.name);
+  }
+  refs.insert(refs.end(), str.SREFcols.name.begin(), str.SREFcols.name.end());
+  for(const auto &foo: str.AREF){
+    refs.push_back(foo.name);
+  }
+}
+
+/**
+ * [writeSnapshot - Decodes a GDS library in a library of its own, resolves
+ * its bounding boxes and heirarchical levels and writes the snapshot. The
+ * decoded library is dropped again.]
+ * @param  fileName [The GDS file]
+ * @param  compact  [BOUNDARYs and PATHs in the arenas, kept in the snapshot]
+ * @param  cacheDir [Directory of the snapshot; "" - Next to the file]
+ * @return          [0 - All good; 1 - Error]
+ */
+
+static int writeSnapshot(const string &fileName, bool compact, const string &cacheDir){
+  gdscpp lib;
+  lib.set_compact_geometry(compact);
+  if(lib.import_lazy(fileName)) return 1;
+
+  // Decoding a structure forgets where it was in the file
+  vector<uint64_t> offsets;
+  offsets.reserve(lib.STR.size());
+  for(const auto &foo: lib.STR){
+    offsets.push_back(foo.lazy_offset);
+  }
+  bool boxesValid = !lib.resolve_heirarchy_and_bounding_boxes() &&
+                    lib.reference_graph().unresolved_names().empty();
+
+  // Referenced names are stored once, in a table ahead of the structures
+  vector<string> names;
+  unordered_map<uint32_t, uint32_t> nameIndex; // Name ID to table index
+  cacheWriter body;
+  vector<gdsName> refs;
+  vector<uint32_t> refIndex;
+  body.put((uint32_t)lib.STR.size());
+  for(size_t i = 0; i < lib.STR.size(); i++){
+    const gdsSTR &str = lib.STR[i];
+    body.put(str.name);
+    body.put(offsets[i]);
+    body.put(str.heirarchical_level);
+    body.put(str.bounding_box);
+    referenceNames(str, refs);
+    refIndex.clear();
+    for(const auto &foo: refs){
+      auto found = nameIndex.emplace(foo.id(), (uint32_t)names.size());
+      if(found.second) names.push_back(foo.str());
+      refIndex.push_back(found.first->second);
+    }
+    body.put(refIndex);
+  }
+
+  cacheWriter cache;
+  cache.put(compact);
+  cache.put(boxesValid);
+  cache.put(names);
+  cache.append(body);
+  return cache.save(fileName, cacheGDS, cacheDir);
+}
+
+/**
+ * [readSnapshot - Appends the structures of a GDS library to the target from
+ * its snapshot, still in the file. The boxes from the snapshot are kept only
+ * if all the structures were new to the target, a structure replaced by one
+ * of the same name could change the boxes above it.]
+ * @param  target   [The structures are appended to this library]
+ * @param  fileName [The GDS file]
+ * @param  compact  [BOUNDARYs and PATHs in the arenas]
+ * @param  cacheDir [Directory of the snapshot; "" - Next to the file]
+ * @return          [0 - All good; 1 - No valid snapshot, target unchanged]
+ */
+
+static int readSnapshot(gdscpp &target, const string &fileName, bool compact, const string &cacheDir){
+  cacheReader snapshot;
+  if(snapshot.open(fileName, cacheGDS, cacheDir) || snapshot.get<bool>() != compact) return 1;
+  const bool boxesValid = snapshot.get<bool>();
+  vector<string> nameTable;
+  snapshot.get(nameTable);
+  const vector<gdsName> names(nameTable.begin(), nameTable.end());
+
+  auto gdsFile = make_shared<gdsMap>();
+  if(gdsFile->open(fileName)) return 1;
+
+  vector<gdsSnapshotSTR> index(snapshot.count());
+  vector<uint32_t> refIndex;
+  for(auto &foo: index){
+    snapshot.get(foo.name);
+    foo.offset = snapshot.get<uint64_t>();
+    foo.heirarchicalLevel = snapshot.get<unsigned int>();
+    for(auto &bar: foo.boundingBox){
+      bar = snapshot.get<int>();
+    }
+    snapshot.get(refIndex);
+    for(const auto &bar: refIndex){
+      if(bar >= names.size()) return 1;
+      foo.references.push_back(names[bar]);
+    }
+    // Has to point at a BGNSTR record of the file
+    if(foo.offset + 4 > gdsFile->size()) return 1;
+    const unsigned char *record = (const unsigned char *)gdsFile->begin() + foo.offset;
+    if(record[2] != 0x05 || record[3] != 0x02) return 1;
+  }
+  if(!snapshot.ok()) return 1;
+
+  const size_t first = target.STR.size();
+  vector<gdsSTR> strs(index.size());
+  for(size_t i = 0; i < index.size(); i++){
+    strs[i].name = index[i].name;
+    strs[i].lazy_source = gdsFile;
+    strs[i].lazy_offset = index[i].offset;
+    strs[i].compact_geometry = compact;
+    strs[i].heirarchical_level = index[i].heirarchicalLevel;
+  }
+  target.push_back_STR(move(strs));
+  cout << "Imported GDS file \"" << fileName << "\" from its cache (on demand)." << endl;
+
+  if(!boxesValid || target.STR.size() - first != index.size()) return 0;
+  for(size_t i = 0; i < index.size(); i++){
+    target.restore_bounding_box(first + i, index[i].boundingBox, index[i].references);
+  }
+  return 0;
+}
+
+/**
+ * [importCachedGDS - Imports a GDS cell library on demand, like
+ * gdscpp::import_lazy, with the bounding boxes of its structures taken from
+ * its snapshot. The snapshot is made when there is none or the file changed.]
+ * @param  target   [The structures are appended to this library]
+ * @param  fileName [The GDS file]
+ * @param  compact  [BOUNDARYs and PATHs in the arenas, as target decodes them]
+ * @param  cacheDir [Directory of the snapshot; "" - Next to the file]
+ * @return          [0 - All good; 1 - Error]
+ */
+
+int importCachedGDS(gdscpp &target, const string &fileName, bool compact, const string &cacheDir){
+  if(!readSnapshot(target, fileName, compact, cacheDir)) return 0;
+  if(!writeSnapshot(fileName, compact, cacheDir) && !readSnapshot(target, fileName, compact, cacheDir)) return 0;
+  // No snapshot to be had, the boxes are calculated when needed
+  return target.import_lazy(fileName);
+}
@@ -10,6 +10,8 @@
  */
 
 #include "chipsmith/genFunc.hpp"
+#include <charconv>
+#include <cstring>
 
 
 /**
@@ -274,4 +276,94 @@ string fileExtensionRenamer(string inName, string suffix){
 	inName.erase(inName.find_last_of("."), inName.length());
 	foo = inName.insert(inName.length(), suffix);
 	return foo;
-}
\ No newline at end of file
+}
+
+/**
+ * [svToInt - Converts a token to an integer, like stoi]
+ * @param  inStr [The token]
+ * @return       [The value; 0 if the token is not a number]
+ */
+
+int svToInt(string_view inStr){
+	int value = 0;
+	if(!inStr.empty() && inStr.front() == '+') inStr.remove_prefix(1);
+	from_chars(inStr.data(), inStr.data() + inStr.size(), value);
+	return value;
+}
+
+/**
+ * [svToDouble - Converts a token to a double, like stod]
+ * @param  inStr [The token]
+ * @return       [The value; 0 if the token is not a number]
+ */
+
+double svToDouble(string_view inStr){
+	double value = 0;
+	if(!inStr.empty() && inStr.front() == '+') inStr.remove_prefix(1);
+	from_chars(inStr.data(), inStr.data() + inStr.size(), value);
+	return value;
+}
+
+/**
+ * [fileTokenizer::open - Maps the text file]
+ * @param  fileName [The file to be read]
+ * @return          [0 - All good; 1 - Error]
+ */
+
+int fileTokenizer::open(const string &fileName){
+	this->close();
+	if(this->file.open(fileName)) return 1;
+	this->cur = this->file.begin();
+	this->end = this->file.begin() + this->file.size();
+	return 0;
+}
+
+/**
+ * [fileTokenizer::open - Splits text that is owned by the caller]
+ * @param  text [The text, it has to outlive the tokens]
+ * @return      [0 - All good]
+ */
+
+int fileTokenizer::open(string_view text){
+	this->close();
+	this->cur = text.data();
+	this->end = text.data() + text.size();
+	return 0;
+}
+
+/**
+ * [fileTokenizer::close - Releases the file, all tokens become invalid]
+ */
+
+void fileTokenizer::close(){
+	this->file.close();
+	this->cur = this->end = nullptr;
+	this->tokens.clear();
+}
+
+/**
+ * [fileTokenizer::nextLine - Splits the next line that holds any tokens]
+ * @return [true - line() holds the tokens; false - End of the file]
+ */
+
+bool fileTokenizer::nextLine(){
+	this->tokens.clear();
+	while(this->cur < this->end){
+		const char *lineEnd = (const char *)memchr(this->cur, '\n', this->end - this->cur);
+		if(lineEnd == nullptr) lineEnd = this->end;
+		const char *pos = this->cur;
+		this->cur = lineEnd + 1;
+
+		if(pos == lineEnd || *pos == '#') continue; // skips commented and empty lines
+
+		while(pos < lineEnd){
+			while(pos < lineEnd && isspace((unsigned char)*pos)) pos++;
+			const char *tokStart = pos;
+			while(pos < lineEnd && !isspace((unsigned char)*pos)) pos++;
+			if(pos > tokStart) this->tokens.emplace_back(tokStart, pos - tokStart);
+		}
+		if(!this->tokens.empty()) return true;
+	}
+	this->cur = this->end;
+	return false;
+}
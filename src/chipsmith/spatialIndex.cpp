@@ -0,0 +1,153 @@
+/**
+ * Author:      Jude de Villiers
+ * Origin:      E&E Engineering - Stellenbosch University
+ * For:         Supertools, Coldflux Project - IARPA
+ * Created:     2020-04-21
+ * Modified:
+ * license:
+ * Description: Uniform bin grid over the bounding boxes of placed geometry
+ * File:        spatialIndex.cpp
+ */
+
+#include "chipsmith/spatialIndex.hpp"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+/**
+ * [spatialIndex::clear - Removes all the items and bins]
+ */
+
+void spatialIndex::clear(){
+  this->items.clear();
+  this->binStart.clear();
+  this->binItems.clear();
+  this->binsX = this->binsY = 0;
+}
+
+/**
+ * [spatialIndex::insert - Adds an item, the corners may be in any order.
+ * Items added after build() are only found once build() is called again.]
+ * @param kind  [spatialIndex::itemKind of the item]
+ * @param index [Element index of the item in its structure]
+ */
+
+void spatialIndex::insert(int x0, int y0, int x1, int y1, unsigned int kind, unsigned int index){
+  spatialItem foo;
+  foo.box[0] = min(x0, x1);
+  foo.box[1] = min(y0, y1);
+  foo.box[2] = max(x0, x1);
+  foo.box[3] = max(y0, y1);
+  foo.kind = kind;
+  foo.index = index;
+  this->items.push_back(foo);
+}
+
+/**
+ * [spatialIndex::binX/binY - Bin column/row of a coordinate, clamped]
+ */
+
+unsigned int spatialIndex::binX(long long x) const{
+  if(x <= this->originX) return 0;
+  return (unsigned int)min<long long>((x - this->originX) / this->binSize, this->binsX - 1);
+}
+
+unsigned int spatialIndex::binY(long long y) const{
+  if(y <= this->originY) return 0;
+  return (unsigned int)min<long long>((y - this->originY) / this->binSize, this->binsY - 1);
+}
+
+/**
+ * [spatialIndex::build - Bulk loads the bins. The bins are square and sized so
+ * that, if the items were spread evenly, each bin holds about itemsPerBin
+ * items.]
+ * @param itemsPerBin [Targeted number of items per bin]
+ */
+
+void spatialIndex::build(unsigned int itemsPerBin){
+  this->binStart.clear();
+  this->binItems.clear();
+  if(this->items.empty()){
+    this->binsX = this->binsY = 0;
+    return;
+  }
+
+  long long bounds[4] = {LLONG_MAX, LLONG_MAX, LLONG_MIN, LLONG_MIN};
+  for(const auto &it: this->items){
+    bounds[0] = min<long long>(bounds[0], it.box[0]);
+    bounds[1] = min<long long>(bounds[1], it.box[1]);
+    bounds[2] = max<long long>(bounds[2], it.box[2]);
+    bounds[3] = max<long long>(bounds[3], it.box[3]);
+  }
+  long long width = bounds[2] - bounds[0] + 1;
+  long long height = bounds[3] - bounds[1] + 1;
+
+  double area = (double)width * (double)height;
+  double bins = max(1.0, (double)this->items.size() / max(1u, itemsPerBin));
+  this->binSize = max(1LL, (long long)ceil(sqrt(area / bins)));
+  this->originX = bounds[0];
+  this->originY = bounds[1];
+  // Very flat extents would give far more bins than items, grow the bins
+  while((double)((width + this->binSize - 1) / this->binSize) *
+        (double)((height + this->binSize - 1) / this->binSize) > 4.0 * bins + 16){
+    this->binSize *= 2;
+  }
+  this->binsX = (unsigned int)((width + this->binSize - 1) / this->binSize);
+  this->binsY = (unsigned int)((height + this->binSize - 1) / this->binSize);
+
+  // Counting sort: count per bin, prefix sum, then place
+  this->binStart.assign((size_t)this->binsX * this->binsY + 1, 0);
+  for(const auto &it: this->items){
+    unsigned int bx0 = binX(it.box[0]), bx1 = binX(it.box[2]);
+    unsigned int by0 = binY(it.box[1]), by1 = binY(it.box[3]);
+    for(unsigned int bx = bx0; bx <= bx1; bx++){
+      for(unsigned int by = by0; by <= by1; by++){
+        this->binStart[(size_t)bx * this->binsY + by + 1]++;
+      }
+    }
+  }
+  for(size_t b = 1; b < this->binStart.size(); b++){
+    this->binStart[b] += this->binStart[b - 1];
+  }
+  this->binItems.resize(this->binStart.back());
+  vector<unsigned int> fill(this->binStart.begin(), this->binStart.end() - 1);
+  for(unsigned int i = 0; i < this->items.size(); i++){
+    const spatialItem &it = this->items[i];
+    unsigned int bx0 = binX(it.box[0]), bx1 = binX(it.box[2]);
+    unsigned int by0 = binY(it.box[1]), by1 = binY(it.box[3]);
+    for(unsigned int bx = bx0; bx <= bx1; bx++){
+      for(unsigned int by = by0; by <= by1; by++){
+        this->binItems[fill[(size_t)bx * this->binsY + by]++] = i;
+      }
+    }
+  }
+}
+
+/**
+ * [spatialIndex::queryBox - Finds the items that touch or overlap a box]
+ * @param  found [Receives the item indices, see item(); cleared first]
+ * @return       [Number of items found]
+ */
+
+size_t spatialIndex::queryBox(int x0, int y0, int x1, int y1, vector<unsigned int> &found) const{
+  found.clear();
+  if(!this->built()) return 0;
+  if(x0 > x1) swap(x0, x1);
+  if(y0 > y1) swap(y0, y1);
+
+  unsigned int bx0 = binX(x0), bx1 = binX(x1);
+  unsigned int by0 = binY(y0), by1 = binY(y1);
+  for(unsigned int bx = bx0; bx <= bx1; bx++){
+    for(unsigned int by = by0; by <= by1; by++){
+      size_t b = (size_t)bx * this->binsY + by;
+      for(unsigned int k = this->binStart[b]; k < this->binStart[b + 1]; k++){
+        const spatialItem &it = this->items[this->binItems[k]];
+        if(it.box[0] > x1 || it.box[2] < x0 || it.box[1] > y1 || it.box[3] < y0) continue;
+        // Report from the bin of the lower left corner of the overlap only
+        if(binX(max(it.box[0], x0)) != bx || binY(max(it.box[1], y0)) != by) continue;
+        found.push_back(this->binItems[k]);
+      }
+    }
+  }
+  return found.size();
+}
@@ -22,11 +22,9 @@ using namespace std;
  */
 int gdsToText(const std::string &fileName)
 {
-  ifstream gdsFile;
+  gdsMap gdsFile;
 
-  gdsFile.open(fileName, ios::in | ios::binary);
-
-  if (!gdsFile.is_open()) {
+  if (gdsFile.open(fileName)) {
     cout << "Error: GDS file \"" << fileName << "\" FAILED to be opened."
          << endl;
     return 1;
@@ -34,23 +32,18 @@ int gdsToText(const std::string &fileName)
 
   cout << "Converting \"" << fileName << "\" to ASCII." << endl;
 
-  char *readBlk;
-  uint32_t sizeBlk;
+  gdsReader gdsIn(gdsFile.begin(), gdsFile.size());
+  const char *readBlk;
   uint32_t hexKey;
 
-  gdsFile.seekg(0, ios::beg);
-
   do {
-    readBlk = new char[2];
-    gdsFile.read(readBlk, 2);
-
-    sizeBlk = (((unsigned char)readBlk[0] << 8) | (unsigned char)readBlk[1]);
-
-    gdsFile.seekg(-2, ios::cur);
-    readBlk = new char[sizeBlk];
-    gdsFile.read(readBlk, sizeBlk);
+    readBlk = gdsIn.next();
+    if (readBlk == nullptr) {
+      cout << "GDS read error" << endl;
+      break;
+    }
 
-    hexKey = ((readBlk[2] << 8) | readBlk[3]);
+    hexKey = gdsRecKey(readBlk);
 
     if (gdsRecordToText(readBlk)) {
       cout << "GDS read error" << endl;
@@ -58,9 +51,6 @@ int gdsToText(const std::string &fileName)
     }
   } while (hexKey != GDS_ENDLIB);
 
-  delete[] readBlk;
-
-  gdsFile.close();
   cout << "Converting \"" << fileName << "\" to ASCII done." << endl;
   return 0;
 }
@@ -70,7 +60,7 @@ int gdsToText(const std::string &fileName)
  * @param  recIn [The pointer in memory to the GDS record to be converted]
  * @return       [0 - Exit Success; 1 - Exit Failure]
  */
-int gdsRecordToText(char *recIn)
+int gdsRecordToText(const char *recIn)
 {
   uint32_t GDSKey;
   bitset<16> bitarr;
@@ -149,13 +139,15 @@ int gdsRecordToText(char *recIn)
 /**
  * [gdscpp::write - Creating a GDS file from STR class]
  * @param  fileName [The file name of the GDS file that is going to generated]
+ * @param  threads  [Serializing threads; 1 - serial; 0 - one per hardware
+ * thread]
  * @return          [0 - Exit Success; 1 - Exit Failure]
  */
-int gdscpp::write(const std::string &fileName)
+int gdscpp::write(const std::string &fileName, unsigned int threads)
 {
   gdsForge foo;
   foo.importGDSfile(this->GDSfileName);
-  return foo.gdsCreate(fileName, this->STR, this->units);
+  return foo.gdsCreate(fileName, this->STR, this->units, threads);
 }
 
 /**
@@ -164,6 +156,7 @@ int gdscpp::write(const std::string &fileName)
 void gdscpp::to_str()
 {
   cout << "GDScpp class:" << endl;
+  load_all_STR();
 
   for (unsigned int i = 0; i < this->STR.size(); i++) {
     this->STR[i].to_str();
@@ -199,14 +192,26 @@ void gdsSTR::to_str()
     this->SREF[i].to_str();
   }
 
+  for (unsigned int i = 0; i < this->SREFcols.size(); i++) {
+    this->SREFcols.expand(i).to_str();
+  }
+
   for (unsigned int i = 0; i < this->BOUNDARY.size(); i++) {
     this->BOUNDARY[i].to_str();
   }
 
+  for (unsigned int i = 0; i < this->BOUNDARYarena.size(); i++) {
+    this->BOUNDARYarena.boundary(i).to_str();
+  }
+
   for (unsigned int i = 0; i < this->PATH.size(); i++) {
     this->PATH[i].to_str();
   }
 
+  for (unsigned int i = 0; i < this->PATHarena.size(); i++) {
+    this->PATHarena.path(i).to_str();
+  }
+
   for (unsigned int i = 0; i < this->NODE.size(); i++) {
     this->NODE[i].to_str();
   }
@@ -216,6 +221,315 @@ void gdsSTR::to_str()
   }
 }
 
+/**
+ * [gdsOwner::changed - Tells the library that elements were added to the
+ * structure, nothing happens for a container outside a library]
+ * @param reference [Name of the structure an added reference points at]
+ */
+void gdsOwner::changed(const gdsName *reference) const
+{
+  if (library != nullptr)
+    library->STR_changed(index, reference);
+}
+
+/**
+ * [gdsElementReference - Name of the structure a reference points at, see
+ * gdsElements]
+ */
+const gdsName *gdsElementReference(const gdsSREF &element)
+{
+  return &element.name;
+}
+
+const gdsName *gdsElementReference(const gdsAREF &element)
+{
+  return &element.name;
+}
+
+/**
+ * [gdsSREFcolumns::clear - Removes all the references]
+ */
+void gdsSREFcolumns::clear()
+{
+  name.clear();
+  xCor.clear();
+  yCor.clear();
+  transform.clear();
+  owner.changed();
+}
+
+/**
+ * [gdsSREFcolumns::reserve - Makes room for count references]
+ */
+void gdsSREFcolumns::reserve(size_t count)
+{
+  name.reserve(count);
+  xCor.reserve(count);
+  yCor.reserve(count);
+  transform.reserve(count);
+}
+
+/**
+ * [gdsSREFcolumns::push_back - Adds a reference]
+ * @param STRname      [The name of the structure that is referenced]
+ * @param Xcor         [X coordinate]
+ * @param Ycor         [Y coordinate]
+ * @param quarterTurns [Counterclockwise rotation in steps of 90 degrees]
+ * @param mirror       [Reflected about the x-axis before the rotation]
+ */
+void gdsSREFcolumns::push_back(const gdsName &STRname, int Xcor, int Ycor,
+                               unsigned int quarterTurns, bool mirror)
+{
+  name.push_back(STRname);
+  xCor.push_back(Xcor);
+  yCor.push_back(Ycor);
+  transform.push_back((quarterTurns & 3) | (mirror ? 4 : 0));
+  owner.changed(&STRname);
+}
+
+/**
+ * [gdsSREFcolumns::fits - Checks if a reference can be stored compactly]
+ * @param  target_ref [The reference]
+ * @return            [true - No scaling, properties or odd angles]
+ */
+bool gdsSREFcolumns::fits(const gdsSREF &target_ref)
+{
+  return target_ref.scale == 1 && target_ref.plex == 0 &&
+         target_ref.propattr == 0 && target_ref.propvalue.empty() &&
+         target_ref.angle >= 0 && target_ref.angle < 360 &&
+         fmod(target_ref.angle, 90) == 0;
+}
+
+/**
+ * [gdsSREFcolumns::push_back - Adds a reference if it fits, see fits()]
+ * @param  target_ref [The reference]
+ * @return            [true - Added; false - Does not fit, nothing added]
+ */
+bool gdsSREFcolumns::push_back(const gdsSREF &target_ref)
+{
+  if (!fits(target_ref))
+    return false;
+  push_back(target_ref.name, target_ref.xCor, target_ref.yCor,
+            (unsigned int)(target_ref.angle / 90), target_ref.reflection);
+  return true;
+}
+
+/**
+ * [gdsSREFcolumns::expand - Returns the reference at index as a gdsSREF]
+ * @param  index [Index of the reference]
+ * @return       [The full reference]
+ */
+gdsSREF gdsSREFcolumns::expand(size_t index) const
+{
+  gdsSREF foo;
+  foo.name = name[index];
+  foo.xCor = xCor[index];
+  foo.yCor = yCor[index];
+  foo.angle = 90 * quarter_turns(index);
+  foo.reflection = reflection(index);
+  foo.orientation = transform[index];
+  return foo;
+}
+
+/**
+ * [gdsPointArena::clear - Removes all the elements]
+ */
+void gdsPointArena::clear()
+{
+  points.clear();
+  end.clear();
+  layer.clear();
+  dataType.clear();
+  pathtype.clear();
+  width.clear();
+  extra.clear();
+  owner.changed();
+}
+
+/**
+ * [gdsPointArena::reserve - Makes room for elements with point_count points
+ * in total]
+ */
+void gdsPointArena::reserve(size_t elements, size_t point_count)
+{
+  points.reserve(point_count * 2);
+  end.reserve(elements);
+  layer.reserve(elements);
+  dataType.reserve(elements);
+  pathtype.reserve(elements);
+  width.reserve(elements);
+}
+
+/**
+ * [gdsPointArena::find_extra - The seldom used attributes of an element]
+ * @param  index [Index of the element]
+ * @return       [The attributes; nullptr - All at their defaults]
+ */
+const gdsPointArena::extraAttr *gdsPointArena::find_extra(size_t index) const
+{
+  auto found = lower_bound(extra.begin(), extra.end(), index,
+                           [](const extraAttr &attr, size_t element) {
+                             return attr.element < element;
+                           });
+  if (found == extra.end() || found->element != index)
+    return nullptr;
+  return &*found;
+}
+
+int gdsPointArena::plex(size_t index) const
+{
+  const extraAttr *attr = find_extra(index);
+  return attr ? attr->plex : 0;
+}
+
+unsigned int gdsPointArena::propattr(size_t index) const
+{
+  const extraAttr *attr = find_extra(index);
+  return attr ? attr->propattr : 0;
+}
+
+const string &gdsPointArena::propvalue(size_t index) const
+{
+  static const string noValue = "\0";
+  const extraAttr *attr = find_extra(index);
+  return attr ? attr->propvalue : noValue;
+}
+
+/**
+ * [gdsPointArena::push_back - Adds an element, its points are copied into
+ * the shared buffer]
+ * @param layerNum   [The layer number]
+ * @param type       [The data type]
+ * @param path_type  [The path type, 0 for boundaries]
+ * @param path_width [The path width, 0 for boundaries]
+ * @param xCor       [The X-coordinates]
+ * @param yCor       [The Y-coordinates, same length as xCor]
+ */
+void gdsPointArena::push_back(unsigned int layerNum, unsigned int type,
+                              unsigned int path_type, unsigned int path_width,
+                              const vector<int> &xCor, const vector<int> &yCor)
+{
+  size_t cnt = min(xCor.size(), yCor.size());
+  size_t start = points.size();
+  points.resize(start + cnt * 2);
+  for (size_t i = 0; i < cnt; i++) {
+    points[start + i * 2] = xCor[i];
+    points[start + i * 2 + 1] = yCor[i];
+  }
+  end.push_back(points.size());
+  layer.push_back(layerNum);
+  dataType.push_back(type);
+  pathtype.push_back(path_type);
+  width.push_back(path_width);
+  owner.changed();
+}
+
+/**
+ * [gdsPointArena::push_back - Adds an element from interleaved coordinates]
+ * @param corXY [x_0, y_0, x_1, y_1, ...]
+ * @param cnt   [Number of points]
+ */
+void gdsPointArena::push_back(unsigned int layerNum, unsigned int type,
+                              unsigned int path_type, unsigned int path_width,
+                              const int *corXY, size_t cnt)
+{
+  points.insert(points.end(), corXY, corXY + cnt * 2);
+  end.push_back(points.size());
+  layer.push_back(layerNum);
+  dataType.push_back(type);
+  pathtype.push_back(path_type);
+  width.push_back(path_width);
+  owner.changed();
+}
+
+void gdsPointArena::push_back(const gdsBOUNDARY &target_boundary)
+{
+  push_back(target_boundary.layer, target_boundary.dataType, 0, 0,
+            target_boundary.xCor, target_boundary.yCor);
+  push_back_extra(target_boundary.plex, target_boundary.propattr,
+                  target_boundary.propvalue);
+}
+
+void gdsPointArena::push_back(const gdsPATH &target_path)
+{
+  push_back(target_path.layer, target_path.dataType, target_path.pathtype,
+            target_path.width, target_path.xCor, target_path.yCor);
+  push_back_extra(target_path.plex, target_path.propattr,
+                  target_path.propvalue);
+}
+
+/**
+ * [gdsPointArena::push_back_tail - Adds an element made of the points
+ * appended to the buffer since the last element, as the GDS decoder does.
+ * drop_tail discards such points when the element cannot be completed.]
+ * @param plex      [The PLEX value]
+ * @param propattr  [The property attribute]
+ * @param propvalue [The property value]
+ */
+void gdsPointArena::push_back_tail(unsigned int layerNum, unsigned int type,
+                                   unsigned int path_type,
+                                   unsigned int path_width, int plex,
+                                   unsigned int propattr,
+                                   const string &propvalue)
+{
+  end.push_back(points.size());
+  layer.push_back(layerNum);
+  dataType.push_back(type);
+  pathtype.push_back(path_type);
+  width.push_back(path_width);
+  push_back_extra(plex, propattr, propvalue);
+  owner.changed();
+}
+
+/**
+ * [gdsPointArena::push_back_extra - Keeps the seldom used attributes of the
+ * last element if any of them is set]
+ */
+void gdsPointArena::push_back_extra(int plex, unsigned int propattr,
+                                    const string &propvalue)
+{
+  if (plex != 0 || propattr != 0 || !propvalue.empty())
+    extra.push_back({size() - 1, plex, propattr, propvalue});
+}
+
+/**
+ * [gdsPointArena::boundary - Returns the element at index as a gdsBOUNDARY]
+ */
+gdsBOUNDARY gdsPointArena::boundary(size_t index) const
+{
+  gdsBOUNDARY foo;
+  foo.plex = plex(index);
+  foo.layer = layer[index];
+  foo.dataType = dataType[index];
+  for (size_t i = begin(index); i < end[index]; i += 2) {
+    foo.xCor.push_back(points[i]);
+    foo.yCor.push_back(points[i + 1]);
+  }
+  foo.propattr = propattr(index);
+  foo.propvalue = propvalue(index);
+  return foo;
+}
+
+/**
+ * [gdsPointArena::path - Returns the element at index as a gdsPATH]
+ */
+gdsPATH gdsPointArena::path(size_t index) const
+{
+  gdsPATH foo;
+  foo.plex = plex(index);
+  foo.layer = layer[index];
+  foo.dataType = dataType[index];
+  foo.pathtype = pathtype[index];
+  foo.width = width[index];
+  for (size_t i = begin(index); i < end[index]; i += 2) {
+    foo.xCor.push_back(points[i]);
+    foo.yCor.push_back(points[i + 1]);
+  }
+  foo.propattr = propattr(index);
+  foo.propvalue = propvalue(index);
+  return foo;
+}
+
 /**
  * [gdsSREF::to_str - Displays all the stored data in the class]
  */
@@ -302,10 +616,32 @@ void gdscpp::reset()
   units[0] = 0.001;
   units[1] = 1e-9;
   STR.clear();
+  STR_Lookup.clear();
+  STR_graph.clear();
+  STR_indexed.clear();
+  STR_bbox.clear();
   last_modified.clear();
   library_name = "Untitled_library";
 }
 
+/**
+ * [gdsSTR::set_owner - Sets the library and index of the structure on its
+ * element containers, see gdsOwner]
+ * @param lib   [The library; nullptr - Not in a library]
+ * @param index [Index of the structure in lib]
+ */
+void gdsSTR::set_owner(gdscpp *lib, unsigned int index)
+{
+  BOUNDARY.owner.set(lib, index);
+  BOUNDARYarena.owner.set(lib, index);
+  PATH.owner.set(lib, index);
+  PATHarena.owner.set(lib, index);
+  SREF.owner.set(lib, index);
+  SREFcols.owner.set(lib, index);
+  AREF.owner.set(lib, index);
+  BOX.owner.set(lib, index);
+}
+
 // Re-sets the specified STR object to its default values
 void gdsSTR::reset()
 {
@@ -314,12 +650,17 @@ void gdsSTR::reset()
   bounding_box[0] = {0};
   bounding_box[1] = {0};
   BOUNDARY.clear();
+  BOUNDARYarena.clear();
   PATH.clear();
+  PATHarena.clear();
   SREF.clear();
+  SREFcols.clear();
   AREF.clear();
   TEXT.clear();
   NODE.clear();
   BOX.clear();
+  lazy_source.reset();
+  lazy_offset = 0;
 }
 // Re-sets the specified BOUNDARY object to its default values
 void gdsBOUNDARY::reset()
@@ -357,6 +698,20 @@ void gdsSREF::reset()
   yCor = 0;
   propattr = 0;
   propvalue = "\0";
+  orientation = -1;
+}
+
+/**
+ * [gdsSREF::classify - Sets the orientation if the reference is one of the
+ * 8 Manhattan orientations, so later transforms need no trigonometry]
+ */
+void gdsSREF::classify()
+{
+  orientation = -1;
+  double quarter = angle / 90;
+  if (scale != 1 || quarter != floor(quarter) || fabs(quarter) > 1e9)
+    return;
+  orientation = (int)(((long long)quarter % 4 + 4) % 4) | (reflection ? 4 : 0);
 }
 
 // Re-sets the specified SREF object to its default values
@@ -426,7 +781,7 @@ void gdsBOX::reset()
 // Legacy.
 void gdscpp::setSTR(gdsSTR target_structure)
 {
-  this->push_back_STR(target_structure);
+  this->push_back_STR(std::move(target_structure));
 }
 
 // Legacy
@@ -438,17 +793,143 @@ void gdscpp::setSTR(vector<gdsSTR> target_structure)
 // Standard function for adding one structure onto the stack.
 void gdscpp::push_back_STR(gdsSTR target_structure)
 {
-  if (!STR_Lookup.count(target_structure.name)) // if doesn't already exist
+  sync_STR_nodes();
+  gdsName name(target_structure.name);
+  if (STR_graph.find(name) == gdsRefGraph::no_node) // if doesn't already exist
   {
-    STR.push_back(target_structure);
-    STR_Lookup.insert({target_structure.name, (STR.size() - 1)});
+    unsigned int index = STR.size();
+    STR.push_back(std::move(target_structure));
+    STR_Lookup.insert({STR.back().name, index});
+    STR_graph.add_node(name);
+    STR_indexed.push_back(false);
+    STR_bbox.emplace_back();
+    own_STR(index);
+    // References that were waiting on the name now reach the new structure
+    invalidate_bounding_box(index);
+    // Structures still in their file are indexed once they are needed
+    if (STR.back().is_loaded())
+      index_STR_references(index);
   }
 }
 
 // Overloaded function for appending multiple structures
 void gdscpp::push_back_STR(vector<gdsSTR> target_structure)
 {
-  STR.insert(STR.end(), target_structure.begin(), target_structure.end());
+  STR.reserve(STR.size() + target_structure.size());
+  for (auto &str_it : target_structure)
+    push_back_STR(std::move(str_it));
+}
+
+/**
+ * [gdscpp::index_STR_references - Adds the references of a structure to the
+ * reference graph, once. The structure is loaded if needed.]
+ * @param  index [Index of structure in gdscpp object]
+ */
+void gdscpp::index_STR_references(unsigned int index)
+{
+  if (STR_indexed[index])
+    return;
+  STR_indexed[index] = true;
+  load_STR(index);
+  for (const auto &sref_it : STR[index].SREF)
+    STR_graph.add_reference(index, sref_it.name);
+  for (const auto &sref_name : STR[index].SREFcols.name)
+    STR_graph.add_reference(index, sref_name);
+  for (const auto &aref_it : STR[index].AREF)
+    STR_graph.add_reference(index, aref_it.name);
+}
+
+/**
+ * [gdscpp::STR_index - Finds a structure by name, an array index once the
+ * name is interned]
+ * @param  name [Name of the structure]
+ * @return      [Index of structure in gdscpp object; -1 - No such structure]
+ */
+int gdscpp::STR_index(const gdsName &name)
+{
+  sync_STR_nodes();
+  unsigned int node = STR_graph.find(name);
+  return node == gdsRefGraph::no_node ? -1 : (int)node;
+}
+
+/**
+ * [gdscpp::sync_STR_nodes - Adds the structures that were placed directly in
+ * STR to the reference graph, their references are indexed later]
+ */
+void gdscpp::sync_STR_nodes()
+{
+  if (STR_graph.size() > STR.size()) {
+    STR_graph.clear();
+    STR_indexed.clear();
+    STR_bbox.clear();
+  }
+  unsigned int first = STR_graph.size();
+  for (unsigned int i = first; i < STR.size(); i++) {
+    STR_Lookup.insert({STR[i].name, i});
+    STR_graph.add_node(STR[i].name);
+    STR_indexed.push_back(false);
+    STR_bbox.emplace_back();
+    invalidate_bounding_box(i);
+  }
+  if (first < STR.size())
+    own_STR(first);
+}
+
+/**
+ * [gdscpp::own_STR - Points the structures from first on back at the
+ * library, so that adding elements to them marks their boxes as out of date.
+ * Copies lose their owner, so this runs again whenever STR may have copied
+ * the structures.]
+ * @param  first [Index of the first structure]
+ */
+void gdscpp::own_STR(unsigned int first)
+{
+  for (unsigned int i = first; i < STR.size(); i++)
+    STR[i].set_owner(this, i);
+}
+
+/**
+ * [gdscpp::STR_changed - Elements were added to a structure: a new reference
+ * joins the reference graph and the cached boxes of the structure and
+ * everything above it are marked as out of date]
+ * @param  index     [Index of structure in gdscpp object]
+ * @param  reference [Name of an added reference, nullptr for other elements]
+ */
+void gdscpp::STR_changed(unsigned int index, const gdsName *reference)
+{
+  if (index >= STR_bbox.size())
+    return;
+  // References of a structure not indexed yet are found when it is
+  if (reference != nullptr && STR_indexed[index])
+    STR_graph.add_late_reference(index, *reference);
+  invalidate_bounding_box(index);
+}
+
+/**
+ * [gdscpp::reference_graph - Brings the reference graph up to date with the
+ * structures and returns it. Structures added directly to STR are picked up
+ * here, changes to the references of structures already in the graph need
+ * gdscpp::rebuild_reference_graph.]
+ * @return [The reference graph, nodes have the same index as STR]
+ */
+const gdsRefGraph &gdscpp::reference_graph()
+{
+  sync_STR_nodes();
+  for (unsigned int i = 0; i < STR.size(); i++)
+    index_STR_references(i);
+  return STR_graph;
+}
+
+/**
+ * [gdscpp::rebuild_reference_graph - Indexes the references of all the
+ * structures again]
+ */
+void gdscpp::rebuild_reference_graph()
+{
+  STR_graph.clear();
+  STR_indexed.clear();
+  STR_bbox.clear(); // Cached boxes may depend on the old references
+  reference_graph();
 }
 
 /**
@@ -473,26 +954,7 @@ vector<unsigned int> gdscpp::findRootSTR()
 {
   cout << "Finding the root structures." << endl;
 
-  vector<unsigned int> rootSTRindexes;
-  bool vecFound;
-
-  for (unsigned int i = 0; i < this->STR.size(); i++) {
-    vecFound = false;
-    for (unsigned int j = 0; j < this->STR.size(); j++) {
-      for (unsigned int k = 0; k < this->STR[j].SREF.size(); k++) {
-        if (!this->STR[i].name.compare(this->STR[j].SREF[k].name)) {
-          vecFound = true;
-          break;
-        }
-      }
-      if (vecFound) {
-        break;
-      }
-    }
-    if (vecFound == false) {
-      rootSTRindexes.push_back(i);
-    }
-  }
+  vector<unsigned int> rootSTRindexes = reference_graph().roots();
 
   // display the root GDS STR
   cout << "Root GDS structures: ";
@@ -517,26 +979,7 @@ int gdscpp::genDot(const std::string &fileName)
 {
   cout << "Generating Dot file:\"" << fileName << "\" file" << endl;
 
-  vector<string> fromSTR;
-  vector<string> toSTR;
-
-  bool foundSTR;
-  for (int i = 0; i < this->STR.size(); i++) {
-    for (int j = 0; j < this->STR[i].SREF.size(); j++) {
-      foundSTR = true;
-      for (unsigned int k = 0; k < fromSTR.size(); k++) {
-        if (!fromSTR[k].compare(this->STR[i].name) &&
-            !toSTR[k].compare(this->STR[i].SREF[j].name)) {
-          foundSTR = false;
-          break;
-        }
-      }
-      if (foundSTR) {
-        fromSTR.push_back(this->STR[i].name);
-        toSTR.push_back(this->STR[i].SREF[j].name);
-      }
-    }
-  }
+  const gdsRefGraph &graph = reference_graph();
 
   // ------------------------ creating dot file ------------------------
 
@@ -548,9 +991,11 @@ int gdscpp::genDot(const std::string &fileName)
   lineStr = "digraph GDStree {\n";
   fputs(lineStr.c_str(), dotFile);
 
-  for (unsigned int i = 0; i < fromSTR.size(); i++) {
-    lineStr = "\t" + fromSTR[i] + " -> " + toSTR[i] + ";\n";
-    fputs(lineStr.c_str(), dotFile);
+  for (unsigned int i = 0; i < graph.size(); i++) {
+    for (const auto &child : graph.children(i)) {
+      lineStr = "\t" + STR[i].name + " -> " + STR[child].name + ";\n";
+      fputs(lineStr.c_str(), dotFile);
+    }
   }
 
   lineStr = "}";
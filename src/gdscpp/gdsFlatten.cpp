@@ -0,0 +1,488 @@
+/**
+ * Author:      J.F. de Villiers & H.F. Herbst
+ * Origin:  		E&E Engineering - Stellenbosch University
+ * For:					Supertools, Coldflux Project - IARPA
+ * Created: 		2019-10-14
+ * Modified:
+ * license:     MIT License
+ * Description: Flattens a structure hierarchy into polygons on the top level.
+ * File:				gdsFlatten.cpp
+ */
+
+// ========================= Includes =========================
+#include "gdscpp/gdsCpp.hpp"
+#include <condition_variable>
+#include <mutex>
+// ====================== Miscellanious =======================
+using namespace std;
+
+// ====================== Function Code =======================
+/**
+ * [gdsTransform::gdsTransform - Transform of a reference placed at (x, y)]
+ * @param x          [X-coordinate of the reference]
+ * @param y          [Y-coordinate of the reference]
+ * @param angle      [Counterclockwise rotation in degrees]
+ * @param scale      [Magnification]
+ * @param reflection [Reflect about the x-axis before rotating]
+ */
+gdsTransform::gdsTransform(int x, int y, double angle, double scale,
+                           bool reflection)
+{
+  double c, s;
+  double quarter = angle / 90;
+  if (quarter == floor(quarter) && fabs(quarter) < 1e9) {
+    // Exact for multiples of 90 degrees
+    static const int cos_q[4] = {1, 0, -1, 0};
+    static const int sin_q[4] = {0, 1, 0, -1};
+    int q = (int)(((long long)quarter % 4 + 4) % 4);
+    c = cos_q[q];
+    s = sin_q[q];
+  } else {
+    c = cos(angle * M_PI / 180);
+    s = sin(angle * M_PI / 180);
+  }
+  double f = reflection ? -1 : 1;
+  m[0] = scale * c;
+  m[1] = -scale * f * s;
+  m[2] = scale * s;
+  m[3] = scale * f * c;
+  m[4] = x;
+  m[5] = y;
+  update();
+}
+
+/**
+ * [gdsTransform::manhattan - Transform of a reference in one of the 8
+ * Manhattan orientations, built from a table without any trigonometry]
+ * @param x           [X-coordinate of the reference]
+ * @param y           [Y-coordinate of the reference]
+ * @param orientation [Bits 0-1 quarter turns, bit 2 reflection]
+ * @return            [The integral transform]
+ */
+gdsTransform gdsTransform::manhattan(int x, int y, unsigned int orientation)
+{
+  // xx, xy, yx, yy of the quarter turns; reflection negates the y column
+  static const int turn[4][4] = {
+      {1, 0, 0, 1}, {0, -1, 1, 0}, {-1, 0, 0, -1}, {0, 1, -1, 0}};
+  const int *r = turn[orientation & 3];
+  int f = (orientation & 4) ? -1 : 1;
+  gdsTransform out;
+  int entries[6] = {r[0], r[1] * f, r[2], r[3] * f, x, y};
+  for (int i = 0; i < 6; i++) {
+    out.m[i] = entries[i];
+    out.im[i] = entries[i];
+  }
+  out.is_integral = true;
+  return out;
+}
+
+/**
+ * [gdsTransform::update - Refreshes the integer copy of the matrix]
+ */
+void gdsTransform::update()
+{
+  is_integral = true;
+  for (int i = 0; i < 6; i++) {
+    if (m[i] != floor(m[i]) || fabs(m[i]) > 2147483647.0)
+      is_integral = false;
+    else
+      im[i] = (long long)m[i];
+  }
+}
+
+/**
+ * [gdsTransform::operator* - Composes two transforms]
+ * @param  inner [Transform applied first, e.g. that of a child reference]
+ * @return       [The inner transform followed by this one]
+ */
+gdsTransform gdsTransform::operator*(const gdsTransform &inner) const
+{
+  gdsTransform out;
+  out.m[0] = m[0] * inner.m[0] + m[1] * inner.m[2];
+  out.m[1] = m[0] * inner.m[1] + m[1] * inner.m[3];
+  out.m[2] = m[2] * inner.m[0] + m[3] * inner.m[2];
+  out.m[3] = m[2] * inner.m[1] + m[3] * inner.m[3];
+  out.m[4] = m[0] * inner.m[4] + m[1] * inner.m[5] + m[4];
+  out.m[5] = m[2] * inner.m[4] + m[3] * inner.m[5] + m[5];
+  out.update();
+  return out;
+}
+
+/**
+ * [gdsTransform::apply - Transforms cnt interleaved points]
+ * @param inXY  [The points x0, y0, x1, y1, ...]
+ * @param outXY [Receives the transformed points, may be inXY]
+ * @param cnt   [Number of points]
+ */
+void gdsTransform::apply(const int *inXY, int *outXY, size_t cnt) const
+{
+  if (is_integral) {
+    for (size_t i = 0; i < 2 * cnt; i += 2) {
+      long long x = inXY[i], y = inXY[i + 1];
+      outXY[i] = (int)(im[0] * x + im[1] * y + im[4]);
+      outXY[i + 1] = (int)(im[2] * x + im[3] * y + im[5]);
+    }
+    return;
+  }
+  for (size_t i = 0; i < 2 * cnt; i += 2) {
+    double x = inXY[i], y = inXY[i + 1];
+    outXY[i] = (int)llround(m[0] * x + m[1] * y + m[4]);
+    outXY[i + 1] = (int)llround(m[2] * x + m[3] * y + m[5]);
+  }
+}
+
+/**
+ * [gdsTransform::magnification - Scale factor of lengths, used for widths]
+ */
+double gdsTransform::magnification() const
+{
+  return sqrt(fabs(m[0] * m[3] - m[1] * m[2]));
+}
+
+/**
+ * [gdsFlatSTR::gdsFlatSTR - Collects only the polygons on the given layers]
+ * @param target [Structure receiving the polygons]
+ * @param layers [The layers to be kept]
+ */
+gdsFlatSTR::gdsFlatSTR(gdsSTR &target, const vector<unsigned int> &layers)
+    : dest(target)
+{
+  for (auto layer : layers) {
+    if (layer >= layer_mask.size())
+      layer_mask.resize(layer + 1, false);
+    layer_mask[layer] = true;
+  }
+}
+
+bool gdsFlatSTR::wants_layer(unsigned int layer)
+{
+  return layer_mask.empty() ||
+         (layer < layer_mask.size() && layer_mask[layer]);
+}
+
+void gdsFlatSTR::onBoundary(unsigned int layer, unsigned int dataType,
+                            const int *corXY, size_t cnt)
+{
+  dest.BOUNDARYarena.push_back(layer, dataType, 0, 0, corXY, cnt);
+}
+
+void gdsFlatSTR::onPath(unsigned int layer, unsigned int dataType,
+                        unsigned int pathtype, unsigned int width,
+                        const int *corXY, size_t cnt)
+{
+  dest.PATHarena.push_back(layer, dataType, pathtype, width, corXY, cnt);
+}
+
+/*
+ * [flatBuffer - Keeps the output of a worker in emission order until it can be
+ * handed to the sink of the caller]
+ */
+class flatBuffer : public gdsFlatSink
+{
+public:
+  const vector<bool> *keep = nullptr; // Layer answers of the real sink
+  gdsPointArena polygons;
+  vector<bool> is_path;
+
+  bool wants_layer(unsigned int layer) override
+  {
+    return layer < keep->size() && (*keep)[layer];
+  };
+  void onBoundary(unsigned int layer, unsigned int dataType,
+                  const int *corXY, size_t cnt) override
+  {
+    polygons.push_back(layer, dataType, 0, 0, corXY, cnt);
+    is_path.push_back(false);
+  };
+  void onPath(unsigned int layer, unsigned int dataType,
+              unsigned int pathtype, unsigned int width, const int *corXY,
+              size_t cnt) override
+  {
+    polygons.push_back(layer, dataType, pathtype, width, corXY, cnt);
+    is_path.push_back(true);
+  };
+  void replay(gdsFlatSink &sink) const
+  {
+    for (size_t i = 0; i < polygons.size(); i++) {
+      if (is_path[i])
+        sink.onPath(polygons.layer[i], polygons.dataType[i],
+                    polygons.pathtype[i], polygons.width[i], polygons.xy(i),
+                    polygons.point_count(i));
+      else
+        sink.onBoundary(polygons.layer[i], polygons.dataType[i],
+                        polygons.xy(i), polygons.point_count(i));
+    }
+  };
+};
+
+/*
+ * [flatWalker - Depth first walk over the references of a structure, emitting
+ * every polygon with the transform composed along the way.]
+ */
+class flatWalker
+{
+public:
+  const vector<gdsSTR> &STR;
+  const gdsRefGraph &graph;
+  gdsFlatSink &sink;
+  vector<int> in, out; // Scratch point buffers
+
+  flatWalker(const vector<gdsSTR> &str, const gdsRefGraph &g, gdsFlatSink &s)
+      : STR(str), graph(g), sink(s){};
+
+  void geometry(const gdsSTR &str, const gdsTransform &t);
+  void reference(const gdsSTR &str, size_t i, const gdsTransform &t);
+  void aref(const gdsAREF &aref, const gdsTransform &t);
+  void walk(unsigned int index, const gdsTransform &t)
+  {
+    const gdsSTR &str = STR[index];
+    geometry(str, t);
+    size_t refCnt = str.SREF.size() + str.SREFcols.size() + str.AREF.size();
+    for (size_t i = 0; i < refCnt; i++)
+      reference(str, i, t);
+  };
+  void walk(const gdsName &name, const gdsTransform &t)
+  {
+    unsigned int child = graph.find(name);
+    if (child != gdsRefGraph::no_node)
+      walk(child, t);
+  };
+
+private:
+  const int *place(const gdsTransform &t, const int *xy, size_t cnt)
+  {
+    out.resize(2 * cnt);
+    t.apply(xy, out.data(), cnt);
+    return out.data();
+  };
+  const int *place(const gdsTransform &t, const vector<int> &xCor,
+                   const vector<int> &yCor)
+  {
+    size_t cnt = min(xCor.size(), yCor.size());
+    in.resize(2 * cnt);
+    for (size_t i = 0; i < cnt; i++) {
+      in[2 * i] = xCor[i];
+      in[2 * i + 1] = yCor[i];
+    }
+    return place(t, in.data(), cnt);
+  };
+};
+
+/**
+ * [flatWalker::geometry - Emits the BOUNDARYs and PATHs of a structure]
+ */
+void flatWalker::geometry(const gdsSTR &str, const gdsTransform &t)
+{
+  double mag = t.magnification();
+  for (const auto &b : str.BOUNDARY) {
+    if (!sink.wants_layer(b.layer))
+      continue;
+    const int *xy = place(t, b.xCor, b.yCor);
+    sink.onBoundary(b.layer, b.dataType, xy, out.size() / 2);
+  }
+  const gdsPointArena &ba = str.BOUNDARYarena;
+  for (size_t i = 0; i < ba.size(); i++) {
+    if (!sink.wants_layer(ba.layer[i]))
+      continue;
+    size_t cnt = ba.point_count(i);
+    sink.onBoundary(ba.layer[i], ba.dataType[i], place(t, ba.xy(i), cnt), cnt);
+  }
+  for (const auto &p : str.PATH) {
+    if (!sink.wants_layer(p.layer))
+      continue;
+    const int *xy = place(t, p.xCor, p.yCor);
+    sink.onPath(p.layer, p.dataType, p.pathtype,
+                (unsigned int)llround(p.width * mag), xy, out.size() / 2);
+  }
+  const gdsPointArena &pa = str.PATHarena;
+  for (size_t i = 0; i < pa.size(); i++) {
+    if (!sink.wants_layer(pa.layer[i]))
+      continue;
+    size_t cnt = pa.point_count(i);
+    sink.onPath(pa.layer[i], pa.dataType[i], pa.pathtype[i],
+                (unsigned int)llround(pa.width[i] * mag),
+                place(t, pa.xy(i), cnt), cnt);
+  }
+}
+
+/**
+ * [flatWalker::reference - Walks reference i of a structure, counting its
+ * SREFs first, then its compact SREFs and then its AREFs]
+ */
+void flatWalker::reference(const gdsSTR &str, size_t i, const gdsTransform &t)
+{
+  if (i < str.SREF.size()) {
+    const gdsSREF &s = str.SREF[i];
+    if (s.orientation >= 0)
+      walk(s.name, t * gdsTransform::manhattan(s.xCor, s.yCor, s.orientation));
+    else
+      walk(s.name, t * gdsTransform(s.xCor, s.yCor, s.angle, s.scale,
+                                    s.reflection));
+    return;
+  }
+  i -= str.SREF.size();
+  const gdsSREFcolumns &cols = str.SREFcols;
+  if (i < cols.size()) {
+    walk(cols.name[i], t * gdsTransform::manhattan(cols.xCor[i], cols.yCor[i],
+                                                   cols.transform[i]));
+    return;
+  }
+  aref(str.AREF[i - cols.size()], t);
+}
+
+/**
+ * [flatWalker::aref - Walks every instance of an array reference. The
+ * column and row displacements are already in the coordinates of the parent.]
+ */
+void flatWalker::aref(const gdsAREF &a, const gdsTransform &t)
+{
+  unsigned int child = graph.find(a.name);
+  if (child == gdsRefGraph::no_node || a.colCnt <= 0 || a.rowCnt <= 0)
+    return;
+  double colX = (double)(a.xCorRow - a.xCor) / a.colCnt;
+  double colY = (double)(a.yCorRow - a.yCor) / a.colCnt;
+  double rowX = (double)(a.xCorCol - a.xCor) / a.rowCnt;
+  double rowY = (double)(a.yCorCol - a.yCor) / a.rowCnt;
+  for (int r = 0; r < a.rowCnt; r++) {
+    for (int c = 0; c < a.colCnt; c++) {
+      int x = (int)llround(a.xCor + c * colX + r * rowX);
+      int y = (int)llround(a.yCor + c * colY + r * rowY);
+      walk(child, t * gdsTransform(x, y, a.angle, a.scale, a.reflection));
+    }
+  }
+}
+
+/**
+ * [reaches_cycle - True if a circular reference can be reached from node]
+ * @param state [0 - unvisited; 1 - on the current path; 2 - done]
+ */
+static bool reaches_cycle(const gdsRefGraph &graph, unsigned int node,
+                          vector<char> &state)
+{
+  if (state[node] == 2)
+    return false;
+  if (state[node] == 1)
+    return true;
+  state[node] = 1;
+  for (auto child : graph.children(node)) {
+    if (reaches_cycle(graph, child, state))
+      return true;
+  }
+  state[node] = 2;
+  return false;
+}
+
+/**
+ * [gdscpp::flatten - Flattens a structure and everything it references,
+ * handing every polygon to the sink with its placement on the top level.
+ * The geometry of the root comes first, then that of its references in the
+ * order they are stored. The top level references are shared out in groups
+ * to the worker threads, the results are handed to the sink in order so the
+ * output does not depend on the number of threads.]
+ * @param  root    [Index of the structure in STR]
+ * @param  sink    [Receives the polygons]
+ * @param  threads [Number of worker threads; 0 - one per hardware thread]
+ * @return         [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdscpp::flatten(unsigned int root, gdsFlatSink &sink, unsigned int threads)
+{
+  if (root >= STR.size()) {
+    cout << "Error: Cannot flatten structure " << root << ", the library has "
+         << STR.size() << " structures." << endl;
+    return EXIT_FAILURE;
+  }
+  load_all_STR();
+  const gdsRefGraph &graph = reference_graph();
+  vector<char> state(graph.size(), 0);
+  if (reaches_cycle(graph, root, state)) {
+    cout << "Error: Structure \"" << STR[root].name
+         << "\" contains circular references and cannot be flattened."
+         << endl;
+    return EXIT_FAILURE;
+  }
+
+  const gdsSTR &top = STR[root];
+  size_t refCnt = top.SREF.size() + top.SREFcols.size() + top.AREF.size();
+  if (threads == 0)
+    threads = std::thread::hardware_concurrency();
+  if (threads == 0)
+    threads = 1;
+  if (threads == 1 || refCnt < 2) {
+    flatWalker(STR, graph, sink).walk(root, gdsTransform());
+    return EXIT_SUCCESS;
+  }
+
+  flatWalker(STR, graph, sink).geometry(top, gdsTransform());
+
+  // The sink is only asked about the layers on this thread
+  vector<bool> keep(1 << 16);
+  for (unsigned int layer = 0; layer < keep.size(); layer++)
+    keep[layer] = sink.wants_layer(layer);
+
+  // About 32 tasks per thread, so single expensive references still spread
+  const size_t taskRefs = max<size_t>(1, refCnt / (32 * threads));
+  const size_t taskCnt = (refCnt + taskRefs - 1) / taskRefs;
+  const size_t window = 4 * threads; // Finished tasks that may be held
+  vector<flatBuffer> results(taskCnt);
+  vector<char> done(taskCnt, 0);
+  size_t written = 0;
+  atomic<size_t> nextTask(0);
+  mutex lock;
+  condition_variable taskDone, taskWritten;
+
+  auto worker = [&]() {
+    for (size_t t = nextTask++; t < taskCnt; t = nextTask++) {
+      {
+        unique_lock<mutex> guard(lock);
+        taskWritten.wait(guard, [&] { return t < written + window; });
+      }
+      flatBuffer part;
+      part.keep = &keep;
+      flatWalker walker(STR, graph, part);
+      for (size_t i = t * taskRefs; i < min(refCnt, (t + 1) * taskRefs); i++)
+        walker.reference(top, i, gdsTransform());
+      {
+        lock_guard<mutex> guard(lock);
+        results[t] = std::move(part);
+        done[t] = 1;
+      }
+      taskDone.notify_one();
+    }
+  };
+
+  vector<thread> pool;
+  for (unsigned int i = 0; i < threads; i++)
+    pool.emplace_back(worker);
+
+  for (size_t t = 0; t < taskCnt; t++) {
+    flatBuffer part;
+    {
+      unique_lock<mutex> guard(lock);
+      taskDone.wait(guard, [&] { return done[t] != 0; });
+      part = std::move(results[t]);
+    }
+    part.replay(sink);
+    {
+      lock_guard<mutex> guard(lock);
+      written = t + 1;
+    }
+    taskWritten.notify_all();
+  }
+
+  for (auto &it : pool)
+    it.join();
+  return EXIT_SUCCESS;
+}
+
+/**
+ * [gdscpp::flatten - Flattens a structure into the arenas of dest]
+ * @param  root    [Index of the structure in STR]
+ * @param  dest    [Receives the polygons, may not be a structure of STR]
+ * @param  threads [Number of worker threads; 0 - one per hardware thread]
+ * @return         [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdscpp::flatten(unsigned int root, gdsSTR &dest, unsigned int threads)
+{
+  gdsFlatSTR sink(dest);
+  return flatten(root, sink, threads);
+}
@@ -17,78 +17,249 @@ using namespace std;
 
 gdsForge::gdsForge() {}
 
+/**
+ * Constructor for a forge which only builds records in memory
+ * @param capacity [Initial size of the record buffer]
+ */
+gdsForge::gdsForge(size_t capacity) : gdsOut(capacity) {}
+
 /**
  * [gdsForge::gdsCreate - Generates/creates/exports the GDS file]
  * @param  FileName [The file name of the to be created GDS file]
  * @param  inVec    [The vector of GDS structure to be created into the GDS
  * file]
  * @param  double   [The scale the GDS file must use]
+ * @param  threads  [Serializing threads; 1 - serial; 0 - one per hardware
+ * thread. The output is the same for any value.]
  * @return          [0 - Exit Success; 1 - Exit Failure]
  */
 int gdsForge::gdsCreate(const string &FileName, vector<gdsSTR> &inVec,
-                        double units[2])
+                        double units[2], unsigned int threads)
 {
-  this->STR = inVec;
-
   // Initializing the writing
   this->fileName = FileName;
-  gdsFile = fopen(FileName.c_str(), "wb");
-
-  // if(!gdsFile.is_open()){
-  // 	cout << "Error: GDS file \"" << FileName << "\" FAILED to be opened for
-  // writing." << endl;
+  if (gdsOut.open(FileName)) {
+    cout << "Error: GDS file \"" << FileName
+         << "\" FAILED to be opened for writing." << endl;
+    return 1;
+  }
 
   this->gdsBegin();
 
+  this->copiedSTR.clear();
   for (unsigned int i = 0; i < this->GDSfileNameToBeImport.size(); i++) {
     this->gdsCopyFile(this->GDSfileNameToBeImport[i]);
   }
 
   bool minimal = true;
 
-  for (const auto &gds_str : this->STR) {
-    // Start of the structure
-    this->gdsStrStart(gds_str.name);
-    // References
-    for (const auto &gds_sref : gds_str.SREF) {
-      this->gdsSRef(gds_sref, minimal);
-    }
-    // Array References
-    for (const auto &gds_aref : gds_str.AREF) {
-      this->gdsARef(gds_aref, minimal);
-    }
-    // Boundaries
-    for (const auto &gds_boundary : gds_str.BOUNDARY) {
-      this->gdsBoundary(gds_boundary, minimal);
-    }
-    // Paths
-    for (const auto &gds_path : gds_str.PATH) {
-      this->gdsPath(gds_path, minimal);
-    }
-    // Nodes
-    for (const auto &gds_node : gds_str.NODE) {
-      this->gdsNode(gds_node, minimal);
-    }
-    // Texts
-    for (const auto &gds_text : gds_str.TEXT) {
-      this->gdsText(gds_text, minimal);
-    }
-    // Box
-    for (const auto &gds_box : gds_str.BOX) {
-      this->gdsBox(gds_box, minimal);
-    }
-    this->gdsStrEnd();
+  if (threads != 1)
+    this->gdsStructuresParallel(inVec, minimal, threads);
+  else {
+    for (const auto &gds_str : inVec)
+      this->gdsStructure(gds_str, 0, SIZE_MAX, minimal);
   }
 
   this->gdsEnd();
 
   // Terminating the writing
-  fclose(gdsFile);
+  if (gdsOut.close()) {
+    cout << "Error: Writing \"" << this->fileName << "\" FAILED." << endl;
+    return 1;
+  }
   cout << "Creating \"" << this->fileName << "\" done." << endl;
 
   return 0;
 }
 
+/**
+ * [gdsItemCount - Number of items gdsForge::gdsStructure divides a structure
+ * into: the start, every element and the end]
+ */
+static size_t gdsItemCount(const gdsSTR &gds_str)
+{
+  return 2 + gds_str.SREF.size() + gds_str.SREFcols.size() +
+         gds_str.AREF.size() + gds_str.BOUNDARY.size() +
+         gds_str.BOUNDARYarena.size() + gds_str.PATH.size() +
+         gds_str.PATHarena.size() + gds_str.NODE.size() +
+         gds_str.TEXT.size() + gds_str.BOX.size();
+}
+
+/**
+ * [gdsForge::gdsStructure - Writes the items [from, to) of a structure. Item 0
+ * starts the structure, then follow the SREFs, compact SREFs, AREFs,
+ * BOUNDARYs, arena BOUNDARYs, PATHs, arena PATHs, NODEs, TEXTs and BOXs, the
+ * last item ends the structure.]
+ * @param gds_str [The structure to be written]
+ * @param from    [First item to be written]
+ * @param to      [One past the last item to be written]
+ * @param minimal [If true only the minimal element records are created]
+ */
+void gdsForge::gdsStructure(const gdsSTR &gds_str, size_t from, size_t to,
+                            bool minimal)
+{
+  // Structures that were never touched are decoded only for the write.
+  if (!gds_str.is_loaded()) {
+    gdsSTR lazy_str = gds_str;
+    lazy_str.load();
+    this->gdsStructure(lazy_str, from, to, minimal);
+    return;
+  }
+
+  size_t item = 0;
+  size_t first, last;
+  // Sets [first, last) to the part of the next count items within [from, to)
+  auto overlap = [&](size_t count) {
+    first = from > item ? min(from - item, count) : 0;
+    last = to > item ? min(to - item, count) : 0;
+    item += count;
+  };
+
+  // Start of the structure
+  overlap(1);
+  if (first < last)
+    this->gdsStrStart(gds_str.name);
+  // References
+  overlap(gds_str.SREF.size());
+  for (size_t i = first; i < last; i++)
+    this->gdsSRef(gds_str.SREF[i], minimal);
+  overlap(gds_str.SREFcols.size());
+  for (size_t i = first; i < last; i++)
+    this->gdsSRef(gds_str.SREFcols.expand(i), minimal);
+  // Array References
+  overlap(gds_str.AREF.size());
+  for (size_t i = first; i < last; i++)
+    this->gdsARef(gds_str.AREF[i], minimal);
+  // Boundaries
+  overlap(gds_str.BOUNDARY.size());
+  for (size_t i = first; i < last; i++)
+    this->gdsBoundary(gds_str.BOUNDARY[i], minimal);
+  overlap(gds_str.BOUNDARYarena.size());
+  for (size_t i = first; i < last; i++)
+    this->gdsBoundary(gds_str.BOUNDARYarena, i, minimal);
+  // Paths
+  overlap(gds_str.PATH.size());
+  for (size_t i = first; i < last; i++)
+    this->gdsPath(gds_str.PATH[i], minimal);
+  overlap(gds_str.PATHarena.size());
+  for (size_t i = first; i < last; i++)
+    this->gdsPath(gds_str.PATHarena, i, minimal);
+  // Nodes
+  overlap(gds_str.NODE.size());
+  for (size_t i = first; i < last; i++)
+    this->gdsNode(gds_str.NODE[i], minimal);
+  // Texts
+  overlap(gds_str.TEXT.size());
+  for (size_t i = first; i < last; i++)
+    this->gdsText(gds_str.TEXT[i], minimal);
+  // Box
+  overlap(gds_str.BOX.size());
+  for (size_t i = first; i < last; i++)
+    this->gdsBox(gds_str.BOX[i], minimal);
+  // End of the structure
+  overlap(1);
+  if (first < last)
+    this->gdsStrEnd();
+}
+
+/**
+ * [gdsForge::gdsStructuresParallel - Serializes the structures on worker
+ * threads and writes the results in order. The structures are cut into tasks
+ * of about the same number of items, so large structures are shared between
+ * the workers and small ones are grouped. Each worker writes into its own
+ * buffer, only a limited number of finished tasks are held before writing.]
+ * @param inVec   [The structures to be written]
+ * @param minimal [If true only the minimal element records are created]
+ * @param threads [Number of worker threads; 0 - one per hardware thread]
+ */
+void gdsForge::gdsStructuresParallel(const vector<gdsSTR> &inVec, bool minimal,
+                                     unsigned int threads)
+{
+  // Task i covers the items from start[i] up to start[i + 1]
+  struct ItemPos
+  {
+    size_t str;
+    size_t item;
+  };
+  const size_t taskItems = 4096;
+  vector<ItemPos> start;
+  size_t pending = 0;
+  for (size_t i = 0; i < inVec.size(); i++) {
+    // Unknown until decoded, lazily loaded structures are never split
+    size_t count = inVec[i].is_loaded() ? gdsItemCount(inVec[i]) : 1;
+    for (size_t j = 0; j < count;) {
+      if (pending == 0)
+        start.push_back({i, j});
+      size_t take = min(count - j, taskItems - pending);
+      j += take;
+      pending = (pending + take) % taskItems;
+    }
+  }
+  start.push_back({inVec.size(), 0});
+  size_t taskCnt = start.size() - 1;
+
+  if (threads == 0)
+    threads = std::thread::hardware_concurrency();
+  if (threads == 0)
+    threads = 1;
+  const size_t window = 4 * threads; // Finished tasks that may be held
+
+  vector<vector<unsigned char>> results(taskCnt);
+  vector<char> done(taskCnt, 0);
+  size_t written = 0;
+  atomic<size_t> nextTask(0);
+  mutex lock;
+  condition_variable taskDone, taskWritten;
+
+  auto worker = [&]() {
+    gdsForge part(64 << 10);
+    for (size_t t = nextTask++; t < taskCnt; t = nextTask++) {
+      {
+        unique_lock<mutex> guard(lock);
+        taskWritten.wait(guard, [&] { return t < written + window; });
+      }
+      for (size_t i = start[t].str; i <= start[t + 1].str && i < inVec.size();
+           i++) {
+        size_t from = (i == start[t].str) ? start[t].item : 0;
+        size_t to = (i == start[t + 1].str) ? start[t + 1].item : SIZE_MAX;
+        if (from < to)
+          part.gdsStructure(inVec[i], from, to, minimal);
+      }
+      vector<unsigned char> bytes(part.gdsOut.data(),
+                                  part.gdsOut.data() + part.gdsOut.size());
+      part.gdsOut.clear();
+      {
+        lock_guard<mutex> guard(lock);
+        results[t].swap(bytes);
+        done[t] = 1;
+      }
+      taskDone.notify_one();
+    }
+  };
+
+  vector<thread> pool;
+  for (unsigned int i = 0; i < threads; i++)
+    pool.emplace_back(worker);
+
+  for (size_t t = 0; t < taskCnt; t++) {
+    vector<unsigned char> bytes;
+    {
+      unique_lock<mutex> guard(lock);
+      taskDone.wait(guard, [&] { return done[t] != 0; });
+      bytes.swap(results[t]);
+    }
+    this->gdsOut.putBytes(bytes.data(), bytes.size());
+    {
+      lock_guard<mutex> guard(lock);
+      written = t + 1;
+    }
+    taskWritten.notify_all();
+  }
+
+  for (auto &it : pool)
+    it.join();
+}
+
 /***********************************************************************************
  ********************** Functions to easily draw in GDSfiles
  ************************
@@ -167,6 +338,51 @@ gdsBOUNDARY draw2ptBox(int layer, int blX, int blY, int trX, int trY)
   return drawBoundary(layer, ptsX, ptsY);
 }
 
+/**
+ * [drawBoundary - Adds a GDS boundary to the arena of a structure]
+ * @param  dest  [The BOUNDARYarena of the structure]
+ * @param  layer [The layer number]
+ * @param  corX  [The X-coordinates]
+ * @param  corY  [The Y-coordinates]
+ */
+void drawBoundary(gdsPointArena &dest, int layer, const vector<int> &corX,
+                  const vector<int> &corY)
+{
+  dest.push_back(layer, 0, 0, 0, corX, corY);
+}
+
+/**
+ * [drawPath - Adds a GDS path to the arena of a structure]
+ * @param  dest  [The PATHarena of the structure]
+ * @param  layer [The layer number]
+ * @param  width [The thickness of the track]
+ * @param  corX  [The X-coordinates]
+ * @param  corY  [The Y-coordinates]
+ */
+void drawPath(gdsPointArena &dest, int layer, unsigned int width,
+              const vector<int> &corX, const vector<int> &corY)
+{
+  dest.push_back(layer, 0, 2, width, corX, corY);
+}
+
+/**
+ * [draw2ptBox - Adds a boundary box with 2 points to the arena of a
+ * structure]
+ * @param  dest  [The BOUNDARYarena of the structure]
+ * @param  layer [The layer number]
+ * @param  blX   [Bottom Left X coordinate]
+ * @param  blY   [Bottom Left Y coordinate]
+ * @param  trX   [Top Right X coordinate]
+ * @param  trY   [Top Right Y coordinate]
+ */
+void draw2ptBox(gdsPointArena &dest, int layer, int blX, int blY, int trX,
+                int trY)
+{
+  const int corXY[10] = {blX, blY, trX, blY, trX, trY, blX, trY, blX, blY};
+
+  dest.push_back(layer, 0, 0, 0, corXY, 5);
+}
+
 /**
  * [drawSREF - Draws a structure using a reference]
  * @param  STRname [The name of the structure that must be referenced]
@@ -207,6 +423,7 @@ gdsSREF drawSREF(const string &STRname, int Xcor, int Ycor, double angle,
   foo.scale = mag;
   foo.angle = angle;
   foo.reflection = mirror;
+  foo.classify();
 
   return foo;
 }
@@ -271,7 +488,6 @@ void gdsForge::gdsStrEnd()
 void gdsForge::gdsPath(const gdsPATH &in_PATH, bool minimal)
 {
   int data[1];
-  int corXY[in_PATH.xCor.size() * 2];
 
   this->GDSwriteRec(GDS_PATH);
 
@@ -299,15 +515,7 @@ void gdsForge::gdsPath(const gdsPATH &in_PATH, bool minimal)
   // XY coordinates
   // boundary must be closed, first and last coordinate must be the same
   // minimum of 4 points(triangle)
-  for (int i = 0; i < in_PATH.xCor.size() * 2; i++) {
-    if (i % 2) {
-      corXY[i] = in_PATH.yCor[i / 2];
-    } else {
-      corXY[i] = in_PATH.xCor[i / 2];
-    }
-  }
-
-  this->GDSwriteInt(GDS_XY, corXY, in_PATH.xCor.size() * 2);
+  this->GDSwriteXY(in_PATH.xCor, in_PATH.yCor);
 
   // Optional goodies
   if (minimal == false) { // false
@@ -328,7 +536,6 @@ void gdsForge::gdsPath(const gdsPATH &in_PATH, bool minimal)
 void gdsForge::gdsBoundary(const gdsBOUNDARY &in_BOUNDARY, bool minimal)
 {
   int data[1];
-  int corXY[in_BOUNDARY.xCor.size() * 2];
 
   this->GDSwriteRec(GDS_BOUNDARY);
 
@@ -350,17 +557,7 @@ void gdsForge::gdsBoundary(const gdsBOUNDARY &in_BOUNDARY, bool minimal)
   // boundary must be closed, first and last coordinate must be the same
   // minimum of 4 points(triangle)
 
-  for (int i = 0; i < in_BOUNDARY.xCor.size() * 2; i++) {
-    if (i % 2) {
-      // cout << "corY[" << i/2  << "]: " << corY[i/2] << endl;
-      corXY[i] = in_BOUNDARY.yCor[i / 2];
-    } else {
-      // cout << "corX[" << i/2  << "]: " << corX[i/2] << endl;
-      corXY[i] = in_BOUNDARY.xCor[i / 2];
-    }
-  }
-
-  this->GDSwriteInt(GDS_XY, corXY, in_BOUNDARY.xCor.size() * 2);
+  this->GDSwriteXY(in_BOUNDARY.xCor, in_BOUNDARY.yCor);
 
   // Optional goodies
   if (minimal == false) { // false
@@ -373,6 +570,84 @@ void gdsForge::gdsBoundary(const gdsBOUNDARY &in_BOUNDARY, bool minimal)
   this->GDSwriteRec(GDS_ENDEL);
 }
 
+/**
+ * [gdsForge::gdsPath - Create the PATH structure of an arena element]
+ * @param in_arena [The PATHarena of the structure]
+ * @param index    [Index of the path in the arena]
+ * @param minimal  [If true only the minimal PATH structure is created]
+ */
+void gdsForge::gdsPath(const gdsPointArena &in_arena, size_t index,
+                       bool minimal)
+{
+  int data[1];
+
+  this->GDSwriteRec(GDS_PATH);
+
+  if (minimal == false) {
+    data[0] = in_arena.plex(index);
+    this->GDSwriteInt(GDS_PLEX, data, 1);
+  }
+
+  data[0] = in_arena.layer[index];
+  this->GDSwriteInt(GDS_LAYER, data, 1);
+
+  data[0] = in_arena.dataType[index];
+  this->GDSwriteInt(GDS_DATATYPE, data, 1);
+
+  data[0] = in_arena.pathtype[index];
+  this->GDSwriteInt(GDS_PATHTYPE, data, 1);
+
+  data[0] = in_arena.width[index];
+  this->GDSwriteInt(GDS_WIDTH, data, 1);
+
+  this->GDSwriteXY(in_arena.xy(index), in_arena.point_count(index));
+
+  if (minimal == false) {
+    data[0] = in_arena.propattr(index);
+    this->GDSwriteInt(GDS_PROPATTR, data, 1);
+
+    this->GDSwriteStr(GDS_PROPVALUE, in_arena.propvalue(index));
+  }
+
+  this->GDSwriteRec(GDS_ENDEL);
+}
+
+/**
+ * [gdsForge::gdsBoundary - Create the BOUNDARY structure of an arena element]
+ * @param in_arena [The BOUNDARYarena of the structure]
+ * @param index    [Index of the boundary in the arena]
+ * @param minimal  [If true only the minimal BOUNDARY structure is created]
+ */
+void gdsForge::gdsBoundary(const gdsPointArena &in_arena, size_t index,
+                           bool minimal)
+{
+  int data[1];
+
+  this->GDSwriteRec(GDS_BOUNDARY);
+
+  if (minimal == false) {
+    data[0] = in_arena.plex(index);
+    this->GDSwriteInt(GDS_PLEX, data, 1);
+  }
+
+  data[0] = in_arena.layer[index];
+  this->GDSwriteInt(GDS_LAYER, data, 1);
+
+  data[0] = in_arena.dataType[index];
+  this->GDSwriteInt(GDS_DATATYPE, data, 1);
+
+  this->GDSwriteXY(in_arena.xy(index), in_arena.point_count(index));
+
+  if (minimal == false) {
+    data[0] = in_arena.propattr(index);
+    this->GDSwriteInt(GDS_PROPATTR, data, 1);
+
+    this->GDSwriteStr(GDS_PROPVALUE, in_arena.propvalue(index));
+  }
+
+  this->GDSwriteRec(GDS_ENDEL);
+}
+
 /**
  * [gdsForge::gdsSRef - Create the SREF structure]
  * @param in_SREF [The class containing the SREF structure]
@@ -525,7 +800,6 @@ void gdsForge::gdsARef(const gdsAREF &in_AREF, bool minimal)
 void gdsForge::gdsNode(const gdsNODE &in_NODE, bool minimal)
 {
   int data[1];
-  int corXY[in_NODE.xCor.size() * 2];
 
   this->GDSwriteRec(GDS_NODE);
 
@@ -546,17 +820,7 @@ void gdsForge::gdsNode(const gdsNODE &in_NODE, bool minimal)
   // boundary must be closed, first and last coordinate must be the same
   // minimum of 4 points(triangle)
 
-  for (int i = 0; i < in_NODE.xCor.size() * 2; i++) {
-    if (i % 2) {
-      // cout << "corY[" << i/2  << "]: " << corY[i/2] << endl;
-      corXY[i] = in_NODE.yCor[i / 2];
-    } else {
-      // cout << "corX[" << i/2  << "]: " << corX[i/2] << endl;
-      corXY[i] = in_NODE.xCor[i / 2];
-    }
-  }
-
-  this->GDSwriteInt(GDS_XY, corXY, in_NODE.xCor.size() * 2);
+  this->GDSwriteXY(in_NODE.xCor, in_NODE.yCor);
 
   // Optional goodies
   if (minimal == false) { // false
@@ -642,7 +906,6 @@ void gdsForge::gdsText(const gdsTEXT &in_TEXT, bool minimal)
 void gdsForge::gdsBox(const gdsBOX &in_BOX, bool minimal)
 {
   int data[1];
-  int corXY[in_BOX.xCor.size() * 2];
 
   this->GDSwriteRec(GDS_BOX);
 
@@ -664,15 +927,7 @@ void gdsForge::gdsBox(const gdsBOX &in_BOX, bool minimal)
   // boundary must be closed, first and last coordinate must be the same
   // minimum of 4 points(triangle)
 
-  for (int i = 0; i < in_BOX.xCor.size() * 2; i++) {
-    if (i % 2) {
-      corXY[i] = in_BOX.yCor[i / 2];
-    } else {
-      corXY[i] = in_BOX.xCor[i / 2];
-    }
-  }
-
-  this->GDSwriteInt(GDS_XY, corXY, in_BOX.xCor.size() * 2);
+  this->GDSwriteXY(in_BOX.xCor, in_BOX.yCor);
 
   // Optional goodies
   if (minimal == false) { // false
@@ -686,7 +941,10 @@ void gdsForge::gdsBox(const gdsBOX &in_BOX, bool minimal)
 }
 
 /**
- * [gdsForge::gdsCopyFile - Copies the structure from a GDS file to another]
+ * [gdsForge::gdsCopyFile - Copies the structures from a GDS file to another.
+ * The file is memory mapped and every wanted structure is spliced in as one
+ * block, only its BGNSTR record is written anew with the current time.
+ * Structures already copied into this output file are skipped.]
  * @param  fileName [Name of file to be imported]
  * @return          [0 - Exit Success; 1 - Exit Failure]
  */
@@ -694,76 +952,54 @@ int gdsForge::gdsCopyFile(const string &fileName)
 {
   cout << "Copying GDS binaries from \"" << fileName << "\"" << endl;
 
-  ifstream gdsFileIn;
-
-  gdsFileIn.open(fileName, ios::in | ios::binary);
-
-  if (!gdsFileIn.is_open()) {
+  gdsMap gdsFileIn;
+  if (gdsFileIn.open(fileName)) {
     cout << "FAILED to open GDS file \"" << fileName << "\"" << endl;
     return 1;
   }
 
-  char *readBlk;
-  uint32_t sizeBlk;
-  uint32_t hexKey;
-  bool cpEN = false;
-  bool firstLine = true;
-  string strName;
-  static set<string> StoredStr;
-
-  gdsFileIn.seekg(0, ios::beg);
-
-  do {
-    readBlk = new char[2];
-    gdsFileIn.read(readBlk, 2); // Get the size of the record
-    sizeBlk = (((unsigned char)readBlk[0] << 8) |
-               (unsigned char)readBlk[1]); // Interpret the size of the record
+  gdsReader reader(gdsFileIn.begin(), gdsFileIn.size());
+  const char *recIn;
+  const char *blockStart = nullptr; // STRNAME of the structure being copied
+  bool named = false;
 
-    gdsFileIn.seekg(-2, ios::cur);
-    readBlk = new char[sizeBlk]; // Reading in the full length of the record
-                                 // excluding the size
-    gdsFileIn.read(readBlk, sizeBlk);
-
-    hexKey = (((unsigned char)readBlk[2] << 8) | (unsigned char)readBlk[3]);
+  while ((recIn = reader.next()) != nullptr) {
+    uint32_t hexKey = gdsRecKey(recIn);
+    uint32_t sizeBlk = gdsRecSize(recIn);
 
     if (hexKey == GDS_BGNSTR) { // Beginning of structure
-      cpEN = true;
-      firstLine = true;
-    }
-
-    if (cpEN && hexKey == GDS_STRNAME) { // get the name of the structure
-      strName = "";
-      for (uint8_t i = 4; i < sizeBlk; i++) {
-        strName = strName + readBlk[i];
-      }
-
-      if (StoredStr.find(strName) != StoredStr.end()) { // found
+      blockStart = nullptr;
+      named = false;
+    } else if (hexKey == GDS_STRNAME && !named) {
+      named = true;
+      string strName(recIn + 4, sizeBlk - 4);
+      while (!strName.empty() && strName.back() == '\0')
+        strName.pop_back();
+
+      if (!this->copiedSTR.insert(strName).second) {
         cout << "Structure: \"" << strName << "\""
              << " already copied." << endl;
-        cpEN = false;
-      } else { // didnt find
+      } else {
         cout << "Structure: \"" << strName << "\""
              << " copying" << endl;
-        StoredStr.insert(strName);
+        blockStart = recIn;
+      }
+    } else if (hexKey == GDS_ENDSTR) { // End of structure
+      if (blockStart != nullptr) {
         this->GDSwriteInt(GDS_BGNSTR, gsdTime(), 12);
+        this->gdsOut.putBlock(blockStart, recIn + sizeBlk - blockStart);
       }
-
-      firstLine = false;
-    }
-
-    if (cpEN && !firstLine) { // Write(copy) the GSD record
-      fwrite(readBlk, 1, sizeBlk, this->gdsFile);
+      blockStart = nullptr;
+    } else if (hexKey == GDS_ENDLIB) {
+      break;
     }
+  }
 
-    if (hexKey == GDS_ENDSTR) { // end of structure
-      cpEN = false;
-    }
-
-  } while (hexKey != GDS_ENDLIB);
-
-  delete[] readBlk;
+  if (recIn == nullptr) {
+    cout << "Error: GDS file \"" << fileName << "\" is truncated." << endl;
+    return 1;
+  }
 
-  gdsFileIn.close();
   cout << "Copying GDS binaries of \"" << fileName << "\" done." << endl;
   return 0;
 }
@@ -797,57 +1033,85 @@ int gdsForge::GDSwriteInt(int record, int arrInt[], int cnt)
   }
 
   unsigned int sizeByte = cnt * dataSize + 4;
-  unsigned char OHout[4];
+  this->gdsOut.putRecord(sizeByte, record);
 
-  OHout[0] = sizeByte >> 8 & 0xff;
-  OHout[1] = sizeByte & 0xff;
-  OHout[2] = record >> 8 & 0xff;
-  OHout[3] = record & 0xff;
-  fwrite(OHout, 1, 4, this->gdsFile);
+  unsigned char *dataOut = this->gdsOut.reserve(cnt * dataSize);
 
-  unsigned char dataOut[dataSize];
+  if (dataSize == 4) {
+    for (int i = 0; i < cnt; i++)
+      gdsStore32(dataOut + i * 4, arrInt[i]);
+  } else {
+    for (int i = 0; i < cnt; i++)
+      gdsStore16(dataOut + i * 2, arrInt[i]);
+  }
 
-  for (int i = 0; i < cnt; i++) {
-    for (unsigned int j = 0; j < dataSize; j++) {
-      dataOut[j] = arrInt[i] >> (((dataSize - 1) * 8) - (j * 8)) & 0xff;
-    }
-    fwrite(dataOut, 1, dataSize, this->gdsFile);
+  return 0;
+}
+
+/**
+ * [gdsForge::GDSwriteXY - Writes the XY record of a list of coordinates]
+ * @param  xCor [The X-coordinates]
+ * @param  yCor [The Y-coordinates, same length as xCor]
+ * @return      [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsForge::GDSwriteXY(const vector<int> &xCor, const vector<int> &yCor)
+{
+  if (xCor.size() != yCor.size()) {
+    cout << "Error: XY co_ordinates uneven" << endl;
+    return 1;
+  }
+
+  unsigned int cnt = xCor.size();
+  this->gdsOut.putRecord(cnt * 8 + 4, GDS_XY);
+
+  unsigned char *dataOut = this->gdsOut.reserve(cnt * 8);
+  for (unsigned int i = 0; i < cnt; i++) {
+    gdsStore32(dataOut + i * 8, xCor[i]);
+    gdsStore32(dataOut + i * 8 + 4, yCor[i]);
   }
 
   return 0;
 }
 
+/**
+ * [gdsForge::GDSwriteXY - Writes the XY record of interleaved coordinates]
+ * @param  corXY [x_0, y_0, x_1, y_1, ...]
+ * @param  cnt   [Number of points]
+ * @return       [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsForge::GDSwriteXY(const int *corXY, size_t cnt)
+{
+  this->gdsOut.putRecord(cnt * 8 + 4, GDS_XY);
+
+  unsigned char *dataOut = this->gdsOut.reserve(cnt * 8);
+  for (size_t i = 0; i < cnt * 2; i++)
+    gdsStore32(dataOut + i * 4, corXY[i]);
+
+  return 0;
+}
+
 /**
  * [gdsForge::GDSwriteStr - Writes a string value to file]
  * @param  record [GDS record type]
  * @param  inStr  [The string to be written]
  * @return 				[0 - Exit Success; 1 - Exit Failure]
  */
-int gdsForge::GDSwriteStr(int record, string inStr)
+int gdsForge::GDSwriteStr(int record, const string &inStr)
 {
   if ((record & 0xff) != 0x06) {
     cout << "Incorrect record: 0x" << hex << record << endl;
     cout << dec;
     return 1;
   }
-  unsigned char OHout[4];
-
-  if (inStr.length() % 2 == 1) {
-    // therefore odd
-    inStr.push_back('\0');
-  }
+  // Odd length strings are padded with a null character
+  int lenStr = inStr.length() + inStr.length() % 2;
 
-  int lenStr = inStr.length();
+  this->gdsOut.putRecord(lenStr + 4, record);
 
-  OHout[0] = ((lenStr + 4) >> 8) & 0xff;
-  OHout[1] = (lenStr + 4) & 0xff;
-  OHout[2] = record >> 8 & 0xff;
-  OHout[3] = record & 0xff;
-  fwrite(OHout, 1, 4, this->gdsFile);
-
-  char dataOut[lenStr];
-  strcpy(dataOut, inStr.c_str());
-  fwrite(dataOut, 1, lenStr, this->gdsFile);
+  unsigned char *dataOut = this->gdsOut.reserve(lenStr);
+  memcpy(dataOut, inStr.data(), inStr.length());
+  if (lenStr != (int)inStr.length())
+    dataOut[lenStr - 1] = '\0';
 
   return 0;
 }
@@ -865,15 +1129,11 @@ int gdsForge::GDSwriteBitArr(int record, bitset<16> inBits)
     cout << dec;
     return 1;
   }
-  unsigned char OHout[4];
-
-  OHout[0] = 0 & 0xff;
-  OHout[1] = (2 + 4) & 0xff;
-  OHout[2] = record >> 8 & 0xff;
-  OHout[3] = record & 0xff;
-  fwrite(OHout, 1, 4, this->gdsFile);
+  this->gdsOut.putRecord(2 + 4, record);
 
-  unsigned char dataOut[2] = {0, 0};
+  unsigned char *dataOut = this->gdsOut.reserve(2);
+  dataOut[0] = 0;
+  dataOut[1] = 0;
 
   for (int i = 15; i >= 8; i--) {
     dataOut[0] = dataOut[0] | (inBits[i] << (i - 8));
@@ -882,8 +1142,6 @@ int gdsForge::GDSwriteBitArr(int record, bitset<16> inBits)
     dataOut[1] = dataOut[1] | (inBits[i] << i);
   }
 
-  fwrite(dataOut, 1, 2, this->gdsFile);
-
   return 0;
 }
 
@@ -908,23 +1166,13 @@ int gdsForge::GDSwriteRea(int record, double arrInt[], int cnt)
   }
 
   unsigned int sizeByte = cnt * dataSize + 4;
-  unsigned char OHout[4];
+  this->gdsOut.putRecord(sizeByte, record);
 
-  OHout[0] = sizeByte >> 8 & 0xff;
-  OHout[1] = sizeByte & 0xff;
-  OHout[2] = record >> 8 & 0xff;
-  OHout[3] = record & 0xff;
-  fwrite(OHout, 1, 4, this->gdsFile);
-
-  unsigned char dataOut[dataSize];
+  unsigned char *dataOut = this->gdsOut.reserve(cnt * dataSize);
 
   for (int i = 0; i < cnt; i++) {
     realVal = GDSfloatCalc(arrInt[i]);
-    for (unsigned int j = 0; j < dataSize; j++) {
-      // dataOut[j] = realVal >> (((dataSize-1)*8) - (j*8)) & 0xff;
-      dataOut[j] = realVal >> (56 - (j * 8)) & 0xff;
-    }
-    fwrite(dataOut, 1, dataSize, this->gdsFile);
+    gdsStore64(dataOut + i * 8, realVal);
   }
 
   return 0;
@@ -958,7 +1206,7 @@ void gdsForge::GDSwriteUnits()
   data[18] = 0x5a;
   data[19] = 0x50;
 
-  fwrite(data, 1, 20, this->gdsFile);
+  this->gdsOut.putBytes(data, 20);
 }
 
 /**
@@ -968,19 +1216,12 @@ void gdsForge::GDSwriteUnits()
  */
 int gdsForge::GDSwriteRec(int record)
 {
-  unsigned char OHout[4];
-
-  OHout[0] = 0;
-  OHout[1] = 4;
-  OHout[2] = record >> 8 & 0xff;
-  OHout[3] = record & 0xff;
-
-  if (OHout[3] != 0) {
+  if ((record & 0xff) != 0) {
     cout << "The smoke has escaped. The record must be dataless" << endl;
     return 1;
   }
 
-  fwrite(OHout, 1, 4, this->gdsFile);
+  this->gdsOut.putRecord(4, record);
 
   return 0;
-}
\ No newline at end of file
+}
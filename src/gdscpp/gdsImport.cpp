@@ -26,840 +26,621 @@ int rotate_point(double cx, double cy, double angle, POINT &subject);
 
 // ====================== Function Code =======================
 
+/*
+ * [gdsSTRVisitor - Fills the gdsSTR pointed to by dest with the records of a
+ * single structure.]
+ */
+class gdsSTRVisitor : public gdsVisitor
+{
+protected:
+  gdsSTR *dest = nullptr;
+
+public:
+  gdsSTRVisitor(gdsSTR *target) : dest(target){};
+  ~gdsSTRVisitor(){};
+
+  void onBeginStr(const string &name, const vector<int> &last_modified) override
+  {
+    dest->reset();
+    dest->name = name;
+    dest->last_modified.clear();
+    std::transform(last_modified.begin(), last_modified.end(),
+                   std::back_inserter(dest->last_modified),
+                   [](char a) { return (int)a; });
+  };
+  // Compact structures get their points decoded straight into the arenas
+  gdsPointArena *boundaryArena() override
+  {
+    return dest->compact_geometry ? &dest->BOUNDARYarena : nullptr;
+  };
+  gdsPointArena *pathArena() override
+  {
+    return dest->compact_geometry ? &dest->PATHarena : nullptr;
+  };
+  void onBoundary(const gdsBOUNDARY &boundary) override
+  {
+    dest->BOUNDARY.push_back(boundary);
+  };
+  void onPath(const gdsPATH &path) override { dest->PATH.push_back(path); };
+  void onSref(const gdsSREF &sref) override { dest->SREF.push_back(sref); };
+  void onAref(const gdsAREF &aref) override { dest->AREF.push_back(aref); };
+  void onText(const gdsTEXT &text) override { dest->TEXT.push_back(text); };
+  void onNode(const gdsNODE &node) override { dest->NODE.push_back(node); };
+  void onBox(const gdsBOX &box) override { dest->BOX.push_back(box); };
+};
+
 /**
- * [gdscpp::read description]
+ * [gdsSTR::load - Decodes a structure created by gdscpp::import_lazy from its
+ * mapped file. Does nothing if the structure is already in memory.]
+ * @return [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsSTR::load()
+{
+  if (is_loaded())
+    return EXIT_SUCCESS;
+
+  // Hold on to the map, reset() in the decoding releases lazy_source.
+  std::shared_ptr<const gdsMap> source = lazy_source;
+  gdsReader strIn(source->begin(), source->size());
+  strIn.seek(lazy_offset);
+  // The elements were in the structure all along, its box stays current
+  gdscpp *lib = SREFcols.owner.lib();
+  unsigned int index = SREFcols.owner.structure();
+  set_owner(nullptr, 0);
+  gdsSTRVisitor strBuilder(this);
+  int failed = gdsDecodeSTR(strIn, strBuilder);
+  set_owner(lib, index);
+  if (failed) {
+    lazy_source = source;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+/*
+ * [gdsImportVisitor - Builds the in-memory structure tree of a gdscpp object
+ * from the decoded records.]
+ */
+class gdsImportVisitor : public gdsSTRVisitor
+{
+private:
+  gdscpp &target;
+  gdsSTR plchold_str;
+
+public:
+  gdsImportVisitor(gdscpp &lib) : gdsSTRVisitor(nullptr), target(lib)
+  {
+    dest = &plchold_str;
+    plchold_str.compact_geometry = lib.compact_geometry;
+  };
+  ~gdsImportVisitor(){};
+
+  void onHeader(int version) override { target.version_number = version; };
+  void onBeginLib(const vector<int> &last_modified) override
+  {
+    std::transform(last_modified.begin(), last_modified.end(),
+                   std::back_inserter(target.last_modified),
+                   [](char a) { return (int)a; });
+  };
+  void onLibName(const string &name) override { target.library_name = name; };
+  void onGenerations(int generations) override
+  {
+    target.generations = generations;
+  };
+  void onUnits(double user_units, double meter_units) override
+  {
+    target.units[0] = user_units;
+    target.units[1] = meter_units;
+  };
+  void onEndLib() override { cout << "Reached end of library." << endl; };
+  void onEndStr() override { target.setSTR(std::move(plchold_str)); };
+};
+
+/**
+ * [gdscpp::import - Reads a GDS file into memory]
  * @param  fileName [The file name of the GDS file that is going to be read in]
  * @return          [0 - Exit Success; 1 - Exit Failure]
  */
 int gdscpp::import(string fileName)
 {
-  // Variable declarations
-  std::ifstream gdsFile;
-  char *current_readBlk;
-  uint32_t current_sizeBlk;
-  uint32_t current_GDSKey;
-  bitset<16> current_bitarr;
-  vector<int> current_integer;
-  auto current_int_iter = current_integer.begin();
-  vector<double> current_B8Real;
-  string current_words = "\0";
-  bool odd_state = false;
-
-  // Memory where element objects are held until stored into library.
-  gdsSTR plchold_str;
-  gdsBOUNDARY plchold_bnd;
-  gdsPATH plchold_path;
-  gdsSREF plchold_sref;
-  gdsAREF plchold_aref;
-  gdsTEXT plchold_text;
-  gdsNODE plchold_node;
-  gdsBOX plchold_box;
+  gdsMap gdsFile;
 
-  gdsFile.open(fileName, ios::in | ios::binary);
-  if (!gdsFile.is_open()) {
+  if (gdsFile.open(fileName)) {
     cout << "Error: GDS file \"" << fileName << "\" FAILED to be opened."
          << endl;
     return EXIT_FAILURE;
   }
   cout << "Importing \"" << fileName << "\" into GDSCpp." << endl;
-  gdsFile.seekg(0, ios::beg);
-  do {
-    current_readBlk = new char[2];
-    gdsFile.read(current_readBlk, 2);
-    current_sizeBlk = (((unsigned char)current_readBlk[0] << 8) |
-                       (unsigned char)current_readBlk[1]);
-    gdsFile.seekg(-2, ios::cur);
-    current_readBlk = new char[current_sizeBlk];
-    gdsFile.read(current_readBlk, current_sizeBlk);
-    if (GDSdistill(current_readBlk, current_GDSKey, current_bitarr,
-                   current_integer, current_B8Real, current_words)) {
-      cout << "Error: Unable to read GDS file." << endl;
-      break;
-    } else {
-      switch (current_GDSKey)
-      // Highest tier of data: HEADER, BGNLIB, LIBNAME, GENERATIONS, UNITS,
-      // BGNSTR, ENDDLIB
-      {
-      case GDS_HEADER:
-        version_number = (int)current_integer[0];
-        break;
-      case GDS_BGNLIB:
-        std::transform(current_integer.begin(), current_integer.end(),
-                       std::back_inserter(last_modified),
-                       [](char a) { return (int)a; });
-        break;
-      case GDS_LIBNAME:
-        library_name = current_words;
-        break;
-      case GDS_GENERATIONS:
-        generations = (int)current_integer[0];
-        break;
-      case GDS_UNITS:
-        units[0] = current_B8Real[0];
-        units[1] = current_B8Real[1];
-        break;
-      case GDS_BGNSTR:
-        //@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ FIRST NEST
-        //@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
-        //                           BOUNDARY, PATH SREF AREF TEXT NODE BOX
-        plchold_str.reset();
-        std::transform(current_integer.begin(), current_integer.end(),
-                       std::back_inserter(plchold_str.last_modified),
-                       [](char a) { return (int)a; });
-        do {
-          current_readBlk = new char[2];
-          gdsFile.read(current_readBlk, 2);
-
-          current_sizeBlk = (((unsigned char)current_readBlk[0] << 8) |
-                             (unsigned char)current_readBlk[1]);
-
-          gdsFile.seekg(-2, ios::cur);
-          current_readBlk = new char[current_sizeBlk];
-          gdsFile.read(current_readBlk, current_sizeBlk);
 
-          if (GDSdistill(current_readBlk, current_GDSKey, current_bitarr,
-                         current_integer, current_B8Real, current_words)) {
-            cout << "Error: Unable to read GDS file." << endl;
-            break;
-          } else {
-            switch (current_GDSKey) {
-            case GDS_STRNAME:
-              plchold_str.name = current_words;
-              break;
-            case GDS_BOUNDARY:
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ secondary nest [BOUNDARY]
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-              // PLEX LAYER DATATYPE XY PROPATTR PROPVALUE
-              plchold_bnd.reset();
-              do {
-                current_readBlk = new char[2];
-                gdsFile.read(current_readBlk, 2);
+  // Records are decoded in place from the mapped file; nothing is copied.
+  gdsReader gdsIn(gdsFile.begin(), gdsFile.size());
+  gdsImportVisitor builder(*this);
+  gdsDecodeLib(gdsIn, builder);
 
-                current_sizeBlk = (((unsigned char)current_readBlk[0] << 8) |
-                                   (unsigned char)current_readBlk[1]);
-
-                gdsFile.seekg(-2, ios::cur);
-                current_readBlk = new char[current_sizeBlk];
-                gdsFile.read(current_readBlk, current_sizeBlk);
+  STR_Lookup.insert(
+      {"\0", 1000000000}); // Add null character to structure map with index 1
+                           // billion. Unlikely to be 1 billion structures
+  // resolve_heirarchy_and_bounding_boxes();
+  cout << "GDS file successfully imported." << endl;
+  return 0;
+}
 
-                if (GDSdistill(current_readBlk, current_GDSKey, current_bitarr,
-                               current_integer, current_B8Real,
-                               current_words)) {
-                  cout << "Error: Unable to read GDS file." << endl;
-                  break;
-                } else {
-                  switch (current_GDSKey) {
-                  case GDS_PLEX:
-                    plchold_bnd.plex = current_integer[0];
-                    break;
-                  case GDS_LAYER:
-                    plchold_bnd.layer = current_integer[0];
-                    break;
-                  case GDS_DATATYPE:
-                    plchold_bnd.dataType = current_integer[0];
-                    break;
-                  case GDS_XY:
-                    // confirm xy as pairs
-                    if (current_integer.size() % 2 == 0) {
-                      current_int_iter = current_integer.begin();
-                      odd_state = false;
-                      while (current_int_iter != current_integer.end()) {
-                        if (odd_state == false) {
-                          // x append
-                          plchold_bnd.xCor.push_back(*current_int_iter);
-                        } else {
-                          // y append
-                          plchold_bnd.yCor.push_back(*current_int_iter);
-                        }
-                        odd_state = !odd_state;
-                        current_int_iter++;
-                      }
-                    } else {
-                      cout << "Error: XY co_ordinates uneven" << endl;
-                    }
-                    break;
-                  case GDS_PROPATTR:
-                    plchold_bnd.propattr = current_integer[0];
-                    break;
-                  case GDS_PROPVALUE:
-                    plchold_bnd.propvalue = current_words;
-                    break;
-                  case GDS_ENDEL:
+/**
+ * [gdscpp::import_parallel - Reads a GDS file into memory, decoding the
+ * structures concurrently. The file is first scanned for the start of every
+ * structure, the structures are then shared out between the threads.]
+ * @param  fileName [The file name of the GDS file that is going to be read in]
+ * @param  threads  [Number of decoding threads; 0 - one per hardware thread]
+ * @return          [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdscpp::import_parallel(string fileName, unsigned int threads)
+{
+  gdsMap gdsFile;
 
-                    break;
-                  default:
-                    cout << "Error: Unrecognized record." << endl;
-                    break;
-                  }
-                }
-              } while (current_GDSKey != GDS_ENDEL);
-              plchold_str.BOUNDARY.push_back(plchold_bnd);
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ end secondary nest
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-              break;
-            case GDS_PATH:
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ secondary nest [PATH]
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-              // PLEX LAYER DATATYPE PATHTYPE WIDTH XY PROPATTR PROPVALUE
-              plchold_path.reset();
-              do {
-                current_readBlk = new char[2];
-                gdsFile.read(current_readBlk, 2);
+  if (gdsFile.open(fileName)) {
+    cout << "Error: GDS file \"" << fileName << "\" FAILED to be opened."
+         << endl;
+    return EXIT_FAILURE;
+  }
+  cout << "Importing \"" << fileName << "\" into GDSCpp." << endl;
 
-                current_sizeBlk = (((unsigned char)current_readBlk[0] << 8) |
-                                   (unsigned char)current_readBlk[1]);
+  // Pass 1: Library records and the offset of every BGNSTR record.
+  vector<size_t> str_offsets;
+  gdsReader gdsIn(gdsFile.begin(), gdsFile.size());
+  gdsImportVisitor builder(*this);
+  if (gdsIndexLib(gdsIn, builder, str_offsets))
+    return EXIT_FAILURE;
 
-                gdsFile.seekg(-2, ios::cur);
-                current_readBlk = new char[current_sizeBlk];
-                gdsFile.read(current_readBlk, current_sizeBlk);
+  // Pass 2: Decode the structures, each into its own slot.
+  vector<gdsSTR> decoded(str_offsets.size());
+  for (auto &str_it : decoded)
+    str_it.compact_geometry = compact_geometry;
+  if (threads == 0)
+    threads = std::thread::hardware_concurrency();
+  if (threads == 0)
+    threads = 1;
+  if (threads > str_offsets.size())
+    threads = str_offsets.size();
 
-                if (GDSdistill(current_readBlk, current_GDSKey, current_bitarr,
-                               current_integer, current_B8Real,
-                               current_words)) {
-                  cout << "Error: Unable to read GDS file." << endl;
-                  break;
-                } else {
-                  switch (current_GDSKey) {
-                  case GDS_PLEX:
-                    plchold_path.plex = current_integer[0];
-                    break;
-                  case GDS_LAYER:
-                    plchold_path.layer = current_integer[0];
-                    break;
-                  case GDS_DATATYPE:
-                    plchold_path.dataType = current_integer[0];
-                    break;
-                  case GDS_PATHTYPE:
-                    plchold_path.pathtype = current_integer[0];
-                    break;
-                  case GDS_WIDTH:
-                    plchold_path.width = current_integer[0];
-                    break;
-                  case GDS_XY:
-                    // confirm xy as pairs
-                    if (current_integer.size() % 2 == 0) {
-                      current_int_iter = current_integer.begin();
-                      odd_state = false;
-                      while (current_int_iter != current_integer.end()) {
-                        if (odd_state == false) {
-                          // x append
-                          plchold_path.xCor.push_back(*current_int_iter);
-                        } else {
-                          // y append
-                          plchold_path.yCor.push_back(*current_int_iter);
-                        }
-                        odd_state = !odd_state;
-                        current_int_iter++;
-                      }
-                    } else {
-                      cout << "Error: XY co_ordinates uneven" << endl;
-                    }
-                    break;
-                  case GDS_PROPATTR:
-                    plchold_path.propattr = current_integer[0];
-                    break;
-                  case GDS_PROPVALUE:
-                    plchold_path.propvalue = current_words;
-                    break;
-                  case GDS_ENDEL:
+  atomic<size_t> next_str(0);
+  atomic<bool> failed(false);
+  auto worker = [&]() {
+    gdsReader strIn(gdsFile.begin(), gdsFile.size());
+    for (size_t i = next_str++; i < str_offsets.size(); i = next_str++) {
+      strIn.seek(str_offsets[i]);
+      gdsSTRVisitor strBuilder(&decoded[i]);
+      if (gdsDecodeSTR(strIn, strBuilder))
+        failed = true;
+    }
+  };
+  vector<thread> pool;
+  for (unsigned int i = 1; i < threads; i++)
+    pool.emplace_back(worker);
+  worker();
+  for (auto &t : pool)
+    t.join();
+  if (failed)
+    return EXIT_FAILURE;
 
-                    break;
-                  default:
-                    cout << "Error: Unrecognized record." << endl;
-                    break;
-                  }
-                }
-              } while (current_GDSKey != GDS_ENDEL);
-              plchold_str.PATH.push_back(plchold_path);
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ end secondary nest
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-              break;
-            case GDS_SREF:
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ secondary nest [SREF]
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-              // PLEX SNAME STRANS MAG ANGLE XY PROPATTR PROPVALUE
-              plchold_sref.reset();
-              do {
-                current_readBlk = new char[2];
-                gdsFile.read(current_readBlk, 2);
+  // Pass 3: Append in file order, the first structure of a name is kept.
+  STR.reserve(STR.size() + decoded.size());
+  for (auto &str_it : decoded)
+    push_back_STR(std::move(str_it));
 
-                current_sizeBlk = (((unsigned char)current_readBlk[0] << 8) |
-                                   (unsigned char)current_readBlk[1]);
+  STR_Lookup.insert(
+      {"\0", 1000000000}); // Add null character to structure map with index 1
+                           // billion. Unlikely to be 1 billion structures
+  cout << "GDS file successfully imported." << endl;
+  return 0;
+}
 
-                gdsFile.seekg(-2, ios::cur);
-                current_readBlk = new char[current_sizeBlk];
-                gdsFile.read(current_readBlk, current_sizeBlk);
+/**
+ * [gdscpp::import_lazy - Opens a GDS file but only records the name and
+ * location of each structure. A structure is decoded the first time it is
+ * needed, see gdscpp::load_STR.]
+ * @param  fileName [The file name of the GDS file that is going to be read in]
+ * @return          [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdscpp::import_lazy(string fileName)
+{
+  auto gdsFile = std::make_shared<gdsMap>();
 
-                if (GDSdistill(current_readBlk, current_GDSKey, current_bitarr,
-                               current_integer, current_B8Real,
-                               current_words)) {
-                  cout << "Error: Unable to read GDS file." << endl;
-                  break;
-                } else {
-                  switch (current_GDSKey) {
-                  case GDS_PLEX:
-                    plchold_sref.plex = current_integer[0];
-                    break;
-                  case GDS_SNAME:
-                    plchold_sref.name = current_words;
-                    break;
-                  case GDS_STRANS:
-                    plchold_sref.sref_flags = current_bitarr;
-                    plchold_sref.reflection = current_bitarr[15];
-                    break;
-                  case GDS_MAG:
-                    plchold_sref.sref_flags.set(
-                        13, 1); // Precaution incase other software forgot to
-                                // set bit
-                    plchold_sref.scale =
-                        current_B8Real[0]; // TODO: Check that distill actually
-                                           // kicks outb8real here.
-                    break;
-                  case GDS_ANGLE:
-                    plchold_sref.angle = current_B8Real[0];
-                    break;
-                  case GDS_XY:
-                    // confirm xy as pairs
-                    if (current_integer.size() % 2 == 0) {
-                      // x append
-                      plchold_sref.xCor = current_integer[0];
-                      // y append
-                      plchold_sref.yCor = current_integer[1];
-                    } else {
-                      cout << "Error: Missing X or Y co-ordinate" << endl;
-                    }
-                    break;
-                  case GDS_PROPATTR:
-                    plchold_sref.propattr = current_integer[0];
-                    break;
-                  case GDS_PROPVALUE:
-                    plchold_sref.propvalue = current_words;
-                    break;
-                  case GDS_ENDEL:
+  if (gdsFile->open(fileName)) {
+    cout << "Error: GDS file \"" << fileName << "\" FAILED to be opened."
+         << endl;
+    return EXIT_FAILURE;
+  }
+  cout << "Importing \"" << fileName << "\" into GDSCpp (on demand)." << endl;
 
-                    break;
-                  default:
-                    cout << "Error: Unrecognized record." << endl;
-                    break;
-                  }
-                }
-              } while (current_GDSKey != GDS_ENDEL);
-              plchold_str.SREF.push_back(plchold_sref);
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ end secondary nest
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-              break;
-            case GDS_AREF:
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ secondary nest [AREF]
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-              // PLEX SNAME STRANS MAG ANGLE COLROW XY PROPATTR PROPVALUE
-              plchold_aref.reset();
-              do {
-                current_readBlk = new char[2];
-                gdsFile.read(current_readBlk, 2);
+  vector<size_t> str_offsets;
+  gdsReader gdsIn(gdsFile->begin(), gdsFile->size());
+  gdsImportVisitor builder(*this);
+  if (gdsIndexLib(gdsIn, builder, str_offsets))
+    return EXIT_FAILURE;
 
-                current_sizeBlk = (((unsigned char)current_readBlk[0] << 8) |
-                                   (unsigned char)current_readBlk[1]);
+  // Only the STRNAME record, which follows BGNSTR, is decoded now.
+  uint32_t GDSKey;
+  bitset<16> bitarr;
+  vector<int> integer;
+  vector<double> B8Real;
+  string words;
+  gdsSTR plchold_str;
+  plchold_str.compact_geometry = compact_geometry;
+  for (const auto &offset : str_offsets) {
+    gdsIn.seek(offset);
+    gdsIn.next();
+    const char *recIn = gdsIn.next();
+    if (recIn == nullptr ||
+        GDSdistill(recIn, GDSKey, bitarr, integer, B8Real, words) ||
+        GDSKey != GDS_STRNAME) {
+      cout << "Error: Structure without a name in \"" << fileName << "\"."
+           << endl;
+      return EXIT_FAILURE;
+    }
+    plchold_str.reset();
+    plchold_str.name = words;
+    plchold_str.lazy_source = gdsFile;
+    plchold_str.lazy_offset = offset;
+    push_back_STR(std::move(plchold_str));
+  }
 
-                gdsFile.seekg(-2, ios::cur);
-                current_readBlk = new char[current_sizeBlk];
-                gdsFile.read(current_readBlk, current_sizeBlk);
+  STR_Lookup.insert(
+      {"\0", 1000000000}); // Add null character to structure map with index 1
+                           // billion. Unlikely to be 1 billion structures
+  cout << "GDS file successfully imported." << endl;
+  return 0;
+}
 
-                if (GDSdistill(current_readBlk, current_GDSKey, current_bitarr,
-                               current_integer, current_B8Real,
-                               current_words)) {
-                  cout << "Error: Unable to read GDS file." << endl;
-                  break;
-                } else {
-                  switch (current_GDSKey) {
-                  case GDS_PLEX:
-                    plchold_aref.plex = current_integer[0];
-                    break;
-                  case GDS_SNAME:
-                    plchold_aref.name = current_words;
-                    break;
-                  case GDS_STRANS:
-                    plchold_aref.aref_transformation_flags = current_bitarr;
-                    plchold_aref.reflection = current_bitarr[15];
-                    break;
-                  case GDS_MAG:
-                    plchold_aref.aref_transformation_flags.set(
-                        13, 1); // Precaution incase other software forgot to
-                                // set bit
-                    plchold_aref.scale = current_B8Real[0];
-                    break;
-                  case GDS_ANGLE:
-                    plchold_aref.aref_transformation_flags.set(
-                        14, 1); // Precaution incase other software forgot to
-                                // set bit
-                    plchold_aref.angle = current_B8Real[0];
-                    break;
-                  case GDS_COLROW:
-                    plchold_aref.colCnt = current_integer[0];
-                    plchold_aref.rowCnt = current_integer[1];
-                    break;
-                  case GDS_XY:
-                    // confirm xy as pairs
-                    if (current_integer.size() % 2 == 0) {
-                      plchold_aref.xCor = current_integer[0];
-                      plchold_aref.yCor = current_integer[1];
-                      plchold_aref.xCorRow = current_integer[2];
-                      plchold_aref.yCorRow = current_integer[3];
-                      plchold_aref.xCorCol = current_integer[4];
-                      plchold_aref.yCorCol = current_integer[5];
-                    } else {
-                      cout << "Error: Missing X or Y co-ordinate" << endl;
-                    }
-                    break;
-                  case GDS_PROPATTR:
-                    plchold_aref.propattr = current_integer[0];
-                    break;
-                  case GDS_PROPVALUE:
-                    plchold_aref.propvalue = current_words;
-                    break;
-                  case GDS_ENDEL:
+/**
+ * [gdscpp::load_STR - Makes sure the structure at index is decoded]
+ * @param  index [Index of structure in gdscpp object]
+ * @return       [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdscpp::load_STR(unsigned int index)
+{
+  if (index >= STR.size())
+    return EXIT_FAILURE;
+  return STR[index].load();
+}
 
-                    break;
-                  default:
-                    cout << "Error: Unrecognized record." << endl;
-                    break;
-                  }
-                }
-              } while (current_GDSKey != GDS_ENDEL);
-              plchold_str.AREF.push_back(plchold_aref);
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ end secondary nest
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-              break;
-            case GDS_TEXT:
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ secondary nest [TEXT]
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-              // PLEX LAYER TEXTTYPE PRESENTATION PATHTYPE WIDTH STRANS MAG
-              // ANGLE XY STRING PROPATTR PROPVALUE
-              plchold_text.reset();
-              do {
-                current_readBlk = new char[2];
-                gdsFile.read(current_readBlk, 2);
+/**
+ * [gdscpp::load_all_STR - Decodes every structure still left in its file]
+ * @return [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdscpp::load_all_STR()
+{
+  int status = EXIT_SUCCESS;
+  for (auto &str_it : STR) {
+    if (str_it.load())
+      status = EXIT_FAILURE;
+  }
+  return status;
+}
 
-                current_sizeBlk = (((unsigned char)current_readBlk[0] << 8) |
-                                   (unsigned char)current_readBlk[1]);
+/**
+ * [gdscpp::resolve_heirarchy_and_bounding_boxes - Orders the structures of
+ * the reference graph from the leaves upwards with Kahn's algorithm. The
+ * bounding boxes are calculated in that order, so every referenced structure
+ * is done before its parents. Leaves are on the highest level, the top
+ * structures are on level 0.]
+ * @return [0 - Exit Success; 1 - Exit Failure (circular references)]
+ */
+int gdscpp::resolve_heirarchy_and_bounding_boxes()
+{
+  load_all_STR();
+  const gdsRefGraph &graph = reference_graph();
+  const unsigned int STR_count = graph.size();
 
-                gdsFile.seekg(-2, ios::cur);
-                current_readBlk = new char[current_sizeBlk];
-                gdsFile.read(current_readBlk, current_sizeBlk);
+  // Every box is calculated again, children before their parents
+  for (auto &state : STR_bbox)
+    state.valid = false;
 
-                if (GDSdistill(current_readBlk, current_GDSKey, current_bitarr,
-                               current_integer, current_B8Real,
-                               current_words)) {
-                  cout << "Error: Unable to read GDS file." << endl;
-                  break;
-                } else {
-                  switch (current_GDSKey) {
-                  case GDS_PLEX:
-                    plchold_text.plex = current_integer[0];
-                    break;
-                  case GDS_LAYER:
-                    plchold_text.layer = current_integer[0];
-                    break;
-                  case GDS_TEXTTYPE:
-                    plchold_text.text_type = current_integer[0];
-                    break;
-                  case GDS_PRESENTATION:
-                    plchold_text.presentation_flags = current_bitarr;
-                    break;
-                  case GDS_PATHTYPE:
-                    plchold_text.path_type = current_integer[0];
-                    break;
-                  case GDS_WIDTH:
-                    plchold_text.width = current_integer[0];
-                    break;
-                  case GDS_STRANS:
-                    plchold_text.text_transformation_flags = current_bitarr;
-                    break;
-                  case GDS_MAG:
-                    plchold_text.text_transformation_flags.set(
-                        13, 1); // Precaution incase other software forgot to
-                                // set bit
-                    plchold_text.scale =
-                        current_B8Real[0]; // TODO: Check that distill actually
-                                           // kicks outb8real here.
-                    break;
-                  case GDS_ANGLE:
-                    plchold_text.text_transformation_flags.set(
-                        14, 1); // Precaution incase other software forgot to
-                                // set bit
-                    plchold_text.angle = current_B8Real[0];
-                    break;
-                  case GDS_XY:
-                    // confirm xy as pairs
-                    if (current_integer.size() % 2 == 0) {
-                      // x append
-                      plchold_text.xCor = current_integer[0];
-                      // y append
-                      plchold_text.yCor = current_integer[1];
-                    } else {
-                      cout << "Error: Missing X or Y co-ordinate" << endl;
-                    }
-                    break;
-                  case GDS_STRING:
-                    plchold_text.textbody = current_words;
-                    break;
-                  case GDS_PROPATTR:
-                    plchold_text.propattr = current_integer[0];
-                    break;
-                  case GDS_PROPVALUE:
-                    plchold_text.propvalue = current_words;
-                    break;
-                  case GDS_ENDEL:
+  for (const auto &ref_name : graph.unresolved_names())
+    cout << "Warning: Reference to unknown structure \"" << ref_name << "\"."
+         << endl;
 
-                    break;
-                  default:
-                    cout << "Error: Unrecognized record." << endl;
-                    break;
-                  }
-                }
-              } while (current_GDSKey != GDS_ENDEL);
-              plchold_str.TEXT.push_back(plchold_text);
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ end secondary nest
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-              break;
-            case GDS_NODE:
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ secondary nest [NODE]
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-              // PLEX LAYER NODETYPE XY PROPATTR PROPVALUE
-              plchold_node.reset();
-              do {
-                current_readBlk = new char[2];
-                gdsFile.read(current_readBlk, 2);
+  // pending[i] - structures referenced by i with no bounding box yet
+  vector<unsigned int> pending(STR_count, 0);
+  for (unsigned int i = 0; i < STR_count; i++)
+    pending[i] = graph.children(i).size();
 
-                current_sizeBlk = (((unsigned char)current_readBlk[0] << 8) |
-                                   (unsigned char)current_readBlk[1]);
+  // ========== Part 1: Kahn's algorithm, leaves first ===========
+  // depth[i] - longest chain of references from structure i down to a leaf
+  vector<unsigned int> order;
+  vector<unsigned int> depth(STR_count, 0);
+  order.reserve(STR_count);
+  for (unsigned int i = 0; i < STR_count; i++) {
+    if (pending[i] == 0)
+      order.push_back(i);
+  }
+  for (unsigned int head = 0; head < order.size(); head++) {
+    unsigned int child = order[head];
+    int b_box[4];
+    calculate_STR_bounding_box(child, b_box);
+    for (const auto &parent : graph.parents(child)) {
+      if (depth[child] + 1 > depth[parent])
+        depth[parent] = depth[child] + 1;
+      if (--pending[parent] == 0)
+        order.push_back(parent);
+    }
+  }
 
-                gdsFile.seekg(-2, ios::cur);
-                current_readBlk = new char[current_sizeBlk];
-                gdsFile.read(current_readBlk, current_sizeBlk);
+  int status = EXIT_SUCCESS;
+  if (order.size() < STR_count) {
+    cout << "Error: Circular structure references through:";
+    for (unsigned int i = 0; i < STR_count; i++) {
+      if (pending[i] > 0)
+        cout << " " << STR[i].name;
+    }
+    cout << endl;
+    status = EXIT_FAILURE;
+  }
 
-                if (GDSdistill(current_readBlk, current_GDSKey, current_bitarr,
-                               current_integer, current_B8Real,
-                               current_words)) {
-                  cout << "Error: Unable to read GDS file." << endl;
-                  break;
-                } else {
-                  switch (current_GDSKey) {
-                  case GDS_PLEX:
-                    plchold_node.plex = current_integer[0];
-                    break;
-                  case GDS_LAYER:
-                    plchold_node.layer = current_integer[0];
-                    break;
-                  case GDS_NODETYPE:
-                    plchold_node.nodetype = current_integer[0];
-                    break;
-                  case GDS_XY:
-                    // confirm xy as pairs
-                    if (current_integer.size() % 2 == 0) {
-                      current_int_iter = current_integer.begin();
-                      odd_state = false;
-                      while (current_int_iter != current_integer.end()) {
-                        if (odd_state == false) {
-                          // x append
-                          plchold_node.xCor.push_back(*current_int_iter);
-                        } else {
-                          // y append
-                          plchold_node.yCor.push_back(*current_int_iter);
-                        }
-                        odd_state = !odd_state;
-                        current_int_iter++;
-                      }
-                    } else {
-                      cout << "Error: XY co_ordinates uneven" << endl;
-                    }
-                    break;
-                  case GDS_PROPATTR:
-                    plchold_node.propattr = current_integer[0];
-                    break;
-                  case GDS_PROPVALUE:
-                    plchold_node.propvalue = current_words;
-                    break;
-                  case GDS_ENDEL:
+  // ========== Part 2: Set heirarchy into structures ===========
+  unsigned int max_depth = 0;
+  for (const auto &i : order) {
+    if (depth[i] > max_depth)
+      max_depth = depth[i];
+  }
+  for (unsigned int i = 0; i < STR_count; i++) {
+    // Structures in a cycle are left on the top level
+    STR[i].heirarchical_level = pending[i] > 0 ? 0 : max_depth - depth[i];
+  }
+  highest_heirarchical_level = max_depth;
+  return status;
+}
 
-                    break;
-                  default:
-                    cout << "Error: Unrecognized record." << endl;
-                    break;
-                  }
-                }
-              } while (current_GDSKey != GDS_ENDEL);
-              plchold_str.NODE.push_back(plchold_node);
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ end secondary nest
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-              break;
-            case GDS_BOX:
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ secondary nest [BOX]
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-              // PLEX LAYER BOXTYPE XY PROPATTR PROPVALUE
-              plchold_box.reset();
-              do {
-                current_readBlk = new char[2];
-                gdsFile.read(current_readBlk, 2);
+/**
+ * [gdscpp::check name]
+ * @param  name       [Set which name will be compared against]
+ * @param  ref_vector [Vector to search through]
+ * @return            [true - Name allowed; false - name not allowed]
+ */
+bool gdscpp::check_name(const string &name, const vector<string> &ref_vector)
+{
+  if (find(ref_vector.begin(), ref_vector.end(), name) != ref_vector.end())
+    return true;
+  else
+    return false;
+}
 
-                current_sizeBlk = (((unsigned char)current_readBlk[0] << 8) |
-                                   (unsigned char)current_readBlk[1]);
+/**
+ * [gdscpp::calculate_STR_bounding_box - Returns the bounding box of the
+ * structure at the specified index. The result is cached until elements are
+ * added to or removed from the structure, or one below it, (see gdsOwner) or
+ * invalidate_bounding_box is called. Both mark the structure and every
+ * structure above it as out of date right away.]
+ * @param  structure_index  [Index of structure in gdscpp object]
+ * @param  destination      [Vector to save results in]
+ * @return                  [0 - Function completed; 1 - No such structure]
+ */
+int gdscpp::calculate_STR_bounding_box(int structure_index, int *destination)
+{
+  if (structure_index < 0 || structure_index >= (int)STR.size())
+    return EXIT_FAILURE;
+  sync_STR_nodes();
+  // Cached boxes must know their parents, see invalidate_bounding_box
+  index_STR_references(structure_index);
 
-                gdsFile.seekg(-2, ios::cur);
-                current_readBlk = new char[current_sizeBlk];
-                gdsFile.read(current_readBlk, current_sizeBlk);
+  bboxState &state = STR_bbox[structure_index];
+  if (!state.valid && !state.busy) {
+    // Restored boxes leave their structure in the file until now
+    load_STR(structure_index);
+    int b_box[4] = {0, 0, 0, 0};
+    state.busy = true;
+    compute_STR_bounding_box(structure_index, b_box);
+    STR_bbox[structure_index].busy = false;
+    if (!equal(b_box, b_box + 4, STR[structure_index].bounding_box)) {
+      invalidate_bounding_box(structure_index);
+      copy(b_box, b_box + 4, STR[structure_index].bounding_box);
+    }
+    STR_bbox[structure_index].valid = true;
+  }
+  // A structure in the middle of its own calculation (circular references)
+  // gives the box it had before
+  copy(STR[structure_index].bounding_box,
+       STR[structure_index].bounding_box + 4, destination);
+  return EXIT_SUCCESS;
+}
 
-                if (GDSdistill(current_readBlk, current_GDSKey, current_bitarr,
-                               current_integer, current_B8Real,
-                               current_words)) {
-                  cout << "Error: Unable to read GDS file." << endl;
-                  break;
-                } else {
-                  switch (current_GDSKey) {
-                  case GDS_PLEX:
-                    plchold_box.plex = current_integer[0];
-                    break;
-                  case GDS_LAYER:
-                    plchold_box.layer = current_integer[0];
-                    break;
-                  case GDS_BOXTYPE:
-                    plchold_box.boxtype = current_integer[0];
-                    break;
-                  case GDS_XY:
-                    // confirm xy as pairs
-                    if (current_integer.size() % 2 == 0) {
-                      current_int_iter = current_integer.begin();
-                      odd_state = false;
-                      while (current_int_iter != current_integer.end()) {
-                        if (odd_state == false) {
-                          // x append
-                          plchold_box.xCor.push_back(*current_int_iter);
-                        } else {
-                          // y append
-                          plchold_box.yCor.push_back(*current_int_iter);
-                        }
-                        odd_state = !odd_state;
-                        current_int_iter++;
-                      }
-                    } else {
-                      cout << "Error: XY co_ordinates uneven" << endl;
-                    }
-                    break;
-                  case GDS_PROPATTR:
-                    plchold_box.propattr = current_integer[0];
-                    break;
-                  case GDS_PROPVALUE:
-                    plchold_box.propvalue = current_words;
-                    break;
-                  case GDS_ENDEL:
+/**
+ * [gdscpp::reference_bounding_box - Bounding box of a referenced structure,
+ * from the cache when possible]
+ * @param  structure_index  [Index of structure in gdscpp object]
+ * @return                  [xmin, ymin, xmax, ymax of the structure]
+ */
+const int *gdscpp::reference_bounding_box(int structure_index)
+{
+  int b_box[4];
+  calculate_STR_bounding_box(structure_index, b_box);
+  return STR[structure_index].bounding_box;
+}
 
-                    break;
-                  default:
-                    cout << "Error: Unrecognized record." << endl;
-                    break;
-                  }
-                }
-              } while (current_GDSKey != GDS_ENDEL);
-              plchold_str.BOX.push_back(plchold_box);
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ end secondary nest
-              //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-              break;
-            case GDS_ENDSTR:
+/**
+ * [gdscpp::restore_bounding_box - Takes a bounding box that was calculated
+ * before, e.g. kept on disk, as the cached box of a structure. It counts as
+ * current until elements are added to the structure or it is invalidated.
+ * Loading a lazily imported structure does not count as adding elements.]
+ * @param  structure_index  [Index of structure in gdscpp object]
+ * @param  b_box            [xmin, ymin, xmax, ymax of the structure]
+ * @return                  [0 - Exit Success; 1 - No such structure]
+ */
+int gdscpp::restore_bounding_box(int structure_index, const int *b_box)
+{
+  if (structure_index < 0 || structure_index >= (int)STR.size())
+    return EXIT_FAILURE;
+  sync_STR_nodes();
+  index_STR_references(structure_index);
 
-              break;
-            default:
-              cout << "Error: Unrecognized record." << endl;
-              break;
-            }
-          }
-        } while (current_GDSKey != GDS_ENDSTR);
-        setSTR(plchold_str);
-        //@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ END FIRST NEST
-        //@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
-        break;
-      case GDS_ENDLIB:
-        cout << "Reached end of library." << endl;
-        break;
+  if (!equal(b_box, b_box + 4, STR[structure_index].bounding_box)) {
+    invalidate_bounding_box(structure_index);
+    copy(b_box, b_box + 4, STR[structure_index].bounding_box);
+  }
+  STR_bbox[structure_index].valid = true;
+  return EXIT_SUCCESS;
+}
 
-      default:
-        cout << "Error: Unrecognized record." << endl;
-        break;
-      }
-    }
-  } while (current_GDSKey != GDS_ENDLIB);
-  STR_Lookup.insert(
-      {"\0", 1000000000}); // Add null character to structure map with index 1
-                           // billion. Unlikely to be 1 billion structures
-  delete[] current_readBlk;
-  // resolve_heirarchy_and_bounding_boxes();
-  cout << "GDS file successfully imported." << endl;
-  return 0;
+/**
+ * [gdscpp::restore_bounding_box - Same as above for a structure that may
+ * still be in its file. The references it had when the box was calculated are
+ * taken as its references, so it stays in its file until its elements are
+ * needed.]
+ * @param  structure_index  [Index of structure in gdscpp object]
+ * @param  b_box            [xmin, ymin, xmax, ymax of the structure]
+ * @param  references       [Names of its SREFs and AREFs, one per reference]
+ * @return                  [0 - Exit Success; 1 - No such structure]
+ */
+int gdscpp::restore_bounding_box(int structure_index, const int *b_box,
+                                 const vector<gdsName> &references)
+{
+  if (structure_index < 0 || structure_index >= (int)STR.size())
+    return EXIT_FAILURE;
+  sync_STR_nodes();
+  if (!STR_indexed[structure_index] && !STR[structure_index].is_loaded()) {
+    STR_indexed[structure_index] = true;
+    for (const auto &ref_name : references)
+      STR_graph.add_reference(structure_index, ref_name);
+  }
+  return restore_bounding_box(structure_index, b_box);
 }
 
 /**
- * [gdscpp::resolve_heirarchy_and_bounding_boxes]
- * Populates vector<vector<string>> heirarchy
- * then uses heirarchy to set heirarchy property of structures.
- * Finally sets the bounding boxes of each structure.
- * @return          [0 - Exit Success; 1 - Exit Failure]
+ * [gdscpp::invalidate_bounding_box - Marks the cached bounding box of a
+ * structure, and of every structure above it, as out of date. Needed after
+ * elements of a structure in the library were changed in place, the element
+ * containers take care of adding and removing them.]
+ * @param  structure_index  [Index of structure in gdscpp object]
  */
-int gdscpp::resolve_heirarchy_and_bounding_boxes()
+void gdscpp::invalidate_bounding_box(unsigned int structure_index)
 {
-  // ========== Part 1: Populate heirarchy ===========
-  int heirarchical_levels = 0;
-  vector<vector<string>> heirarchy;
-  heirarchy.clear();
-  vector<string> string_vector;
-  vector<string> allowed_structures_list; // Allowes structure names
-  heirarchy.push_back(string_vector);     // Creates first level
-  vector<vector<string>>::iterator heir_iter = heirarchy.begin();
-  auto struct_it = STR.begin();
-  while (struct_it != STR.end()) {
-    if ((struct_it->SREF.empty() && (struct_it->AREF.empty()))) {
-      heir_iter = heirarchy.begin();
-      heir_iter->push_back(struct_it->name);
-    } else {
-      heir_iter = heirarchy.begin();
-      heir_iter++;
-      if (heir_iter == heirarchy.end()) {
-        heir_iter--;
-        string_vector.push_back(struct_it->name);
-        heirarchy.push_back(string_vector); // Creates second level
-        string_vector.clear();
-        heir_iter = heirarchy.end(); // | Point back to last line of heirarchy.
-        heir_iter--;                 // |
-      } else {
-        heir_iter->push_back(struct_it->name);
-      }
+  if (structure_index >= STR_bbox.size())
+    return;
+  // Runs for every element added to a structure in a library, the common
+  // case of parents already out of date allocates nothing
+  vector<unsigned int> stale;
+  STR_bbox[structure_index].valid = false;
+  for (const auto &parent : STR_graph.parents(structure_index)) {
+    if (parent < STR_bbox.size() && STR_bbox[parent].valid) {
+      STR_bbox[parent].valid = false;
+      stale.push_back(parent);
     }
-    struct_it++;
   }
-  // At this stage all structures that use references are on level 2.
-  // We need to separate those that reference secondary structures and so on
-  // If there are no references there will only be one level (no heirarchy).
-  if (heirarchy.size() > 1) {
-    bool nothing_added = false;
-    while ((nothing_added == false) && (heir_iter != heirarchy.end())) {
-      // Add the previous level to allowable names
-      heir_iter--; // Go to previous level to fetch allowed names
-      auto structures_iterator = heir_iter->begin();
-      while (structures_iterator != heir_iter->end()) {
-        allowed_structures_list.push_back(*structures_iterator);
-        structures_iterator++;
+  while (!stale.empty()) {
+    unsigned int child = stale.back();
+    stale.pop_back();
+    for (const auto &parent : STR_graph.parents(child)) {
+      if (parent < STR_bbox.size() && STR_bbox[parent].valid) {
+        STR_bbox[parent].valid = false;
+        stale.push_back(parent);
       }
-      // Compare every name on current level's references to list of allowable
-      // names
-      heir_iter++; // Return to current level to compare this level's names vs
-                   // allowed
-      structures_iterator = heir_iter->begin();
-      int names_shifted = 0;
-      while (structures_iterator !=
-             heir_iter->end()) // For each name in the set
-      {
-        int fetch_index =
-            STR_Lookup[*structures_iterator]; // Get what STR vector index
-                                              // *structures_iterator references
-        vector<gdsSREF> srefs = STR[fetch_index].SREF;
-        vector<gdsAREF> arefs = STR[fetch_index].AREF;
-        auto SREF_it = srefs.begin();
-        bool failed = false;
-        while (SREF_it != srefs.end()) {
-          if (!check_name(SREF_it->name, allowed_structures_list)) {
-            failed = true;
-            break;
-          }
-          SREF_it++;
-        }
-        auto AREF_it = arefs.begin();
-        while (AREF_it != arefs.end()) {
-          if (!check_name(AREF_it->name, allowed_structures_list)) {
-            failed = true;
-            break;
-          }
-          AREF_it++;
-        }
-        // if any of the SREF or aref of target structure fail test, the
-        // structure must be moved down
-        if (failed == true) {
-          string struct_to_move = *structures_iterator;
-          structures_iterator = heir_iter->erase(structures_iterator);
-          heir_iter++; // Move to level below
-          if (heir_iter ==
-              heirarchy.end()) // if level below doesn't exist, make it.
-          {
-            heir_iter--; // Reverse iterator to last element.
-            string_vector.push_back(struct_to_move);
-            heirarchy.push_back(string_vector); // Push back the set
-            string_vector.clear(); // Clear the temporary set container
-          } else {
-            string_vector.push_back(
-                struct_to_move); // Next level already exists, simply add the
-                                 // word
-          }
-          heir_iter = heirarchy.end(); // |
-          heir_iter--;                 // | Return to current level.
-          heir_iter--;                 // |
-          names_shifted++;
-        } else {
-          structures_iterator++;
-        }
-      }
-      if (names_shifted == 0) {
-        nothing_added = true;
-      }
-      heir_iter++; // Move onto next level and repeat
     }
-    // Reverse order of heirarchy function
-    reverse(heirarchy.begin(), heirarchy.end());
   }
-  // ========== Part 2: Set heirarchy into structures ===========
-  // ==========      Also calculate bounding boxes    ===========
-  heir_iter = heirarchy.end();
-  heir_iter--;
-  while (!(heir_iter < heirarchy.begin())) {
-    auto structure_iterator = heir_iter->begin();
-    while (structure_iterator != heir_iter->end()) {
-      int STR_index = STR_Lookup[*structure_iterator];
-      STR[STR_index].heirarchical_level = heir_iter - heirarchy.begin();
-      int b_box[4] = {0, 0, 0, 0};
-      calculate_STR_bounding_box(STR_index, b_box);
-      STR[STR_index].bounding_box[0] = b_box[0];
-      STR[STR_index].bounding_box[1] = b_box[1];
-      STR[STR_index].bounding_box[2] = b_box[2];
-      STR[STR_index].bounding_box[3] = b_box[3];
-      if (STR[STR_index].heirarchical_level > highest_heirarchical_level)
-        highest_heirarchical_level = STR[STR_index].heirarchical_level;
-      structure_iterator++;
-    }
-    heir_iter--;
+}
+
+/**
+ * [orient_box - Places a bounding box with one of the 8 Manhattan
+ * orientations of gdsSREFcolumns. Quarter turns map the box onto a box, so
+ * only swaps and negations are needed.]
+ * @param box         [xmin, ymin, xmax, ymax; replaced by the placed box]
+ * @param orientation [Bits 0-1 quarter turns, bit 2 reflection]
+ * @param xCor        [X-coordinate of the reference]
+ * @param yCor        [Y-coordinate of the reference]
+ */
+static void orient_box(int *box, unsigned int orientation, int xCor, int yCor)
+{
+  int x_1 = box[0], y_1 = box[1];
+  int x_2 = box[2], y_2 = box[3];
+  if (orientation & 4) { // Reflect about x-axis
+    y_1 = -box[3];
+    y_2 = -box[1];
   }
-  return EXIT_SUCCESS;
+  for (unsigned int turn = 0; turn < (orientation & 3); turn++) {
+    int rotated[4] = {-y_2, x_1, -y_1, x_2};
+    x_1 = rotated[0];
+    y_1 = rotated[1];
+    x_2 = rotated[2];
+    y_2 = rotated[3];
+  }
+  box[0] = x_1 + xCor;
+  box[1] = y_1 + yCor;
+  box[2] = x_2 + xCor;
+  box[3] = y_2 + yCor;
 }
 
 /**
- * [gdscpp::check name]
- * @param  name       [Set which name will be compared against]
- * @param  ref_vector [Vector to search through]
- * @return            [true - Name allowed; false - name not allowed]
+ * [transform_box - Places a bounding box with the reflection, scale and
+ * angle of a reference that is not Manhattan]
+ * @param box [xmin, ymin, xmax, ymax; replaced by the placed box]
+ * @param ref [The reference]
  */
-bool gdscpp::check_name(string name, vector<string> ref_vector)
+static void transform_box(int *box, const gdsSREF &ref)
 {
-  if (find(ref_vector.begin(), ref_vector.end(), name) != ref_vector.end())
-    return true;
-  else
-    return false;
+  if (ref.reflection == true) // Reflect about x-axis
+  {
+    // Reflect the box about x-axis and swap because max becomes min
+    int placeholder = box[1];
+    box[1] = -1 * box[3];
+    box[3] = -1 * placeholder;
+  }
+  double x_1 = box[0];
+  double y_1 = box[1];
+  double x_2 = box[2];
+  double y_2 = box[3];
+  if (ref.scale != 1) // Multiply by scale factor
+  {
+    x_1 = x_1 * ref.scale;
+    x_2 = x_2 * ref.scale;
+    y_1 = y_1 * ref.scale;
+    y_2 = y_2 * ref.scale;
+  }
+  // Rotate
+  int angle = ref.angle;
+  if (angle > 0) {
+    while (angle >= 360) {
+      angle = angle - 360;
+    }
+    double x_1_new = x_1 * cos(angle * 3.141592653589 / 180) -
+                     y_1 * sin(angle * 3.141592653589 / 180);
+    double y_1_new = x_1 * sin(angle * 3.141592653589 / 180) +
+                     y_1 * cos(angle * 3.141592653589 / 180);
+    double x_2_new = x_2 * cos(angle * 3.141592653589 / 180) -
+                     y_2 * sin(angle * 3.141592653589 / 180);
+    double y_2_new = x_2 * sin(angle * 3.141592653589 / 180) +
+                     y_2 * cos(angle * 3.141592653589 / 180);
+    x_1 = x_1_new;
+    y_1 = y_1_new;
+    x_2 = x_2_new;
+    y_2 = y_2_new;
+    // convert back to vertical box by getting the new minimum and maximum
+    if (x_1 > x_2) {
+      double temp_holder = x_2;
+      x_2 = x_1;
+      x_1 = temp_holder;
+    }
+    if (y_1 > y_2) {
+      double temp_holder2 = y_2;
+      y_2 = y_1;
+      y_1 = temp_holder2;
+    }
+  }
+  // Offset shape according to translation
+  box[0] = (int)(round(x_1)) + ref.xCor;
+  box[1] = (int)(round(y_1)) + ref.yCor;
+  box[2] = (int)(round(x_2)) + ref.xCor;
+  box[3] = (int)(round(y_2)) + ref.yCor;
 }
 
 /**
- * [gdscpp::calculate_STR_bounding_box - Calculates the bounding box
+ * [gdscpp::compute_STR_bounding_box - Calculates the bounding box
  *  for the structure at the specified index. Places result in destination
  * array.]
  * @param  structure_index  [Index of structure in gdscpp object]
  * @param  destination      [Vector to save results in]
  * @return                  [0 - Function completed]
  */
-int gdscpp::calculate_STR_bounding_box(int structure_index, int *destination)
+int gdscpp::compute_STR_bounding_box(int structure_index, int *destination)
 {
-  int bound_box[4]; // xmin, ymin, xmax, ymax of structure
+  int bound_box[4] = {0, 0, 0, 0}; // xmin, ymin, xmax, ymax of structure
   bool box_initialized = false;
   // ======================= Look through boundaries =======================
   auto boundary_iterator = STR[structure_index].BOUNDARY.begin();
@@ -883,6 +664,19 @@ int gdscpp::calculate_STR_bounding_box(int structure_index, int *destination)
     }
     boundary_iterator++;
   }
+  // ==================== Look through arena boundaries =====================
+  const gdsPointArena &boundaries = STR[structure_index].BOUNDARYarena;
+  for (size_t i = 0; i < boundaries.points.size(); i += 2) {
+    if (box_initialized == false) {
+      bound_box[0] = bound_box[2] = boundaries.points[i];
+      bound_box[1] = bound_box[3] = boundaries.points[i + 1];
+      box_initialized = true;
+    }
+    bound_box[0] = min(bound_box[0], boundaries.points[i]);
+    bound_box[1] = min(bound_box[1], boundaries.points[i + 1]);
+    bound_box[2] = max(bound_box[2], boundaries.points[i]);
+    bound_box[3] = max(bound_box[3], boundaries.points[i + 1]);
+  }
   // ========================= Look through boxes ==========================
   auto box_iter = STR[structure_index].BOX.begin();
   while (box_iter != STR[structure_index].BOX.end()) {
@@ -909,13 +703,17 @@ int gdscpp::calculate_STR_bounding_box(int structure_index, int *destination)
     // Neglect path type. Simplify work by assuming max half-width protrusion.
     // Worst case scenario is that the bounding box is ever so slightly
     // bigger than actually needed for a flat-cap situation.
+    if (path_iter->xCor.empty() || path_iter->yCor.empty()) {
+      path_iter++;
+      continue;
+    }
     int offset = (int)(round(((double)path_iter->width * 0.5)));
-    int local_bbox[4] = {
-        (*min_element(path_iter->xCor.begin(), path_iter->xCor.end()) - offset),
-        (*min_element(path_iter->yCor.begin(), path_iter->yCor.end()) - offset),
-        (*max_element(path_iter->xCor.begin(), path_iter->xCor.end()) + offset),
-        (*max_element(path_iter->yCor.begin(), path_iter->yCor.end()) +
-         offset)};
+    auto x_range =
+        minmax_element(path_iter->xCor.begin(), path_iter->xCor.end());
+    auto y_range =
+        minmax_element(path_iter->yCor.begin(), path_iter->yCor.end());
+    int local_bbox[4] = {*x_range.first - offset, *y_range.first - offset,
+                         *x_range.second + offset, *y_range.second + offset};
     if (box_initialized == false) {
       bound_box[0] = local_bbox[0];
       bound_box[1] = local_bbox[1];
@@ -933,21 +731,52 @@ int gdscpp::calculate_STR_bounding_box(int structure_index, int *destination)
       bound_box[3] = local_bbox[3];
     path_iter++;
   }
+  // ====================== Look through arena paths =======================
+  const gdsPointArena &paths = STR[structure_index].PATHarena;
+  for (size_t i = 0; i < paths.size(); i++) {
+    if (paths.point_count(i) == 0)
+      continue;
+    // Same half-width protrusion as the paths above
+    int offset = (int)(round(((double)paths.width[i] * 0.5)));
+    const int *corXY = paths.xy(i);
+    int local_bbox[4] = {corXY[0], corXY[1], corXY[0], corXY[1]};
+    for (size_t j = 1; j < paths.point_count(i); j++) {
+      local_bbox[0] = min(local_bbox[0], corXY[j * 2]);
+      local_bbox[1] = min(local_bbox[1], corXY[j * 2 + 1]);
+      local_bbox[2] = max(local_bbox[2], corXY[j * 2]);
+      local_bbox[3] = max(local_bbox[3], corXY[j * 2 + 1]);
+    }
+    local_bbox[0] -= offset;
+    local_bbox[1] -= offset;
+    local_bbox[2] += offset;
+    local_bbox[3] += offset;
+    if (box_initialized == false) {
+      bound_box[0] = local_bbox[0];
+      bound_box[1] = local_bbox[1];
+      bound_box[2] = local_bbox[2];
+      bound_box[3] = local_bbox[3];
+      box_initialized = true;
+    }
+    bound_box[0] = min(bound_box[0], local_bbox[0]);
+    bound_box[1] = min(bound_box[1], local_bbox[1]);
+    bound_box[2] = max(bound_box[2], local_bbox[2]);
+    bound_box[3] = max(bound_box[3], local_bbox[3]);
+  }
   // ================== Look through structure references ==================
   auto SREF_iter = STR[structure_index].SREF.begin();
   while (SREF_iter != STR[structure_index].SREF.end()) {
     // Warn user if specified structure's bounding box is not yet initialized
-    int target_structure_index = STR_Lookup[SREF_iter->name];
-    if (target_structure_index == 1000000000) {
-      cout << "Error: reference to structure with no name." << endl;
-      cout << "Terminating SREF bounding box check." << endl;
-      break;
+    int target_structure_index = STR_index(SREF_iter->name);
+    if (target_structure_index < 0) {
+      SREF_iter++; // Unknown structure, nothing to add
+      continue;
     }
     int referred_bound_box[4];
-    referred_bound_box[0] = STR[target_structure_index].bounding_box[0];
-    referred_bound_box[1] = STR[target_structure_index].bounding_box[1];
-    referred_bound_box[2] = STR[target_structure_index].bounding_box[2];
-    referred_bound_box[3] = STR[target_structure_index].bounding_box[3];
+    const int *ref_box = reference_bounding_box(target_structure_index);
+    referred_bound_box[0] = ref_box[0];
+    referred_bound_box[1] = ref_box[1];
+    referred_bound_box[2] = ref_box[2];
+    referred_bound_box[3] = ref_box[3];
 
     if ((referred_bound_box[0] == 0) && (referred_bound_box[1] == 0) &&
         (referred_bound_box[2] == 0) && (referred_bound_box[3] == 0)) {
@@ -965,59 +794,11 @@ int gdscpp::calculate_STR_bounding_box(int structure_index, int *destination)
       // cout << "Warning: Inaccuracy due to structures not being initialized."
       //      << endl;
     }
-    if (SREF_iter->reflection == true) // Reflect about x-axis
-    {
-      // Reflect the box about x-axis and swap because max becomes min
-      int placeholder = referred_bound_box[1];
-      referred_bound_box[1] = -1 * referred_bound_box[3];
-      referred_bound_box[3] = -1 * placeholder;
-    }
-    double x_1 = referred_bound_box[0];
-    double y_1 = referred_bound_box[1];
-    double x_2 = referred_bound_box[2];
-    double y_2 = referred_bound_box[3];
-    if (SREF_iter->scale != 1) // Multiply by scale factor
-    {
-      x_1 = x_1 * SREF_iter->scale;
-      x_2 = x_2 * SREF_iter->scale;
-      y_1 = y_1 * SREF_iter->scale;
-      y_2 = y_2 * SREF_iter->scale;
-    }
-    // Rotate
-    int angle = SREF_iter->angle;
-    if (angle > 0) {
-      while (angle >= 360) {
-        angle = angle - 360;
-      }
-      double x_1_new = x_1 * cos(angle * 3.141592653589 / 180) -
-                       y_1 * sin(angle * 3.141592653589 / 180);
-      double y_1_new = x_1 * sin(angle * 3.141592653589 / 180) +
-                       y_1 * cos(angle * 3.141592653589 / 180);
-      double x_2_new = x_2 * cos(angle * 3.141592653589 / 180) -
-                       y_2 * sin(angle * 3.141592653589 / 180);
-      double y_2_new = x_2 * sin(angle * 3.141592653589 / 180) +
-                       y_2 * cos(angle * 3.141592653589 / 180);
-      x_1 = x_1_new;
-      y_1 = y_1_new;
-      x_2 = x_2_new;
-      y_2 = y_2_new;
-      // convert back to vertical box by getting the new minimum and maximum
-      if (x_1 > x_2) {
-        double temp_holder = x_2;
-        x_2 = x_1;
-        x_1 = temp_holder;
-      }
-      if (y_1 > y_2) {
-        double temp_holder2 = y_2;
-        y_2 = y_1;
-        y_1 = temp_holder2;
-      }
-    }
-    // Offset shape according to translation
-    referred_bound_box[0] = (int)(round(x_1)) + SREF_iter->xCor;
-    referred_bound_box[1] = (int)(round(y_1)) + SREF_iter->yCor;
-    referred_bound_box[2] = (int)(round(x_2)) + SREF_iter->xCor;
-    referred_bound_box[3] = (int)(round(y_2)) + SREF_iter->yCor;
+    if (SREF_iter->orientation >= 0)
+      orient_box(referred_bound_box, SREF_iter->orientation, SREF_iter->xCor,
+                 SREF_iter->yCor);
+    else
+      transform_box(referred_bound_box, *SREF_iter);
 
     if (box_initialized == false) {
       bound_box[0] = referred_bound_box[0];
@@ -1038,21 +819,46 @@ int gdscpp::calculate_STR_bounding_box(int structure_index, int *destination)
 
     SREF_iter++;
   }
+  // =============== Look through compact structure references ==============
+  const gdsSREFcolumns &cols = STR[structure_index].SREFcols;
+  for (size_t i = 0; i < cols.size(); i++) {
+    int target_structure_index = STR_index(cols.name[i]);
+    if (target_structure_index < 0)
+      continue; // Unknown structure, nothing to add
+    const int *ref_box = reference_bounding_box(target_structure_index);
+    int referred_bound_box[4] = {ref_box[0], ref_box[1], ref_box[2],
+                                 ref_box[3]};
+    orient_box(referred_bound_box, cols.transform[i], cols.xCor[i],
+               cols.yCor[i]);
+    if (box_initialized == false) {
+      bound_box[0] = referred_bound_box[0];
+      bound_box[1] = referred_bound_box[1];
+      bound_box[2] = referred_bound_box[2];
+      bound_box[3] = referred_bound_box[3];
+      box_initialized = true;
+    }
+    if (referred_bound_box[0] < bound_box[0])
+      bound_box[0] = referred_bound_box[0];
+    if (referred_bound_box[1] < bound_box[1])
+      bound_box[1] = referred_bound_box[1];
+    if (referred_bound_box[2] > bound_box[2])
+      bound_box[2] = referred_bound_box[2];
+    if (referred_bound_box[3] > bound_box[3])
+      bound_box[3] = referred_bound_box[3];
+  }
   // ==================== Look through array references ====================
   auto AREF_iter = STR[structure_index].AREF.begin();
   while (AREF_iter != STR[structure_index].AREF.end()) {
     // Warn user if specified structure's bounding box is not yet initialized
-    int target_structure_index = STR_Lookup[AREF_iter->name];
-    if (target_structure_index == 1000000000) {
-      cout << "Error: reference to structure with no name." << endl;
-      cout << "Terminating AREF bounding box check." << endl;
-      break;
+    int target_structure_index = STR_index(AREF_iter->name);
+    if (target_structure_index < 0) {
+      AREF_iter++; // Unknown structure, nothing to add
+      continue;
     }
     // fetch bounding box of the array reference structure
-    int a_referred_bound_box[4] = {STR[target_structure_index].bounding_box[0],
-                                   STR[target_structure_index].bounding_box[1],
-                                   STR[target_structure_index].bounding_box[2],
-                                   STR[target_structure_index].bounding_box[3]};
+    const int *ref_box = reference_bounding_box(target_structure_index);
+    int a_referred_bound_box[4] = {ref_box[0], ref_box[1], ref_box[2],
+                                   ref_box[3]};
     if ((a_referred_bound_box[0] == 0) && (a_referred_bound_box[1] == 0) &&
         (a_referred_bound_box[2] == 0) && (a_referred_bound_box[3] == 0)) {
       // cout << "Warning: Structure being referenced for AREF does not have an "
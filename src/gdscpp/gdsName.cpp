@@ -0,0 +1,102 @@
+/**
+ * Author:      J.F. de Villiers & H.F. Herbst
+ * Origin:  		E&E Engineering - Stellenbosch University
+ * For:					Supertools, Coldflux Project - IARPA
+ * Created: 		2019-08-26
+ * Modified:
+ * license:     MIT License
+ * Description: Interned structure names, each distinct name is stored once
+ *              and referred to by a small integer ID.
+ * File:				gdsName.cpp
+ */
+
+// ========================= Includes =========================
+#include "gdscpp/gdsName.hpp"
+#include <atomic>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+// ====================== Miscellanious =======================
+using namespace std;
+
+// The names are kept in fixed size blocks that never move, so an ID can be
+// turned back into its name without taking the lock.
+static const uint32_t nameBlkBits = 16;
+static const uint32_t nameBlkSize = 1u << nameBlkBits;
+static const uint32_t nameBlkCount = 1u << 16;
+
+namespace
+{
+struct gdsNameTable {
+  mutex lock;
+  unordered_map<string_view, uint32_t> lookup;
+  atomic<string *> blocks[nameBlkCount] = {};
+  atomic<uint32_t> count{0};
+
+  gdsNameTable() { intern(""); };
+
+  uint32_t intern(const string &name)
+  {
+    lock_guard<mutex> guard(lock);
+    auto found = lookup.find(name);
+    if (found != lookup.end())
+      return found->second;
+
+    uint32_t nameID = count.load(memory_order_relaxed);
+    string *blk = blocks[nameID >> nameBlkBits].load(memory_order_relaxed);
+    if (blk == nullptr) {
+      blk = new string[nameBlkSize];
+      blocks[nameID >> nameBlkBits].store(blk, memory_order_release);
+    }
+    string &stored = blk[nameID & (nameBlkSize - 1)];
+    stored = name;
+    lookup.insert({string_view(stored), nameID});
+    count.store(nameID + 1, memory_order_release);
+    return nameID;
+  };
+};
+
+gdsNameTable &nameTable()
+{
+  static gdsNameTable *table = new gdsNameTable; // Lives until the very end
+  return *table;
+}
+
+// Structures tend to repeat the same reference, skip the table for those
+thread_local uint32_t lastID = 0;
+} // namespace
+
+// ====================== Function Code =======================
+/**
+ * [gdsIntern - Finds the ID of a name, adding the name if it is new]
+ * @param  name [The structure name]
+ * @return      [The ID of the name]
+ */
+uint32_t gdsIntern(const string &name)
+{
+  if (gdsNameOf(lastID) == name)
+    return lastID;
+  lastID = nameTable().intern(name);
+  return lastID;
+}
+
+/**
+ * [gdsNameOf - Returns the name belonging to an ID]
+ * @param  nameID [ID from gdsIntern]
+ * @return        [The structure name]
+ */
+const string &gdsNameOf(uint32_t nameID)
+{
+  const string *blk =
+      nameTable().blocks[nameID >> nameBlkBits].load(memory_order_acquire);
+  return blk[nameID & (nameBlkSize - 1)];
+}
+
+/**
+ * [gdsNameCount - Number of names in the table, all IDs are below this]
+ * @return [Number of names]
+ */
+uint32_t gdsNameCount()
+{
+  return nameTable().count.load(memory_order_acquire);
+}
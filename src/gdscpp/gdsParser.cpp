@@ -28,7 +28,7 @@ using namespace std;
  * @param  words   [A string value]
  * @return         [0 - Exit Success; 1 - Exit Failure]
  */
-int GDSdistill(char *recIn, uint32_t &GDSKey, bitset<16> &bitarr,
+int GDSdistill(const char *recIn, uint32_t &GDSKey, bitset<16> &bitarr,
                vector<int> &integer, vector<double> &B8Real, string &words)
 {
   uint32_t sizeBlk;
@@ -36,20 +36,22 @@ int GDSdistill(char *recIn, uint32_t &GDSKey, bitset<16> &bitarr,
   uint8_t dataType;
 
   sizeBlk = (((unsigned char)recIn[0] << 8) | (unsigned char)recIn[1]) - 2;
-  GDSKey = ((recIn[2] << 8) | recIn[3]);
+  GDSKey = (((unsigned char)recIn[2] << 8) | (unsigned char)recIn[3]);
   dataType = GDSKey;
   i = 4;
 
+  // The output containers are cleared, not released, so that callers which
+  // reuse them do not allocate per record.
   bitarr.reset();
   integer.clear();
   B8Real.clear();
-  words = "";
+  words.clear();
 
   if (dataType == 0) {
     // no data
   } else if (dataType == 1) {
     // 16 bitset
-    bitarr = (recIn[i] << 8) | (recIn[i + 1]);
+    bitarr = ((unsigned char)recIn[i] << 8) | (unsigned char)recIn[i + 1];
   } else if (dataType == 2) {
     // 2 byte signed int
     for (i = 4; i <= sizeBlk; i = i + 2) {
@@ -83,15 +85,13 @@ int GDSdistill(char *recIn, uint32_t &GDSKey, bitset<16> &bitarr,
     }
   } else if (dataType == 6) {
     // ASCII string
-    string foo = "";
     sizeBlk++;
     for (i = 4; i <= sizeBlk; i++) {
       if (recIn[i] ==
           '\0') // if string record's size is odd, it must be padded with NULL
         continue;
-      foo = foo + recIn[i];
+      words.push_back(recIn[i]);
     }
-    words = foo;
   } else {
     cout << "Unknown data type." << endl;
     return 1;
@@ -202,7 +202,7 @@ uint64_t bitShiftL(uint64_t inVar, int cnt)
  * @param  cnt    [Amount of bytes that must be concatenated]
  * @return        [The concatenated value]
  */
-int conBytes(char inArry[], int start, int cnt)
+int conBytes(const char inArry[], int start, int cnt)
 {
   int outVal = 0;
 
@@ -213,7 +213,7 @@ int conBytes(char inArry[], int start, int cnt)
   return outVal;
 }
 
-uint64_t conBytesLL(char inArry[], int start, int cnt)
+uint64_t conBytesLL(const char inArry[], int start, int cnt)
 {
   unsigned long long outVal = 0;
 
@@ -0,0 +1,95 @@
+/**
+ * Author:      J.F. de Villiers & H.F. Herbst
+ * Origin:  		E&E Engineering - Stellenbosch University
+ * For:					Supertools, Coldflux Project - IARPA
+ * Created: 		2019-08-26
+ * Modified:
+ * license:     MIT License
+ * Description: Memory mapped GDS file access and an in place record cursor.
+ * File:				gdsReader.cpp
+ */
+
+// ========================= Includes =========================
+#include "gdscpp/gdsReader.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ====================== Miscellanious =======================
+using namespace std;
+
+// ====================== Function Code =======================
+
+/**
+ * [gdsMap::open - Maps the complete file into memory (read only)]
+ * @param  fileName [The file name of the GDS file to be mapped]
+ * @return          [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsMap::open(const string &fileName)
+{
+  this->close();
+
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0)
+    return EXIT_FAILURE;
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0) {
+    ::close(fd);
+    return EXIT_FAILURE;
+  }
+
+  void *mapped = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd); // The mapping keeps its own reference to the file
+  if (mapped == MAP_FAILED)
+    return EXIT_FAILURE;
+
+  // Records are consumed front to back
+  madvise(mapped, fileStat.st_size, MADV_SEQUENTIAL);
+
+  this->data = (const char *)mapped;
+  this->dataSize = fileStat.st_size;
+  return EXIT_SUCCESS;
+}
+
+/**
+ * [gdsMap::close - Releases the mapping, all record pointers become invalid]
+ */
+void gdsMap::close()
+{
+  if (this->data != nullptr)
+    munmap((void *)this->data, this->dataSize);
+  this->data = nullptr;
+  this->dataSize = 0;
+}
+
+/**
+ * [gdsReader::next - Steps over the current record]
+ * @return [Pointer to the start of the record; nullptr if the range is
+ * exhausted or the record is truncated/corrupt]
+ */
+const char *gdsReader::next()
+{
+  const char *recIn = this->peek();
+  if (recIn != nullptr)
+    this->cur += gdsRecSize(recIn);
+  return recIn;
+}
+
+/**
+ * [gdsReader::peek - Returns the current record without stepping over it]
+ * @return [Pointer to the start of the record; nullptr if the range is
+ * exhausted or the record is truncated/corrupt]
+ */
+const char *gdsReader::peek() const
+{
+  if (this->end - this->cur < 4)
+    return nullptr;
+
+  uint32_t sizeBlk = gdsRecSize(this->cur);
+  if (sizeBlk < 4 || sizeBlk > (size_t)(this->end - this->cur))
+    return nullptr;
+
+  return this->cur;
+}
@@ -0,0 +1,144 @@
+/**
+ * Author:      J.F. de Villiers & H.F. Herbst
+ * Origin:  		E&E Engineering - Stellenbosch University
+ * For:					Supertools, Coldflux Project - IARPA
+ * Created: 		2019-08-26
+ * Modified:
+ * license:     MIT License
+ * Description: Index of the references between the structures of a library.
+ * File:				gdsRefGraph.cpp
+ */
+
+// ========================= Includes =========================
+#include "gdscpp/gdsRefGraph.hpp"
+#include <algorithm>
+// ====================== Miscellanious =======================
+using namespace std;
+
+// ====================== Function Code =======================
+/**
+ * [gdsRefGraph::clear - Removes all the nodes and references]
+ */
+void gdsRefGraph::clear()
+{
+  node_of_name.clear();
+  child_list.clear();
+  parent_list.clear();
+  reference_count.clear();
+  unresolved.clear();
+}
+
+/**
+ * [gdsRefGraph::add_node - Adds a structure to the graph and connects the
+ * references that were waiting on its name]
+ * @param  name [Name of the structure]
+ * @return      [Index of the node]
+ */
+unsigned int gdsRefGraph::add_node(const gdsName &name)
+{
+  unsigned int node = child_list.size();
+  child_list.emplace_back();
+  parent_list.emplace_back();
+  reference_count.push_back(0);
+  if (name.id() >= node_of_name.size())
+    node_of_name.resize(name.id() + 1, no_node);
+  if (node_of_name[name.id()] != no_node)
+    return node; // Name already taken, the first node keeps the references
+  node_of_name[name.id()] = node;
+
+  auto waiting = unresolved.find(name.id());
+  if (waiting != unresolved.end()) {
+    for (const auto &parent : waiting->second) {
+      child_list[parent.first].push_back(node);
+      parent_list[node].push_back(parent.first);
+      reference_count[node] += parent.second;
+    }
+    unresolved.erase(waiting);
+  }
+  return node;
+}
+
+/**
+ * [gdsRefGraph::add_reference - Adds a reference from parent to the structure
+ * child. All the references of a parent must be added one after the
+ * other, which is how duplicate edges are detected without a search.]
+ * @param  parent     [Index of the referencing node]
+ * @param  child_name [Name of the referenced structure]
+ */
+void gdsRefGraph::add_reference(unsigned int parent, const gdsName &child_name)
+{
+  unsigned int child = find(child_name);
+  if (child == no_node) {
+    auto &waiting = unresolved[child_name.id()];
+    if (waiting.empty() || waiting.back().first != parent)
+      waiting.push_back({parent, 0});
+    waiting.back().second++;
+    return;
+  }
+  reference_count[child]++;
+  if (parent_list[child].empty() || parent_list[child].back() != parent) {
+    parent_list[child].push_back(parent);
+    child_list[parent].push_back(child);
+  }
+}
+
+/**
+ * [gdsRefGraph::add_late_reference - Adds a reference from parent to the
+ * structure child after the other references of the parent were added. The
+ * existing edges are searched, so it is meant for the odd reference only.]
+ * @param  parent     [Index of the referencing node]
+ * @param  child_name [Name of the referenced structure]
+ */
+void gdsRefGraph::add_late_reference(unsigned int parent,
+                                     const gdsName &child_name)
+{
+  unsigned int child = find(child_name);
+  if (child == no_node) {
+    auto &waiting = unresolved[child_name.id()];
+    auto found = find_if(
+        waiting.begin(), waiting.end(),
+        [parent](const pair<unsigned int, unsigned int> &foo) {
+          return foo.first == parent;
+        });
+    if (found == waiting.end())
+      waiting.push_back({parent, 1});
+    else
+      found->second++;
+    return;
+  }
+  reference_count[child]++;
+  if (std::find(child_list[parent].begin(), child_list[parent].end(), child) ==
+      child_list[parent].end()) {
+    parent_list[child].push_back(parent);
+    child_list[parent].push_back(child);
+  }
+}
+
+/**
+ * [gdsRefGraph::roots - Structures that are not referenced by any other]
+ * @return [Indices of the root nodes]
+ */
+vector<unsigned int> gdsRefGraph::roots() const
+{
+  vector<unsigned int> root_nodes;
+  for (unsigned int i = 0; i < parent_list.size(); i++) {
+    if (parent_list[i].empty())
+      root_nodes.push_back(i);
+  }
+  return root_nodes;
+}
+
+/**
+ * [gdsRefGraph::unresolved_names - Names that are referenced but are not a
+ * structure in the graph]
+ * @return [The missing structure names]
+ */
+vector<string> gdsRefGraph::unresolved_names() const
+{
+  vector<string> names;
+  names.reserve(unresolved.size());
+  for (const auto &waiting : unresolved)
+    names.push_back(gdsNameOf(waiting.first));
+  sort(names.begin(), names.end());
+  return names;
+}
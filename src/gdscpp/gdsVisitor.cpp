@@ -0,0 +1,743 @@
+/**
+ * Author:      J.F. de Villiers & H.F. Herbst
+ * Origin:  		E&E Engineering - Stellenbosch University
+ * For:					Supertools, Coldflux Project - IARPA
+ * Created: 		2019-10-14
+ * Modified:
+ * license:     MIT License
+ * Description: GDS record decoder which streams its results to a gdsVisitor
+ * File:				gdsVisitor.cpp
+ */
+
+// ========================= Includes =========================
+#include "gdscpp/gdsCpp.hpp"
+
+// ====================== Miscellanious =======================
+using namespace std;
+
+// ===================== Class Definitions ====================
+
+/*
+ * [gdsDecoder - Walks the records of a gdsReader and reports them to a
+ * gdsVisitor. All scratch memory is owned here and reused for every record.]
+ */
+class gdsDecoder
+{
+private:
+  gdsReader &gdsIn;
+  gdsVisitor &visitor;
+
+  const char *current_readBlk = nullptr;
+  uint32_t current_GDSKey = 0;
+  bitset<16> current_bitarr;
+  vector<int> current_integer;
+  vector<double> current_B8Real;
+  string current_words;
+
+  // Memory where element objects are held until handed to the visitor.
+  string plchold_name;
+  vector<int> plchold_last_modified;
+  gdsBOUNDARY plchold_bnd;
+  gdsPATH plchold_path;
+  gdsSREF plchold_sref;
+  gdsAREF plchold_aref;
+  gdsTEXT plchold_text;
+  gdsNODE plchold_node;
+  gdsBOX plchold_box;
+
+  int readRecord();
+  void appendXY(vector<int> &xCor, vector<int> &yCor);
+  void appendXY(vector<int> &corXY);
+
+  void reportLibRecord();
+  int skipSTRbody();
+
+  int decodeSTRbody();
+  int decodeBoundary();
+  int decodePath();
+  int decodeSref();
+  int decodeAref();
+  int decodeText();
+  int decodeNode();
+  int decodeBox();
+
+public:
+  gdsDecoder(gdsReader &in, gdsVisitor &target)
+      : gdsIn(in), visitor(target){};
+  ~gdsDecoder(){};
+
+  int decodeLib();
+  int indexLib(vector<size_t> &str_offsets);
+  int decodeSTR();
+};
+
+// ====================== Function Code =======================
+
+/**
+ * [gdsVisit - Streams a complete GDS file to a visitor without storing it]
+ * @param  fileName [The file name of the GDS file that is going to be read]
+ * @param  visitor  [Receives the decoded records]
+ * @return          [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsVisit(const std::string &fileName, gdsVisitor &visitor)
+{
+  gdsMap gdsFile;
+
+  if (gdsFile.open(fileName)) {
+    cout << "Error: GDS file \"" << fileName << "\" FAILED to be opened."
+         << endl;
+    return EXIT_FAILURE;
+  }
+
+  gdsReader gdsIn(gdsFile.begin(), gdsFile.size());
+  return gdsDecodeLib(gdsIn, visitor);
+}
+
+/**
+ * [gdsDecodeLib - Decodes records from the cursor up to and including ENDLIB]
+ * @param  gdsIn   [Cursor positioned at the start of the library]
+ * @param  visitor [Receives the decoded records]
+ * @return         [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsDecodeLib(gdsReader &gdsIn, gdsVisitor &visitor)
+{
+  gdsDecoder decoder(gdsIn, visitor);
+  return decoder.decodeLib();
+}
+
+/**
+ * [gdsIndexLib - Decodes the library level records but only records where
+ * each structure starts, the structure bodies are stepped over undecoded]
+ * @param  gdsIn       [Cursor positioned at the start of the library]
+ * @param  visitor     [Receives the library level records]
+ * @param  str_offsets [Byte offset of every BGNSTR record, in file order]
+ * @return             [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsIndexLib(gdsReader &gdsIn, gdsVisitor &visitor,
+                vector<size_t> &str_offsets)
+{
+  gdsDecoder decoder(gdsIn, visitor);
+  return decoder.indexLib(str_offsets);
+}
+
+/**
+ * [gdsDecodeSTR - Decodes a single BGNSTR..ENDSTR block]
+ * @param  gdsIn   [Cursor positioned at the BGNSTR record]
+ * @param  visitor [Receives the decoded records]
+ * @return         [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsDecodeSTR(gdsReader &gdsIn, gdsVisitor &visitor)
+{
+  gdsDecoder decoder(gdsIn, visitor);
+  return decoder.decodeSTR();
+}
+
+/**
+ * [gdsDecoder::readRecord - Fetches and distills the next record]
+ * @return [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsDecoder::readRecord()
+{
+  current_readBlk = gdsIn.next();
+  if (current_readBlk == nullptr ||
+      GDSdistill(current_readBlk, current_GDSKey, current_bitarr,
+                 current_integer, current_B8Real, current_words)) {
+    cout << "Error: Unable to read GDS file." << endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+/**
+ * [gdsDecoder::appendXY - Splits the current XY record into x and y]
+ */
+void gdsDecoder::appendXY(vector<int> &xCor, vector<int> &yCor)
+{
+  // confirm xy as pairs
+  if (current_integer.size() % 2 != 0) {
+    cout << "Error: XY co_ordinates uneven" << endl;
+    return;
+  }
+  for (unsigned int i = 0; i < current_integer.size(); i += 2) {
+    xCor.push_back(current_integer[i]);
+    yCor.push_back(current_integer[i + 1]);
+  }
+}
+
+/**
+ * [gdsDecoder::appendXY - Appends the current XY record as interleaved x, y
+ * pairs]
+ */
+void gdsDecoder::appendXY(vector<int> &corXY)
+{
+  if (current_integer.size() % 2 != 0) {
+    cout << "Error: XY co_ordinates uneven" << endl;
+    return;
+  }
+  corXY.insert(corXY.end(), current_integer.begin(), current_integer.end());
+}
+
+/**
+ * [gdsDecoder::decodeLib - Highest tier of data: HEADER, BGNLIB, LIBNAME,
+ * GENERATIONS, UNITS, BGNSTR, ENDLIB]
+ * @return [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsDecoder::decodeLib()
+{
+  do {
+    if (readRecord())
+      return EXIT_FAILURE;
+
+    if (current_GDSKey == GDS_BGNSTR) {
+      if (decodeSTRbody())
+        return EXIT_FAILURE;
+    } else
+      reportLibRecord();
+  } while (current_GDSKey != GDS_ENDLIB);
+
+  return EXIT_SUCCESS;
+}
+
+/**
+ * [gdsDecoder::indexLib - Same as decodeLib, but structures are only located]
+ * @param  str_offsets [Byte offset of every BGNSTR record, in file order]
+ * @return             [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsDecoder::indexLib(vector<size_t> &str_offsets)
+{
+  do {
+    size_t offset = gdsIn.tell();
+    if (readRecord())
+      return EXIT_FAILURE;
+
+    if (current_GDSKey == GDS_BGNSTR) {
+      str_offsets.push_back(offset);
+      if (skipSTRbody())
+        return EXIT_FAILURE;
+    } else
+      reportLibRecord();
+  } while (current_GDSKey != GDS_ENDLIB);
+
+  return EXIT_SUCCESS;
+}
+
+/**
+ * [gdsDecoder::reportLibRecord - Hands the current library level record to
+ * the visitor]
+ */
+void gdsDecoder::reportLibRecord()
+{
+  switch (current_GDSKey) {
+  case GDS_HEADER:
+    visitor.onHeader(current_integer[0]);
+    break;
+  case GDS_BGNLIB:
+    visitor.onBeginLib(current_integer);
+    break;
+  case GDS_LIBNAME:
+    visitor.onLibName(current_words);
+    break;
+  case GDS_GENERATIONS:
+    visitor.onGenerations(current_integer[0]);
+    break;
+  case GDS_UNITS:
+    visitor.onUnits(current_B8Real[0], current_B8Real[1]);
+    break;
+  case GDS_ENDLIB:
+    visitor.onEndLib();
+    break;
+  default:
+    cout << "Error: Unrecognized record." << endl;
+    break;
+  }
+}
+
+/**
+ * [gdsDecoder::skipSTRbody - Steps over records up to and including ENDSTR
+ * without decoding them. The BGNSTR record must be the current one.]
+ * @return [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsDecoder::skipSTRbody()
+{
+  do {
+    current_readBlk = gdsIn.next();
+    if (current_readBlk == nullptr) {
+      cout << "Error: Unable to read GDS file." << endl;
+      return EXIT_FAILURE;
+    }
+  } while (gdsRecKey(current_readBlk) != GDS_ENDSTR);
+  current_GDSKey = GDS_ENDSTR;
+
+  return EXIT_SUCCESS;
+}
+
+/**
+ * [gdsDecoder::decodeSTR - Decodes the structure starting at the cursor]
+ * @return [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsDecoder::decodeSTR()
+{
+  if (readRecord())
+    return EXIT_FAILURE;
+  if (current_GDSKey != GDS_BGNSTR) {
+    cout << "Error: Expected BGNSTR record." << endl;
+    return EXIT_FAILURE;
+  }
+  return decodeSTRbody();
+}
+
+/**
+ * [gdsDecoder::decodeSTRbody - Structure tier: STRNAME, BOUNDARY, PATH, SREF,
+ * AREF, TEXT, NODE, BOX, ENDSTR. The BGNSTR record must be the current one.]
+ * @return [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsDecoder::decodeSTRbody()
+{
+  plchold_last_modified = current_integer;
+  plchold_name.clear();
+
+  int status = EXIT_SUCCESS;
+  do {
+    if (readRecord())
+      return EXIT_FAILURE;
+
+    switch (current_GDSKey) {
+    case GDS_STRNAME:
+      plchold_name = current_words;
+      visitor.onBeginStr(plchold_name, plchold_last_modified);
+      break;
+    case GDS_BOUNDARY:
+      status = decodeBoundary();
+      break;
+    case GDS_PATH:
+      status = decodePath();
+      break;
+    case GDS_SREF:
+      status = decodeSref();
+      break;
+    case GDS_AREF:
+      status = decodeAref();
+      break;
+    case GDS_TEXT:
+      status = decodeText();
+      break;
+    case GDS_NODE:
+      status = decodeNode();
+      break;
+    case GDS_BOX:
+      status = decodeBox();
+      break;
+    case GDS_ENDSTR:
+      visitor.onEndStr();
+      break;
+    default:
+      cout << "Error: Unrecognized record." << endl;
+      break;
+    }
+    if (status)
+      return EXIT_FAILURE;
+  } while (current_GDSKey != GDS_ENDSTR);
+
+  return EXIT_SUCCESS;
+}
+
+/**
+ * [gdsDecoder::decodeBoundary - PLEX LAYER DATATYPE XY PROPATTR PROPVALUE]
+ * @return [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsDecoder::decodeBoundary()
+{
+  plchold_bnd.reset();
+  gdsPointArena *arena = visitor.boundaryArena();
+  do {
+    if (readRecord()) {
+      if (arena)
+        arena->drop_tail();
+      return EXIT_FAILURE;
+    }
+
+    switch (current_GDSKey) {
+    case GDS_PLEX:
+      plchold_bnd.plex = current_integer[0];
+      break;
+    case GDS_LAYER:
+      plchold_bnd.layer = current_integer[0];
+      break;
+    case GDS_DATATYPE:
+      plchold_bnd.dataType = current_integer[0];
+      break;
+    case GDS_XY:
+      if (arena)
+        appendXY(arena->points);
+      else
+        appendXY(plchold_bnd.xCor, plchold_bnd.yCor);
+      break;
+    case GDS_PROPATTR:
+      plchold_bnd.propattr = current_integer[0];
+      break;
+    case GDS_PROPVALUE:
+      plchold_bnd.propvalue = current_words;
+      break;
+    case GDS_ENDEL:
+      break;
+    default:
+      cout << "Error: Unrecognized record." << endl;
+      break;
+    }
+  } while (current_GDSKey != GDS_ENDEL);
+
+  if (arena)
+    arena->push_back_tail(plchold_bnd.layer, plchold_bnd.dataType, 0, 0,
+                          plchold_bnd.plex, plchold_bnd.propattr,
+                          plchold_bnd.propvalue);
+  else
+    visitor.onBoundary(plchold_bnd);
+  return EXIT_SUCCESS;
+}
+
+/**
+ * [gdsDecoder::decodePath - PLEX LAYER DATATYPE PATHTYPE WIDTH XY PROPATTR
+ * PROPVALUE]
+ * @return [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsDecoder::decodePath()
+{
+  plchold_path.reset();
+  gdsPointArena *arena = visitor.pathArena();
+  do {
+    if (readRecord()) {
+      if (arena)
+        arena->drop_tail();
+      return EXIT_FAILURE;
+    }
+
+    switch (current_GDSKey) {
+    case GDS_PLEX:
+      plchold_path.plex = current_integer[0];
+      break;
+    case GDS_LAYER:
+      plchold_path.layer = current_integer[0];
+      break;
+    case GDS_DATATYPE:
+      plchold_path.dataType = current_integer[0];
+      break;
+    case GDS_PATHTYPE:
+      plchold_path.pathtype = current_integer[0];
+      break;
+    case GDS_WIDTH:
+      plchold_path.width = current_integer[0];
+      break;
+    case GDS_XY:
+      if (arena)
+        appendXY(arena->points);
+      else
+        appendXY(plchold_path.xCor, plchold_path.yCor);
+      break;
+    case GDS_PROPATTR:
+      plchold_path.propattr = current_integer[0];
+      break;
+    case GDS_PROPVALUE:
+      plchold_path.propvalue = current_words;
+      break;
+    case GDS_ENDEL:
+      break;
+    default:
+      cout << "Error: Unrecognized record." << endl;
+      break;
+    }
+  } while (current_GDSKey != GDS_ENDEL);
+
+  if (arena)
+    arena->push_back_tail(plchold_path.layer, plchold_path.dataType,
+                          plchold_path.pathtype, plchold_path.width,
+                          plchold_path.plex, plchold_path.propattr,
+                          plchold_path.propvalue);
+  else
+    visitor.onPath(plchold_path);
+  return EXIT_SUCCESS;
+}
+
+/**
+ * [gdsDecoder::decodeSref - PLEX SNAME STRANS MAG ANGLE XY PROPATTR
+ * PROPVALUE]
+ * @return [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsDecoder::decodeSref()
+{
+  plchold_sref.reset();
+  do {
+    if (readRecord())
+      return EXIT_FAILURE;
+
+    switch (current_GDSKey) {
+    case GDS_PLEX:
+      plchold_sref.plex = current_integer[0];
+      break;
+    case GDS_SNAME:
+      plchold_sref.name = current_words;
+      break;
+    case GDS_STRANS:
+      plchold_sref.sref_flags = current_bitarr;
+      plchold_sref.reflection = current_bitarr[15];
+      break;
+    case GDS_MAG:
+      plchold_sref.sref_flags.set(
+          13, 1); // Precaution incase other software forgot to set bit
+      plchold_sref.scale = current_B8Real[0];
+      break;
+    case GDS_ANGLE:
+      plchold_sref.angle = current_B8Real[0];
+      break;
+    case GDS_XY:
+      // confirm xy as pairs
+      if (current_integer.size() % 2 == 0) {
+        plchold_sref.xCor = current_integer[0];
+        plchold_sref.yCor = current_integer[1];
+      } else {
+        cout << "Error: Missing X or Y co-ordinate" << endl;
+      }
+      break;
+    case GDS_PROPATTR:
+      plchold_sref.propattr = current_integer[0];
+      break;
+    case GDS_PROPVALUE:
+      plchold_sref.propvalue = current_words;
+      break;
+    case GDS_ENDEL:
+      break;
+    default:
+      cout << "Error: Unrecognized record." << endl;
+      break;
+    }
+  } while (current_GDSKey != GDS_ENDEL);
+
+  plchold_sref.classify();
+  visitor.onSref(plchold_sref);
+  return EXIT_SUCCESS;
+}
+
+/**
+ * [gdsDecoder::decodeAref - PLEX SNAME STRANS MAG ANGLE COLROW XY PROPATTR
+ * PROPVALUE]
+ * @return [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsDecoder::decodeAref()
+{
+  plchold_aref.reset();
+  do {
+    if (readRecord())
+      return EXIT_FAILURE;
+
+    switch (current_GDSKey) {
+    case GDS_PLEX:
+      plchold_aref.plex = current_integer[0];
+      break;
+    case GDS_SNAME:
+      plchold_aref.name = current_words;
+      break;
+    case GDS_STRANS:
+      plchold_aref.aref_transformation_flags = current_bitarr;
+      plchold_aref.reflection = current_bitarr[15];
+      break;
+    case GDS_MAG:
+      plchold_aref.aref_transformation_flags.set(
+          13, 1); // Precaution incase other software forgot to set bit
+      plchold_aref.scale = current_B8Real[0];
+      break;
+    case GDS_ANGLE:
+      plchold_aref.aref_transformation_flags.set(
+          14, 1); // Precaution incase other software forgot to set bit
+      plchold_aref.angle = current_B8Real[0];
+      break;
+    case GDS_COLROW:
+      plchold_aref.colCnt = current_integer[0];
+      plchold_aref.rowCnt = current_integer[1];
+      break;
+    case GDS_XY:
+      // confirm xy as the three points of the array
+      if (current_integer.size() == 6) {
+        plchold_aref.xCor = current_integer[0];
+        plchold_aref.yCor = current_integer[1];
+        plchold_aref.xCorRow = current_integer[2];
+        plchold_aref.yCorRow = current_integer[3];
+        plchold_aref.xCorCol = current_integer[4];
+        plchold_aref.yCorCol = current_integer[5];
+      } else {
+        cout << "Error: Missing X or Y co-ordinate" << endl;
+      }
+      break;
+    case GDS_PROPATTR:
+      plchold_aref.propattr = current_integer[0];
+      break;
+    case GDS_PROPVALUE:
+      plchold_aref.propvalue = current_words;
+      break;
+    case GDS_ENDEL:
+      break;
+    default:
+      cout << "Error: Unrecognized record." << endl;
+      break;
+    }
+  } while (current_GDSKey != GDS_ENDEL);
+
+  visitor.onAref(plchold_aref);
+  return EXIT_SUCCESS;
+}
+
+/**
+ * [gdsDecoder::decodeText - PLEX LAYER TEXTTYPE PRESENTATION PATHTYPE WIDTH
+ * STRANS MAG ANGLE XY STRING PROPATTR PROPVALUE]
+ * @return [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsDecoder::decodeText()
+{
+  plchold_text.reset();
+  do {
+    if (readRecord())
+      return EXIT_FAILURE;
+
+    switch (current_GDSKey) {
+    case GDS_PLEX:
+      plchold_text.plex = current_integer[0];
+      break;
+    case GDS_LAYER:
+      plchold_text.layer = current_integer[0];
+      break;
+    case GDS_TEXTTYPE:
+      plchold_text.text_type = current_integer[0];
+      break;
+    case GDS_PRESENTATION:
+      plchold_text.presentation_flags = current_bitarr;
+      break;
+    case GDS_PATHTYPE:
+      plchold_text.path_type = current_integer[0];
+      break;
+    case GDS_WIDTH:
+      plchold_text.width = current_integer[0];
+      break;
+    case GDS_STRANS:
+      plchold_text.text_transformation_flags = current_bitarr;
+      break;
+    case GDS_MAG:
+      plchold_text.text_transformation_flags.set(
+          13, 1); // Precaution incase other software forgot to set bit
+      plchold_text.scale = current_B8Real[0];
+      break;
+    case GDS_ANGLE:
+      plchold_text.text_transformation_flags.set(
+          14, 1); // Precaution incase other software forgot to set bit
+      plchold_text.angle = current_B8Real[0];
+      break;
+    case GDS_XY:
+      // confirm xy as pairs
+      if (current_integer.size() % 2 == 0) {
+        plchold_text.xCor = current_integer[0];
+        plchold_text.yCor = current_integer[1];
+      } else {
+        cout << "Error: Missing X or Y co-ordinate" << endl;
+      }
+      break;
+    case GDS_STRING:
+      plchold_text.textbody = current_words;
+      break;
+    case GDS_PROPATTR:
+      plchold_text.propattr = current_integer[0];
+      break;
+    case GDS_PROPVALUE:
+      plchold_text.propvalue = current_words;
+      break;
+    case GDS_ENDEL:
+      break;
+    default:
+      cout << "Error: Unrecognized record." << endl;
+      break;
+    }
+  } while (current_GDSKey != GDS_ENDEL);
+
+  visitor.onText(plchold_text);
+  return EXIT_SUCCESS;
+}
+
+/**
+ * [gdsDecoder::decodeNode - PLEX LAYER NODETYPE XY PROPATTR PROPVALUE]
+ * @return [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsDecoder::decodeNode()
+{
+  plchold_node.reset();
+  do {
+    if (readRecord())
+      return EXIT_FAILURE;
+
+    switch (current_GDSKey) {
+    case GDS_PLEX:
+      plchold_node.plex = current_integer[0];
+      break;
+    case GDS_LAYER:
+      plchold_node.layer = current_integer[0];
+      break;
+    case GDS_NODETYPE:
+      plchold_node.nodetype = current_integer[0];
+      break;
+    case GDS_XY:
+      appendXY(plchold_node.xCor, plchold_node.yCor);
+      break;
+    case GDS_PROPATTR:
+      plchold_node.propattr = current_integer[0];
+      break;
+    case GDS_PROPVALUE:
+      plchold_node.propvalue = current_words;
+      break;
+    case GDS_ENDEL:
+      break;
+    default:
+      cout << "Error: Unrecognized record." << endl;
+      break;
+    }
+  } while (current_GDSKey != GDS_ENDEL);
+
+  visitor.onNode(plchold_node);
+  return EXIT_SUCCESS;
+}
+
+/**
+ * [gdsDecoder::decodeBox - PLEX LAYER BOXTYPE XY PROPATTR PROPVALUE]
+ * @return [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsDecoder::decodeBox()
+{
+  plchold_box.reset();
+  do {
+    if (readRecord())
+      return EXIT_FAILURE;
+
+    switch (current_GDSKey) {
+    case GDS_PLEX:
+      plchold_box.plex = current_integer[0];
+      break;
+    case GDS_LAYER:
+      plchold_box.layer = current_integer[0];
+      break;
+    case GDS_BOXTYPE:
+      plchold_box.boxtype = current_integer[0];
+      break;
+    case GDS_XY:
+      appendXY(plchold_box.xCor, plchold_box.yCor);
+      break;
+    case GDS_PROPATTR:
+      plchold_box.propattr = current_integer[0];
+      break;
+    case GDS_PROPVALUE:
+      plchold_box.propvalue = current_words;
+      break;
+    case GDS_ENDEL:
+      break;
+    default:
+      cout << "Error: Unrecognized record." << endl;
+      break;
+    }
+  } while (current_GDSKey != GDS_ENDEL);
+
+  visitor.onBox(plchold_box);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,99 @@
+/**
+ * Author:      J.F. de Villiers & H.F. Herbst
+ * Origin:  		E&E Engineering - Stellenbosch University
+ * For:					Supertools, Coldflux Project - IARPA
+ * Created: 		2019-08-26
+ * Modified:
+ * license:     MIT License
+ * Description: Buffered output of GDS records with big endian bulk stores.
+ * File:				gdsWriter.cpp
+ */
+
+// ========================= Includes =========================
+#include "gdscpp/gdsWriter.hpp"
+
+// ====================== Miscellanious =======================
+using namespace std;
+
+// ====================== Function Code =======================
+
+/**
+ * [gdsWriter::open - Creates (truncates) the output file]
+ * @param  fileName [The file name of the GDS file to be written]
+ * @return          [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsWriter::open(const string &fileName)
+{
+  this->close();
+
+  this->outFile = fopen(fileName.c_str(), "wb");
+  if (this->outFile == nullptr)
+    return EXIT_FAILURE;
+
+  // The buffer already batches the writes, stdio should not copy again.
+  setvbuf(this->outFile, nullptr, _IONBF, 0);
+  this->failed = false;
+  return EXIT_SUCCESS;
+}
+
+/**
+ * [gdsWriter::flush - Writes the buffered records to the file]
+ * @return [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsWriter::flush()
+{
+  if (this->outFile != nullptr && this->used > 0) {
+    if (fwrite(this->buffer.data(), 1, this->used, this->outFile) !=
+        this->used)
+      this->failed = true;
+  }
+  this->used = 0;
+  return this->failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/**
+ * [gdsWriter::close - Flushes and closes the file]
+ * @return [0 - Exit Success; 1 - Exit Failure]
+ */
+int gdsWriter::close()
+{
+  if (this->outFile == nullptr)
+    return EXIT_SUCCESS;
+
+  this->flush();
+  if (fclose(this->outFile) != 0)
+    this->failed = true;
+  this->outFile = nullptr;
+  return this->failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/**
+ * [gdsWriter::putBlock - Appends a large run of ready made records, e.g.
+ * structures spliced from another file. With a file open, blocks of a
+ * quarter of the buffer or more are written straight from the source instead
+ * of being copied into the buffer first.]
+ * @param src [The bytes to be written]
+ * @param cnt [Number of bytes]
+ */
+void gdsWriter::putBlock(const void *src, size_t cnt)
+{
+  if (this->outFile == nullptr || cnt < this->buffer.size() / 4) {
+    this->putBytes(src, cnt);
+    return;
+  }
+  this->flush();
+  if (fwrite(src, 1, cnt, this->outFile) != cnt)
+    this->failed = true;
+}
+
+/**
+ * [gdsWriter::grow - Makes room for cnt more bytes, the buffer is flushed
+ * first and only enlarged if a single request does not fit]
+ */
+void gdsWriter::grow(size_t cnt)
+{
+  if (this->outFile != nullptr)
+    this->flush();
+  if (this->used + cnt > this->buffer.size())
+    this->buffer.resize(max(this->buffer.size() * 2, this->used + cnt));
+}
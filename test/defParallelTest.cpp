@@ -0,0 +1,89 @@
+/**
+ * Author:      Jude de Villiers
+ * Origin:      E&E Engineering - Stellenbosch University
+ * For:         Supertools, Coldflux Project - IARPA
+ * Created:     2020-04-21
+ * Modified:
+ * license:
+ * Description: A DEF file parsed on one thread, on several threads and from
+ *              its snapshot gives the same design
+ * File:        defParallelTest.cpp
+ */
+
+#include "chipsmith/ParserDef.hpp"
+#include <cstdio>
+#include <fstream>
+#include "testCheck.hpp"
+
+using namespace std;
+
+static const unsigned int compCnt = 1500;
+static const unsigned int netCnt = 1500;
+static const unsigned int snetCnt = 20;
+
+// Enough statements for every thread to get several chunks, with components
+// and wiring spread over more than one line
+static void writeDEF(const string &fileName){
+  static const char *orients[] = {"N", "S", "E", "W", "FN", "FS", "FE", "FW"};
+  ofstream def(fileName, ios::trunc);
+  def << "DESIGN parallel ;\nUNITS DISTANCE MICRONS 100 ;\nDIEAREA ( 0 0 ) ( 500000 500000 ) ;\n\n";
+
+  def << "COMPONENTS " << compCnt << " ;\n";
+  for(unsigned int i = 0; i < compCnt; i++){
+    def << "- U" << i << (i % 2 ? " DFF" : " AND2");
+    def << (i % 7 == 0 ? "\n  " : " ");
+    def << "+ PLACED ( " << (i % 50) * 9000 << " " << (i / 50) * 8000 << " ) " << orients[i % 8] << " ;\n";
+  }
+  def << "END COMPONENTS\n\n";
+
+  def << "SPECIALNETS " << snetCnt << " ;\n";
+  for(unsigned int i = 0; i < snetCnt; i++){
+    def << "- VDD" << i << " ( * VDD )\n";
+    def << "+ ROUTED metal2 450 ( 1000 " << 1000 + i * 20000 << " ) ( 480000 * )\n";
+    def << "NEW metal1 300 ( " << 1000 + i * 100 << " 0 ) ( * 5000 ) via1 ;\n";
+  }
+  def << "END SPECIALNETS\n\n";
+
+  def << "NETS " << netCnt << " ;\n";
+  for(unsigned int i = 0; i < netCnt; i++){
+    int x = (i % 50) * 9000 + 7500, y = (i / 50) * 8000 + 3500;
+    def << "- n" << i << "\n( U" << i << " OUT_1 )\n( U" << (i + 1) % compCnt << " IN_1 )\n";
+    def << "+ ROUTED metal1 ( " << x << " " << y << " ) ( " << x + 700 << " * ) via1\n";
+    def << "NEW metal2 ( " << x + 700 << " " << y << " ) ( * " << y + 800 + i % 13 << " ) via1\n";
+    def << "NEW metal1 ( " << x + 700 << " " << y + 800 + i % 13 << " ) ( " << x + 2000 << " * ) ;\n";
+  }
+  def << "END NETS\n\nEND DESIGN\n";
+}
+
+int main(){
+  const string defName = "parallel.def";
+  const string cacheDir = "defParallelTest.cache";
+  writeDEF(defName);
+  remove(cacheFileName(defName, cacheDir).c_str());
+
+  def_file serial;
+  CHECK(serial.importFile(defName, 1));
+  CHECK(serial.comps.size() == compCnt);
+  CHECK(serial.nets.size() == netCnt);
+  CHECK(serial.snets.size() == snetCnt);
+  if(serial.comps.size() != compCnt || serial.nets.size() != netCnt) return TEST_RESULT();
+  // Statements land in their own slots, in file order
+  const def_component &split = serial.comps[777];
+  CHECK(split.name == "U777" && split.compName == "DFF" && split.orient == "S");
+  CHECK(split.corX == 243000 && split.corY == 120000);
+  CHECK(serial.nets[1499].name == "n1499");
+  CHECK(serial.nets[1499].routes.size() == 3);
+
+  for(unsigned int threads: {2u, 4u, 0u}){
+    def_file parallel;
+    CHECK(parallel.importFile(defName, threads));
+    CHECK(parallel == serial);
+  }
+
+  CHECK(!serial.saveCache(defName, cacheDir));
+  def_file cached;
+  CHECK(!cached.loadCache(defName, cacheDir));
+  CHECK(cached == serial);
+
+  return TEST_RESULT();
+}
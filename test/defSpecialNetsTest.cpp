@@ -0,0 +1,112 @@
+/**
+ * Author:      Jude de Villiers
+ * Origin:      E&E Engineering - Stellenbosch University
+ * For:         Supertools, Coldflux Project - IARPA
+ * Created:     2020-04-21
+ * Modified:
+ * license:
+ * Description: Special net wiring is found wherever the lines of a statement
+ *              break, and survives the snapshot
+ * File:        defSpecialNetsTest.cpp
+ */
+
+#include "chipsmith/ParserDef.hpp"
+#include <cstdio>
+#include <fstream>
+#include "testCheck.hpp"
+
+using namespace std;
+
+static const char *specialDEF =
+  "DESIGN snets ;\n"
+  "UNITS DISTANCE MICRONS 100 ;\n"
+  "DIEAREA ( 0 0 ) ( 5000 5000 ) ;\n"
+  "\n"
+  "SPECIALNETS 5 ;\n"
+  "- VDD ( * VDD )\n"
+  "+ ROUTED metal2 450 ( 1000 1000 ) ( 4000 * )\n"
+  "NEW metal2 450 ( 1000 3000 ) ( 4000 * ) ;\n"
+  "- VDDA ( * VDDA ) + ROUTED metal1 300 ( 0 0 ) ( 100 * ) ;\n"
+  "- GND ( * GND ) + USE GROUND + ROUTED metal2 200 ( 0 0 ) ( * 50 ) via1 NEW metal1 200 ( 0 50 ) ( 10 * ) ;\n"
+  "- VBIAS ( * VBIAS )\n"
+  "+ USE POWER + ROUTED metal1 100 + SHAPE STRIPE ( 5 5 ) ( 5 * 0 )\n"
+  "  ( 5 500 ) MASK 2 via2 + SOURCE NETLIST ;\n"
+  "- SH ( * SH )\n"
+  "+ SHIELD VBIAS metal2 50 ( 1 2 )\n"
+  "  ( 3 * ) ;\n"
+  "END SPECIALNETS\n"
+  "\n"
+  "END DESIGN\n";
+
+static bool routeIs(const net_route &route, const string &layer, unsigned int width,
+                    const vector<int> &ptX, const vector<int> &ptY, const string &via){
+  return route.LAYER == layer && route.trackWidth == width && route.ptX == ptX &&
+         route.ptY == ptY && route.VIA == via;
+}
+
+int main(){
+  const string defName = "snets.def";
+  const string cacheDir = "defSpecialNetsTest.cache";
+  ofstream(defName, ios::trunc) << specialDEF;
+  remove(cacheFileName(defName, cacheDir).c_str());
+
+  def_file parsed;
+  CHECK(parsed.importFile(defName));
+  CHECK(parsed.snets.size() == 5);
+  if(parsed.snets.size() != 5) return TEST_RESULT();
+
+  // Wiring on lines of its own
+  const def_net &vdd = parsed.snets[0];
+  CHECK(vdd.name == "VDD");
+  CHECK(vdd.routes.size() == 2);
+  if(vdd.routes.size() == 2){
+    CHECK(routeIs(vdd.routes[0], "metal2", 450, {1000, 4000}, {1000, 1000}, "\0"));
+    CHECK(routeIs(vdd.routes[1], "metal2", 450, {1000, 4000}, {3000, 3000}, "\0"));
+  }
+
+  // Wiring on the first line of the statement
+  const def_net &vdda = parsed.snets[1];
+  CHECK(vdda.name == "VDDA");
+  CHECK(vdda.routes.size() == 1);
+  if(vdda.routes.size() == 1){
+    CHECK(routeIs(vdda.routes[0], "metal1", 300, {0, 100}, {0, 0}, "\0"));
+  }
+
+  // Another attribute and the wiring on one line
+  const def_net &gnd = parsed.snets[2];
+  CHECK(gnd.routes.size() == 2);
+  if(gnd.routes.size() == 2){
+    CHECK(routeIs(gnd.routes[0], "metal2", 200, {0, 0}, {0, 50}, "via1"));
+    CHECK(routeIs(gnd.routes[1], "metal1", 200, {0, 10}, {50, 50}, "\0"));
+  }
+
+  // Shape, extension value and mask within the wiring, points carried over
+  // to the next line and an attribute after the wiring
+  const def_net &bias = parsed.snets[3];
+  CHECK(bias.routes.size() == 1);
+  if(bias.routes.size() == 1){
+    CHECK(routeIs(bias.routes[0], "metal1", 100, {5, 5, 5}, {5, 5, 500}, "via2"));
+  }
+
+  // SHIELD names the shielded net before the layer
+  const def_net &shield = parsed.snets[4];
+  CHECK(shield.routes.size() == 1);
+  if(shield.routes.size() == 1){
+    CHECK(routeIs(shield.routes[0], "metal2", 50, {1, 3}, {2, 2}, "\0"));
+  }
+
+  // Round trip through the snapshot
+  CHECK(!parsed.saveCache(defName, cacheDir));
+  def_file cached;
+  CHECK(!cached.loadCache(defName, cacheDir));
+  CHECK(cached == parsed);
+
+  // A special net that cannot be parsed fails the import
+  string broken = specialDEF;
+  broken.replace(broken.find("( 1 2 )"), 7, "( * 2 )");
+  ofstream(defName, ios::trunc) << broken;
+  def_file failed;
+  CHECK(!failed.importFile(defName));
+
+  return TEST_RESULT();
+}
@@ -0,0 +1,119 @@
+/**
+ * Author:      Jude de Villiers
+ * Origin:      E&E Engineering - Stellenbosch University
+ * For:         Supertools, Coldflux Project - IARPA
+ * Created:     2020-04-21
+ * Modified:
+ * license:
+ * Description: The tokenizer splits lines like the stream parsers did, and
+ *              converts its tokens like stoi and stod
+ * File:        fileTokenizerTest.cpp
+ */
+
+#include "chipsmith/genFunc.hpp"
+#include <sstream>
+#include "testCheck.hpp"
+
+using namespace std;
+
+static bool lineIs(const fileTokenizer &tok, const vector<string> &expected){
+  if(tok.size() != expected.size()) return false;
+  for(size_t i = 0; i < expected.size(); i++){
+    if(tok[i] != expected[i]) return false;
+  }
+  return true;
+}
+
+// Comments, empty lines, tabs, carriage returns and no newline at the end
+static void lines(){
+  const string text =
+    "# header comment\n"
+    "\n"
+    "VERSION 5.8 ;\n"
+    "   \t \n"
+    "\tMACRO  AND2\r\n"
+    "  # not a comment once indented\n"
+    "END AND2";
+  fileTokenizer tok;
+  CHECK(!tok.open(string_view(text)));
+  CHECK(tok.nextLine() && lineIs(tok, {"VERSION", "5.8", ";"}));
+  CHECK(tok.nextLine() && lineIs(tok, {"MACRO", "AND2"}));
+  CHECK(tok.nextLine() && lineIs(tok, {"#", "not", "a", "comment", "once", "indented"}));
+  CHECK(tok.nextLine() && lineIs(tok, {"END", "AND2"}));
+  CHECK(tok.back() == "AND2");
+  // Past the end of the line and of the file everything is empty
+  CHECK(tok[2].empty() && tok[100].empty());
+  CHECK(!tok.nextLine());
+  CHECK(tok.size() == 0 && tok.back().empty() && tok[0].empty());
+  CHECK(tok.rest().empty());
+}
+
+// A statement found in rest() is split on its own, then reading carries on
+// after it
+static void restAndSeek(){
+  const string text = "DESIGN top ;\n- a ( * VDD )\n+ ROUTED m1 10 ( 0 0 ) ;\nEND DESIGN\n";
+  fileTokenizer tok;
+  tok.open(string_view(text));
+  CHECK(tok.nextLine() && tok[1] == "top");
+  string_view rest = tok.rest();
+  CHECK(rest.front() == '-');
+  size_t stop = rest.find(';');
+  fileTokenizer statement;
+  statement.open(rest.substr(0, stop + 1));
+  CHECK(statement.nextLine() && lineIs(statement, {"-", "a", "(", "*", "VDD", ")"}));
+  CHECK(statement.nextLine() && statement[1] == "ROUTED" && statement.back() == ";");
+  CHECK(!statement.nextLine());
+
+  tok.seek(rest.data() + stop + 1);
+  CHECK(tok.nextLine() && lineIs(tok, {"END", "DESIGN"}));
+  CHECK(!tok.nextLine());
+}
+
+// A mapped file gives the tokens a line by line stream split gives
+static void sameAsStream(const string &fileName){
+  fileTokenizer tok;
+  CHECK(!tok.open(fileName));
+  ifstream inFile(fileName);
+  string lineIn;
+  size_t lineCnt = 0;
+  while(getline(inFile, lineIn)){
+    if(lineIn.empty() || lineIn.front() == '#') continue;
+    istringstream words(lineIn);
+    vector<string> expected;
+    for(string word; words >> word;) expected.push_back(word);
+    if(expected.empty()) continue;
+    CHECK(tok.nextLine() && lineIs(tok, expected));
+    lineCnt++;
+  }
+  CHECK(!tok.nextLine());
+  CHECK(lineCnt > 0);
+
+  // Closed, or never there
+  tok.close();
+  CHECK(!tok.nextLine());
+  CHECK(tok.open(fileName + ".missing"));
+}
+
+static void conversions(){
+  CHECK(svToInt("42") == 42);
+  CHECK(svToInt("+7") == 7);
+  CHECK(svToInt("-13") == -13);
+  CHECK(svToInt("12abc") == 12);
+  CHECK(svToInt("abc") == 0);
+  CHECK(svToInt("") == 0);
+  CHECK(svToDouble("0.5") == 0.5);
+  CHECK(svToDouble("+2.25") == 2.25);
+  CHECK(svToDouble("-1e3") == -1000);
+  CHECK(svToDouble("7") == 7);
+  CHECK(svToDouble("x") == 0);
+  CHECK(svToDouble("") == 0);
+}
+
+int main(){
+  lines();
+  restAndSeek();
+  sameAsStream(TEST_DATA_DIR "/small.lef");
+  sameAsStream(TEST_DATA_DIR "/small.def");
+  conversions();
+  return TEST_RESULT();
+}
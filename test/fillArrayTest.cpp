@@ -0,0 +1,130 @@
+/**
+ * Author:      Jude de Villiers
+ * Origin:      E&E Engineering - Stellenbosch University
+ * For:         Supertools, Coldflux Project - IARPA
+ * Created:     2020-04-21
+ * Modified:
+ * license:
+ * Description: Fill placed as AREFs covers exactly the cells an SREF per
+ *              free cell would
+ * File:        fillArrayTest.cpp
+ */
+
+#include "chipsmith/chipFill.hpp"
+#include <random>
+#include "testCheck.hpp"
+
+using namespace std;
+
+static const int originX = -5000;
+static const int originY = -7000;
+static const int pitch = 10000;
+
+// Cell of a placement; false if it is not on the grid
+static bool cellOf(int corX, int corY, const fillGrid &grid, unsigned int &x, unsigned int &y){
+  if((corX - originX) % pitch || (corY - originY) % pitch) return false;
+  long long cellX = (corX - originX) / pitch, cellY = (corY - originY) / pitch;
+  if(cellX < 0 || cellY < 0 || cellX >= grid.size() || cellY >= grid.sizeOfRow()) return false;
+  x = cellX;
+  y = cellY;
+  return true;
+}
+
+// Expands the AREFs and SREFs into cells, every free cell has to be placed
+// once and nothing else
+static bool coversGrid(const fillGrid &grid, const gdsSTR &target, unsigned int maxCnt){
+  const gdsName fillName("FILL");
+  vector<unsigned int> placed((size_t)grid.size() * grid.sizeOfRow(), 0);
+  unsigned int x, y;
+
+  for(size_t i = 0; i < target.SREFcols.size(); i++){
+    if(target.SREFcols.name[i] != fillName || target.SREFcols.transform[i] != 0) return false;
+    if(!cellOf(target.SREFcols.xCor[i], target.SREFcols.yCor[i], grid, x, y)) return false;
+    placed[(size_t)x * grid.sizeOfRow() + y]++;
+  }
+
+  for(const auto &foo: target.AREF){
+    if(foo.name != fillName || foo.colCnt < 1 || foo.rowCnt < 1) return false;
+    if((unsigned int)foo.colCnt > maxCnt || (unsigned int)foo.rowCnt > maxCnt) return false;
+    // A lone cell is an SREF
+    if(foo.colCnt == 1 && foo.rowCnt == 1) return false;
+    if(foo.yCorRow != foo.yCor || foo.xCorCol != foo.xCor) return false;
+    if((foo.xCorRow - foo.xCor) % foo.colCnt || (foo.yCorCol - foo.yCor) % foo.rowCnt) return false;
+    int colPitch = (foo.xCorRow - foo.xCor) / foo.colCnt;
+    int rowPitch = (foo.yCorCol - foo.yCor) / foo.rowCnt;
+    for(int c = 0; c < foo.colCnt; c++){
+      for(int r = 0; r < foo.rowCnt; r++){
+        if(!cellOf(foo.xCor + c * colPitch, foo.yCor + r * rowPitch, grid, x, y)) return false;
+        placed[(size_t)x * grid.sizeOfRow() + y]++;
+      }
+    }
+  }
+
+  for(x = 0; x < grid.size(); x++){
+    for(y = 0; y < grid.sizeOfRow(); y++){
+      if(placed[(size_t)x * grid.sizeOfRow() + y] != (grid.get(x, y) ? 1u : 0u)) return false;
+    }
+  }
+  return true;
+}
+
+static bool placeAndCheck(const fillGrid &grid, unsigned int maxCnt){
+  gdsSTR target;
+  if(placeFillArray(grid, gdsName("FILL"), originX, originY, pitch, target, maxCnt)) return false;
+  return coversGrid(grid, target, maxCnt);
+}
+
+// Free areas with gates, vias and tracks taken out of them
+static void randomGrids(){
+  mt19937 random(2020);
+  for(int run = 0; run < 20; run++){
+    fillGrid grid;
+    grid.reset(40 + run, 70 + 3 * run, true);
+    uniform_int_distribution<int> pickX(0, grid.size()), pickY(0, grid.sizeOfRow()), size(1, 12);
+    for(int r = 0; r < 30; r++){
+      int x = pickX(random), y = pickY(random);
+      grid.clearRect(x, y, x + size(random), y + size(random));
+    }
+    CHECK(placeAndCheck(grid, 32767));
+    // Small limits split the rectangles like the real one does on huge dies
+    CHECK(placeAndCheck(grid, 3));
+    CHECK(placeAndCheck(grid, 1));
+  }
+
+  // Lone cells only
+  fillGrid checker;
+  checker.reset(9, 9, true);
+  for(int x = 0; x < 9; x++){
+    for(int y = (x + 1) % 2; y < 9; y += 2){
+      checker.clearRect(x, y, x + 1, y + 1);
+    }
+  }
+  gdsSTR target;
+  CHECK(!placeFillArray(checker, gdsName("FILL"), originX, originY, pitch, target));
+  CHECK(target.AREF.empty() && target.SREFcols.size() == checker.count());
+  CHECK(coversGrid(checker, target, 32767));
+
+  fillGrid empty;
+  empty.reset(5, 5, false);
+  CHECK(placeAndCheck(empty, 32767));
+}
+
+// Runs longer than an AREF can hold are split at the limit
+static void longRuns(){
+  fillGrid column;
+  column.reset(2, 70000, true);
+  gdsSTR target;
+  CHECK(!placeFillArray(column, gdsName("FILL"), originX, originY, pitch, target));
+  CHECK(target.AREF.size() == 3);
+  CHECK(coversGrid(column, target, 32767));
+
+  fillGrid row;
+  row.reset(40000, 2, true);
+  CHECK(placeAndCheck(row, 32767));
+}
+
+int main(){
+  randomGrids();
+  longRuns();
+  return TEST_RESULT();
+}
@@ -0,0 +1,183 @@
+/**
+ * Author:      Jude de Villiers
+ * Origin:      E&E Engineering - Stellenbosch University
+ * For:         Supertools, Coldflux Project - IARPA
+ * Created:     2020-04-21
+ * Modified:
+ * license:
+ * Description: The packed fill grid clears and finds the same cells as one
+ *              bool per cell does
+ * File:        fillGridTest.cpp
+ */
+
+#include "chipsmith/fillGrid.hpp"
+#include <algorithm>
+#include <random>
+#include "testCheck.hpp"
+
+using namespace std;
+
+/**
+ * [referenceGrid - One bool per cell, cleared cell by cell]
+ */
+struct referenceGrid{
+  unsigned int lx = 0;
+  unsigned int ly = 0;
+  vector<bool> cells;
+
+  void reset(unsigned int sizeX, unsigned int sizeY, bool value){
+    lx = sizeX;
+    ly = sizeY;
+    cells.assign((size_t)lx * ly, value);
+  }
+  bool get(unsigned int x, unsigned int y) const { return cells[(size_t)x * ly + y]; };
+  void clearRect(int x0, int y0, int x1, int y1){
+    for(int x = max(x0, 0); x < min(x1, (int)lx); x++){
+      for(int y = max(y0, 0); y < min(y1, (int)ly); y++){
+        cells[(size_t)x * ly + y] = false;
+      }
+    }
+  }
+};
+
+// Every cell, the count and the run scans agree
+static bool sameAsReference(const fillGrid &grid, const referenceGrid &ref){
+  if(grid.size() != ref.lx || grid.sizeOfRow() != ref.ly) return false;
+  size_t setCnt = 0;
+  for(unsigned int x = 0; x < ref.lx; x++){
+    unsigned int nextSet = ref.ly, nextClear = ref.ly;
+    for(unsigned int y = ref.ly; y-- > 0;){
+      if(ref.get(x, y)){
+        nextSet = y;
+        setCnt++;
+      }
+      else nextClear = y;
+      if(grid.get(x, y) != ref.get(x, y)) return false;
+      if(grid.nextSet(x, y) != nextSet || grid.nextClear(x, y) != nextClear) return false;
+    }
+    if(grid.nextSet(x, ref.ly) != ref.ly || grid.nextClear(x, ref.ly) != ref.ly) return false;
+  }
+  return grid.count() == setCnt;
+}
+
+// Rectangles that start and end on either side of the word edges
+static void rectWordEdges(){
+  const int edges[] = {0, 1, 63, 64, 65, 127, 128, 129, 199, 200};
+  for(int y0: edges){
+    for(int y1: edges){
+      if(y1 <= y0) continue;
+      fillGrid grid;
+      referenceGrid ref;
+      grid.reset(4, 200, true);
+      ref.reset(4, 200, true);
+      grid.clearRect(1, y0, 3, y1);
+      ref.clearRect(1, y0, 3, y1);
+      CHECK(sameAsReference(grid, ref));
+    }
+  }
+
+  // Clipped to the grid, empty rectangles leave it alone
+  fillGrid grid;
+  referenceGrid ref;
+  grid.reset(4, 200, true);
+  ref.reset(4, 200, true);
+  grid.clearRect(-5, -5, 1, 64);
+  ref.clearRect(0, 0, 1, 64);
+  grid.clearRect(3, 128, 10, 1000);
+  ref.clearRect(3, 128, 4, 200);
+  grid.clearRect(2, 50, 2, 100);
+  grid.clearRect(2, 70, 3, 70);
+  CHECK(sameAsReference(grid, ref));
+}
+
+// Tracks clear their full width, square ends reach half the width further
+static void segments(){
+  const int pitch = 10;
+  fillGrid grid;
+  referenceGrid ref;
+
+  // Vertical at x = 25, 10 wide: cells 2 in x; 640 to 1280 in y
+  grid.reset(6, 200, true);
+  ref.reset(6, 200, true);
+  CHECK(!grid.clearSegment(25, 1280, 25, 640, 10, false, pitch));
+  ref.clearRect(2, 64, 3, 128);
+  CHECK(sameAsReference(grid, ref));
+
+  grid.reset(6, 200, true);
+  ref.reset(6, 200, true);
+  CHECK(!grid.clearSegment(25, 640, 25, 1280, 10, true, pitch));
+  ref.clearRect(2, 63, 3, 129);
+  CHECK(sameAsReference(grid, ref));
+
+  // Horizontal at y = 635, 20 wide: cells 62 to 64 in y, across a word edge
+  grid.reset(6, 200, true);
+  ref.reset(6, 200, true);
+  CHECK(!grid.clearSegment(10, 635, 40, 635, 20, false, pitch));
+  ref.clearRect(1, 62, 4, 65);
+  CHECK(sameAsReference(grid, ref));
+
+  grid.reset(6, 200, true);
+  ref.reset(6, 200, true);
+  CHECK(!grid.clearSegment(40, 635, 10, 635, 20, true, pitch));
+  ref.clearRect(0, 62, 5, 65);
+  CHECK(sameAsReference(grid, ref));
+
+  // No width or no size still clears the cell it lies in, outside the grid
+  // nothing
+  grid.reset(6, 200, true);
+  ref.reset(6, 200, true);
+  CHECK(!grid.clearSegment(30, 0, 30, 100, 0, false, pitch));
+  ref.clearRect(3, 0, 4, 10);
+  grid.clearArea(-1, 1275, -1, 1275, pitch);
+  CHECK(sameAsReference(grid, ref));
+  grid.clearArea(55, 1275, 55, 1275, pitch);
+  ref.clearRect(5, 127, 6, 128);
+  CHECK(sameAsReference(grid, ref));
+
+  // Not Manhattan, nothing is cleared
+  CHECK(grid.clearSegment(0, 0, 10, 10, 10, false, pitch));
+  CHECK(sameAsReference(grid, ref));
+}
+
+// Random rectangles on grids of every padding, with the row checks of the
+// fill placement
+static void randomRects(){
+  mt19937 random(2020);
+  for(unsigned int ly: {1u, 63u, 64u, 65u, 130u, 300u}){
+    for(bool value: {true, false}){
+      fillGrid grid;
+      referenceGrid ref;
+      grid.reset(7, ly, value);
+      ref.reset(7, ly, value);
+      // The padding past ly is never counted or found
+      CHECK(grid.count() == (value ? 7 * ly : 0));
+      CHECK(sameAsReference(grid, ref));
+
+      uniform_int_distribution<int> pickX(-2, 9), pickY(-10, ly + 10);
+      for(int r = 0; r < 40; r++){
+        int x0 = pickX(random), x1 = pickX(random);
+        int y0 = pickY(random), y1 = pickY(random);
+        grid.clearRect(x0, y0, x1, y1);
+        ref.clearRect(x0, y0, x1, y1);
+      }
+      CHECK(sameAsReference(grid, ref));
+
+      uniform_int_distribution<unsigned int> spanY(0, ly);
+      for(unsigned int x = 0; x < 7; x++){
+        for(int r = 0; r < 20; r++){
+          unsigned int y0 = spanY(random), y1 = spanY(random);
+          bool all = true;
+          for(unsigned int y = y0; y < y1; y++) all = all && ref.get(x, y);
+          CHECK(grid.allSet(x, y0, y1) == all);
+        }
+      }
+    }
+  }
+}
+
+int main(){
+  randomRects();
+  rectWordEdges();
+  segments();
+  return TEST_RESULT();
+}
@@ -0,0 +1,183 @@
+/**
+ * Author:      J.F. de Villiers & H.F. Herbst
+ * Origin:  		E&E Engineering - Stellenbosch University
+ * For:					Supertools, Coldflux Project - IARPA
+ * Created: 		2019-08-26
+ * Modified:
+ * license:     MIT License
+ * Description: Cached bounding boxes follow elements added anywhere below
+ * File:				gdsBoundingBoxTest.cpp
+ */
+
+#include "gdscpp/gdsCpp.hpp"
+#include "testCheck.hpp"
+
+using namespace std;
+
+// Square of side size with its lower left corner at x, y
+static gdsSTR square_STR(const string &name, int x, int y, int size)
+{
+  gdsSTR foo;
+  foo.name = name;
+  foo.BOUNDARYarena.push_back(1, 0, 0, 0, {x, x + size, x + size, x, x},
+                              {y, y, y + size, y + size, y});
+  return foo;
+}
+
+static bool box_is(gdscpp &lib, const string &name, int x1, int y1, int x2,
+                   int y2)
+{
+  int b_box[4];
+  if (lib.calculate_STR_bounding_box(lib.STR_index(name), b_box))
+    return false;
+  return b_box[0] == x1 && b_box[1] == y1 && b_box[2] == x2 && b_box[3] == y2;
+}
+
+// Elements appended to a child reach the cached box of its parent, without
+// the child being asked for its box first
+static void append_to_child()
+{
+  gdscpp lib;
+  lib.push_back_STR(square_STR("CHILD", 0, 0, 10));
+  gdsSTR top;
+  top.name = "TOP";
+  top.SREFcols.push_back(gdsName("CHILD"), 100, 0);
+  lib.push_back_STR(top);
+  CHECK(box_is(lib, "TOP", 100, 0, 110, 10));
+
+  lib.STR[lib.STR_index("CHILD")].BOUNDARYarena.push_back(
+      1, 0, 0, 0, {0, 50, 50, 0, 0}, {0, 0, 50, 50, 0});
+  CHECK(box_is(lib, "TOP", 100, 0, 150, 50));
+
+  lib.STR[lib.STR_index("CHILD")].PATHarena.push_back(1, 0, 0, 0, {-20, 0},
+                                                      {0, 0});
+  CHECK(box_is(lib, "TOP", 80, 0, 150, 50));
+}
+
+// A new reference on a structure in the library joins the graph, so later
+// changes below it still reach the top
+static void append_reference()
+{
+  gdscpp lib;
+  lib.push_back_STR(square_STR("LEAF", 0, 0, 10));
+  lib.push_back_STR(square_STR("MID", 0, 0, 10));
+  gdsSTR top;
+  top.name = "TOP";
+  top.SREFcols.push_back(gdsName("MID"), 0, 0);
+  lib.push_back_STR(top);
+  CHECK(box_is(lib, "TOP", 0, 0, 10, 10));
+
+  lib.STR[lib.STR_index("MID")].SREFcols.push_back(gdsName("LEAF"), 0, 100);
+  CHECK(box_is(lib, "TOP", 0, 0, 10, 110));
+
+  lib.STR[lib.STR_index("LEAF")].BOUNDARYarena.push_back(
+      1, 0, 0, 0, {0, 30, 30, 0, 0}, {0, 0, 30, 30, 0});
+  CHECK(box_is(lib, "TOP", 0, 0, 30, 130));
+}
+
+// A structure added after its parent asked for a box it could not find
+static void late_structure()
+{
+  gdscpp lib;
+  gdsSTR top = square_STR("TOP", 0, 0, 10);
+  top.SREFcols.push_back(gdsName("LATE"), 0, 0);
+  lib.push_back_STR(top);
+  CHECK(box_is(lib, "TOP", 0, 0, 10, 10));
+
+  lib.push_back_STR(square_STR("LATE", 50, 50, 10));
+  CHECK(box_is(lib, "TOP", 0, 0, 60, 60));
+}
+
+// Growing STR moves the structures, they have to stay owned
+static void owner_survives_growth()
+{
+  gdscpp lib;
+  lib.push_back_STR(square_STR("CHILD", 0, 0, 10));
+  gdsSTR top;
+  top.name = "TOP";
+  top.SREFcols.push_back(gdsName("CHILD"), 0, 0);
+  lib.push_back_STR(top);
+  CHECK(box_is(lib, "TOP", 0, 0, 10, 10));
+  for (int i = 0; i < 100; i++)
+    lib.push_back_STR(square_STR("FILL" + to_string(i), 0, 0, 1));
+
+  lib.STR[lib.STR_index("CHILD")].BOUNDARYarena.push_back(
+      1, 0, 0, 0, {0, 70, 70, 0, 0}, {0, 0, 70, 70, 0});
+  CHECK(box_is(lib, "TOP", 0, 0, 70, 70));
+
+  // A copy belongs to no library, changing it leaves the cache alone
+  gdsSTR copy = lib.STR[lib.STR_index("CHILD")];
+  copy.BOUNDARYarena.push_back(1, 0, 0, 0, {0, 900, 900, 0, 0},
+                               {0, 0, 900, 900, 0});
+  CHECK(box_is(lib, "TOP", 0, 0, 70, 70));
+}
+
+// The element vectors are watched like the arenas
+static void element_vectors()
+{
+  gdscpp lib;
+  lib.push_back_STR(square_STR("LEAF", 0, 0, 10));
+  lib.push_back_STR(square_STR("CHILD", 0, 0, 10));
+  gdsSTR top;
+  top.name = "TOP";
+  top.SREFcols.push_back(gdsName("CHILD"), 0, 0);
+  lib.push_back_STR(top);
+  CHECK(box_is(lib, "TOP", 0, 0, 10, 10));
+
+  gdsBOUNDARY far;
+  far.xCor = {0, 40, 40, 0, 0};
+  far.yCor = {0, 0, 40, 40, 0};
+  int child = lib.STR_index("CHILD");
+  lib.STR[child].BOUNDARY.push_back(far);
+  CHECK(box_is(lib, "TOP", 0, 0, 40, 40));
+
+  // A new reference joins the graph as well
+  gdsSREF ref;
+  ref.name = gdsName("LEAF");
+  ref.xCor = 100;
+  ref.yCor = 200;
+  ref.classify();
+  lib.STR[child].SREF.push_back(ref);
+  CHECK(box_is(lib, "TOP", 0, 0, 110, 210));
+  lib.STR[lib.STR_index("LEAF")].BOUNDARYarena.push_back(
+      1, 0, 0, 0, {0, 30, 30, 0, 0}, {0, 0, 30, 30, 0});
+  CHECK(box_is(lib, "TOP", 0, 0, 130, 230));
+
+  gdsAREF array;
+  array.name = gdsName("LEAF");
+  array.colCnt = 2;
+  array.rowCnt = 1;
+  array.xCor = -300;
+  array.yCor = 0;
+  array.xCorRow = -200; // Two columns 50 apart
+  array.yCorRow = 0;
+  array.xCorCol = -300; // One row
+  array.yCorCol = 60;
+  lib.STR[child].AREF.push_back(array);
+  CHECK(box_is(lib, "TOP", -300, 0, 130, 230));
+
+  lib.STR[child].SREF.clear();
+  lib.STR[child].AREF.clear();
+  CHECK(box_is(lib, "TOP", 0, 0, 40, 40));
+
+  gdsBOX box;
+  box.xCor = {0, 0, 45, 45, 0};
+  box.yCor = {0, 45, 45, 0, 0};
+  lib.STR[child].BOX.push_back(box);
+  CHECK(box_is(lib, "TOP", 0, 0, 45, 45));
+
+  // Changes in place still need invalidate_bounding_box
+  lib.STR[child].BOUNDARY[0].xCor = {0, 90, 90, 0, 0};
+  lib.invalidate_bounding_box(child);
+  CHECK(box_is(lib, "TOP", 0, 0, 90, 45));
+}
+
+int main()
+{
+  append_to_child();
+  append_reference();
+  late_structure();
+  owner_survives_growth();
+  element_vectors();
+  return TEST_RESULT();
+}
@@ -0,0 +1,110 @@
+/**
+ * Author:      Jude de Villiers
+ * Origin:      E&E Engineering - Stellenbosch University
+ * For:         Supertools, Coldflux Project - IARPA
+ * Created:     2020-04-21
+ * Modified:
+ * license:
+ * Description: GDS snapshots keep the structures in their file and give the
+ *              same bounding boxes as decoding the library
+ * File:        gdsCacheTest.cpp
+ */
+
+#include "chipsmith/gdsCache.hpp"
+#include <cstdio>
+#include "testCheck.hpp"
+
+using namespace std;
+
+static const string cacheDir = "gdsCacheTest.cache";
+
+static gdsSTR squareSTR(const string &name, int size){
+  gdsSTR foo;
+  foo.name = name;
+  foo.compact_geometry = true;
+  foo.BOUNDARYarena.push_back(1, 0, 0, 0, {0, size, size, 0, 0}, {0, 0, size, size, 0});
+  return foo;
+}
+
+static void writeLibrary(const string &fileName, int leafSize){
+  gdscpp lib;
+  lib.push_back_STR(squareSTR("LEAF", leafSize));
+  gdsSTR mid;
+  mid.name = "MID";
+  mid.SREFcols.push_back(gdsName("LEAF"), 0, 100, 1);
+  mid.SREFcols.push_back(gdsName("LEAF"), 50, 0);
+  lib.push_back_STR(mid);
+  gdsSTR top = squareSTR("TOP", 5);
+  top.SREFcols.push_back(gdsName("MID"), 1000, 0, 0, true);
+  lib.push_back_STR(top);
+  lib.write(fileName);
+}
+
+static bool sameBox(gdscpp &lib, gdscpp &other, const string &name){
+  int box[4], otherBox[4];
+  if(lib.calculate_STR_bounding_box(lib.STR_index(name), box)) return false;
+  if(other.calculate_STR_bounding_box(other.STR_index(name), otherBox)) return false;
+  return equal(box, box + 4, otherBox);
+}
+
+// Cold and warm imports give the boxes of a plain import and leave the
+// structures in the file
+static void coldAndWarm(const string &fileName){
+  gdscpp plain;
+  plain.set_compact_geometry(true);
+  CHECK(!plain.import_lazy(fileName));
+
+  for(int run = 0; run < 2; run++){
+    gdscpp cached;
+    cached.set_compact_geometry(true);
+    CHECK(!importCachedGDS(cached, fileName, true, cacheDir));
+    CHECK(cached.STR.size() == 3);
+    for(const auto &foo: {"LEAF", "MID", "TOP"}){
+      CHECK(sameBox(cached, plain, foo));
+    }
+    // The boxes came from the snapshot, nothing had to be decoded
+    for(const auto &foo: cached.STR){
+      CHECK(!foo.is_loaded());
+    }
+  }
+}
+
+// A box from the snapshot still follows changes made below it
+static void restoredBoxesFollowChanges(const string &fileName){
+  gdscpp cached;
+  cached.set_compact_geometry(true);
+  CHECK(!importCachedGDS(cached, fileName, true, cacheDir));
+  int box[4];
+  CHECK(!cached.calculate_STR_bounding_box(cached.STR_index("TOP"), box));
+  const int oldRight = box[2];
+
+  int leaf = cached.STR_index("LEAF");
+  CHECK(!cached.load_STR(leaf));
+  cached.STR[leaf].BOUNDARYarena.push_back(1, 0, 0, 0, {0, 5000, 5000, 0, 0}, {0, 0, 5000, 5000, 0});
+  CHECK(!cached.calculate_STR_bounding_box(cached.STR_index("TOP"), box));
+  CHECK(box[2] > oldRight);
+}
+
+// A changed library is not read from its old snapshot
+static void changedFile(const string &fileName){
+  writeLibrary(fileName, 20);
+  gdscpp plain;
+  plain.set_compact_geometry(true);
+  CHECK(!plain.import_lazy(fileName));
+  gdscpp cached;
+  cached.set_compact_geometry(true);
+  CHECK(!importCachedGDS(cached, fileName, true, cacheDir));
+  for(const auto &foo: {"LEAF", "MID", "TOP"}){
+    CHECK(sameBox(cached, plain, foo));
+  }
+}
+
+int main(){
+  const string fileName = "gdsCacheTest.gds";
+  remove(cacheFileName(fileName, cacheDir).c_str());
+  writeLibrary(fileName, 10);
+  coldAndWarm(fileName);
+  restoredBoxesFollowChanges(fileName);
+  changedFile(fileName);
+  return TEST_RESULT();
+}
@@ -0,0 +1,220 @@
+/**
+ * Author:      Jude de Villiers
+ * Origin:      E&E Engineering - Stellenbosch University
+ * For:         Supertools, Coldflux Project - IARPA
+ * Created:     2020-04-21
+ * Modified:
+ * license:
+ * Description: A GDS file imported on one thread and on several threads gives
+ *              the same structures, hierarchy and bounding boxes
+ * File:        gdsImportTest.cpp
+ */
+
+#include "gdscpp/gdsCpp.hpp"
+#include <fstream>
+#include <iterator>
+#include "testCheck.hpp"
+
+using namespace std;
+
+static const int leafCnt = 40;
+static const int midCnt = 20;
+static const int topCnt = 5;
+
+// Parents come before the structures they reference, so the hierarchy can
+// only be found once every structure is in
+static void writeLibrary(const string &fileName){
+  gdscpp lib;
+  for(int i = 0; i < topCnt; i++){
+    gdsSTR top;
+    top.name = "TOP" + to_string(i);
+    top.compact_geometry = true;
+    for(int j = 0; j < midCnt; j++){
+      top.SREFcols.push_back(gdsName("MID" + to_string((i + j) % midCnt)), j * 5000, i * 3000, j % 4, j % 2);
+    }
+    top.PATHarena.push_back(3, 0, 0, 10, {0, 100000, 100000}, {-500, -500, 40000 + i});
+    lib.push_back_STR(top);
+  }
+  for(int i = 0; i < midCnt; i++){
+    gdsSTR mid;
+    mid.name = "MID" + to_string(i);
+    mid.compact_geometry = true;
+    mid.SREFcols.push_back(gdsName("LEAF" + to_string(2 * i)), 0, 0);
+    gdsAREF array;
+    array.name = gdsName("LEAF" + to_string(2 * i + 1));
+    array.colCnt = 3;
+    array.rowCnt = 2;
+    array.xCor = 100;
+    array.yCor = 0;
+    array.xCorRow = 100 + 3 * 40 * (i + 1);
+    array.yCorRow = 0;
+    array.xCorCol = 100;
+    array.yCorCol = 2 * 50;
+    mid.AREF.push_back(array);
+    gdsTEXT text;
+    text.layer = 9;
+    text.textbody = mid.name;
+    mid.TEXT.push_back(text);
+    lib.push_back_STR(mid);
+  }
+  for(int i = 0; i < leafCnt; i++){
+    gdsSTR leaf;
+    leaf.name = "LEAF" + to_string(i);
+    leaf.compact_geometry = true;
+    for(int j = 0; j <= i; j++){
+      leaf.BOUNDARYarena.push_back(1 + j % 2, 0, 0, 0, {0, 10 + i, 10 + i, 0, 0}, {j, j, j + 10, j + 10, j});
+    }
+    // Seldom used attributes are kept aside in the arenas
+    gdsBOUNDARY tagged;
+    tagged.layer = 4;
+    tagged.plex = i;
+    tagged.propattr = 1;
+    tagged.propvalue = "tag" + to_string(i);
+    tagged.xCor = {0, 5, 5, 0, 0};
+    tagged.yCor = {0, 0, 5, 5, 0};
+    leaf.BOUNDARYarena.push_back(tagged);
+    gdsPATH wire;
+    wire.layer = 6;
+    wire.pathtype = 2;
+    wire.width = 4 + i;
+    wire.propattr = i % 2;
+    wire.xCor = {0, 10 * i, 10 * i};
+    wire.yCor = {0, 0, -i};
+    leaf.PATHarena.push_back(wire);
+    gdsBOX box;
+    box.layer = 10;
+    box.xCor = {-i, 0, 0, -i, -i};
+    box.yCor = {0, 0, 5, 5, 0};
+    leaf.BOX.push_back(box);
+    lib.push_back_STR(leaf);
+  }
+  lib.write(fileName);
+}
+
+static vector<unsigned char> readBytes(const string &fileName){
+  ifstream inFile(fileName, ios::binary);
+  return vector<unsigned char>((istreambuf_iterator<char>(inFile)), istreambuf_iterator<char>());
+}
+
+// The file with the dates of BGNLIB and BGNSTR zeroed, empty if it does not
+// read as records
+static vector<unsigned char> withoutDates(const string &fileName){
+  vector<unsigned char> bytes = readBytes(fileName);
+  for(size_t pos = 0; pos + 4 <= bytes.size();){
+    size_t length = (bytes[pos] << 8) | bytes[pos + 1];
+    if(length < 4 || pos + length > bytes.size()) return {};
+    if(bytes[pos + 2] == 0x01 || bytes[pos + 2] == 0x05){
+      fill(bytes.begin() + pos + 4, bytes.begin() + pos + length, 0);
+    }
+    pos += length;
+  }
+  return bytes;
+}
+
+static bool sameBoundary(const gdsBOUNDARY &foo, const gdsBOUNDARY &bar){
+  return foo.plex == bar.plex && foo.layer == bar.layer && foo.dataType == bar.dataType &&
+    foo.xCor == bar.xCor && foo.yCor == bar.yCor && foo.propattr == bar.propattr && foo.propvalue == bar.propvalue;
+}
+
+static bool samePath(const gdsPATH &foo, const gdsPATH &bar){
+  return foo.plex == bar.plex && foo.layer == bar.layer && foo.dataType == bar.dataType &&
+    foo.pathtype == bar.pathtype && foo.width == bar.width && foo.xCor == bar.xCor && foo.yCor == bar.yCor &&
+    foo.propattr == bar.propattr && foo.propvalue == bar.propvalue;
+}
+
+// Boundaries and paths decoded into the arenas are the ones decoded one by one
+static bool sameGeometry(const gdscpp &plain, const gdscpp &compact){
+  if(plain.STR.size() != compact.STR.size()) return false;
+  for(size_t i = 0; i < plain.STR.size(); i++){
+    const gdsSTR &foo = plain.STR[i], &bar = compact.STR[i];
+    if(!bar.BOUNDARY.empty() || !bar.PATH.empty()) return false;
+    if(foo.BOUNDARY.size() != bar.BOUNDARYarena.size() || foo.PATH.size() != bar.PATHarena.size()) return false;
+    for(size_t j = 0; j < foo.BOUNDARY.size(); j++){
+      if(!sameBoundary(foo.BOUNDARY[j], bar.BOUNDARYarena.boundary(j))) return false;
+    }
+    for(size_t j = 0; j < foo.PATH.size(); j++){
+      if(!samePath(foo.PATH[j], bar.PATHarena.path(j))) return false;
+    }
+  }
+  return true;
+}
+
+static bool sameElementCounts(const gdsSTR &foo, const gdsSTR &bar){
+  return foo.SREF.size() == bar.SREF.size() && foo.SREFcols.size() == bar.SREFcols.size() &&
+    foo.AREF.size() == bar.AREF.size() && foo.BOUNDARY.size() == bar.BOUNDARY.size() &&
+    foo.BOUNDARYarena.size() == bar.BOUNDARYarena.size() && foo.PATH.size() == bar.PATH.size() &&
+    foo.PATHarena.size() == bar.PATHarena.size() && foo.NODE.size() == bar.NODE.size() &&
+    foo.TEXT.size() == bar.TEXT.size() && foo.BOX.size() == bar.BOX.size();
+}
+
+// Same structures in the same order, then the same hierarchy and boxes; written
+// out again the libraries are identical
+static bool sameLibrary(gdscpp &lib, gdscpp &other){
+  if(lib.STR.size() != other.STR.size()) return false;
+  for(size_t i = 0; i < lib.STR.size(); i++){
+    if(lib.STR[i].name != other.STR[i].name || !sameElementCounts(lib.STR[i], other.STR[i])) return false;
+  }
+
+  if(lib.resolve_heirarchy_and_bounding_boxes() || other.resolve_heirarchy_and_bounding_boxes()) return false;
+  if(lib.get_highest_heirarchical_level() != other.get_highest_heirarchical_level()) return false;
+  for(size_t i = 0; i < lib.STR.size(); i++){
+    if(lib.STR[i].heirarchical_level != other.STR[i].heirarchical_level) return false;
+    int box[4], otherBox[4];
+    if(lib.calculate_STR_bounding_box(i, box) || other.calculate_STR_bounding_box(i, otherBox)) return false;
+    if(!equal(box, box + 4, otherBox)) return false;
+  }
+
+  if(lib.write("gdsImportTest.serial.gds") || other.write("gdsImportTest.parallel.gds")) return false;
+  vector<unsigned char> serial = withoutDates("gdsImportTest.serial.gds");
+  return !serial.empty() && serial == withoutDates("gdsImportTest.parallel.gds");
+}
+
+int main(){
+  const string fileName = "gdsImportTest.gds";
+  writeLibrary(fileName);
+
+  gdscpp plain, arenas, arenasParallel;
+  arenas.set_compact_geometry(true);
+  arenasParallel.set_compact_geometry(true);
+  CHECK(!plain.import(fileName));
+  CHECK(!arenas.import(fileName));
+  CHECK(!arenasParallel.import_parallel(fileName, 4));
+  CHECK(sameGeometry(plain, arenas));
+  CHECK(sameGeometry(plain, arenasParallel));
+
+  for(bool compact: {false, true}){
+    gdscpp serial;
+    serial.set_compact_geometry(compact);
+    CHECK(!serial.import(fileName));
+    CHECK(serial.STR.size() == topCnt + midCnt + leafCnt);
+    if(serial.STR.size() != topCnt + midCnt + leafCnt) return TEST_RESULT();
+    // The elements go where the geometry setting puts them
+    const gdsSTR &leaf = serial.STR[serial.STR_index("LEAF7")];
+    CHECK((compact ? leaf.BOUNDARYarena.size() : leaf.BOUNDARY.size()) == 9);
+
+    for(unsigned int threads: {1u, 2u, 4u, 0u}){
+      gdscpp parallel;
+      parallel.set_compact_geometry(compact);
+      CHECK(!parallel.import_parallel(fileName, threads));
+      CHECK(sameLibrary(serial, parallel));
+    }
+  }
+
+  // Tops on level 0, leaves on level 2
+  gdscpp lib;
+  CHECK(!lib.import_parallel(fileName, 4));
+  CHECK(!lib.resolve_heirarchy_and_bounding_boxes());
+  CHECK(lib.get_highest_heirarchical_level() == 2);
+  CHECK(lib.STR[lib.STR_index("TOP3")].heirarchical_level == 0);
+  CHECK(lib.STR[lib.STR_index("MID3")].heirarchical_level == 1);
+  CHECK(lib.STR[lib.STR_index("LEAF3")].heirarchical_level == 2);
+
+  // A file cut short is not imported
+  vector<unsigned char> bytes = readBytes(fileName);
+  ofstream cut("gdsImportTest.cut.gds", ios::binary | ios::trunc);
+  cut.write((const char *)bytes.data(), bytes.size() / 2);
+  cut.close();
+  gdscpp broken;
+  CHECK(broken.import_parallel("gdsImportTest.cut.gds", 4));
+  return TEST_RESULT();
+}
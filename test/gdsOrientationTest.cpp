@@ -0,0 +1,133 @@
+/**
+ * Author:      J.F. de Villiers & H.F. Herbst
+ * Origin:  		E&E Engineering - Stellenbosch University
+ * For:					Supertools, Coldflux Project - IARPA
+ * Created: 		2019-08-26
+ * Modified:
+ * license:     MIT License
+ * Description: References in the 8 Manhattan orientations get the boxes the
+ *              trigonometry of their angle and reflection gives
+ * File:				gdsOrientationTest.cpp
+ */
+
+#include "gdscpp/gdsCpp.hpp"
+#include "testCheck.hpp"
+
+using namespace std;
+
+// Lopsided and across the origin, so every swap and negation shows
+static const int child_box[4] = {-3, 5, 20, 11};
+
+// Box of child_box placed at (x, y) by rotating its 4 corners
+static void trig_box(int x, int y, double angle, bool reflection, int *box)
+{
+  const int corners[4][2] = {{child_box[0], child_box[1]},
+                             {child_box[2], child_box[1]},
+                             {child_box[2], child_box[3]},
+                             {child_box[0], child_box[3]}};
+  double c = cos(angle * M_PI / 180), s = sin(angle * M_PI / 180);
+  for (int i = 0; i < 4; i++) {
+    double cx = corners[i][0];
+    double cy = reflection ? -corners[i][1] : corners[i][1];
+    int px = (int)llround(c * cx - s * cy) + x;
+    int py = (int)llround(s * cx + c * cy) + y;
+    if (i == 0) {
+      box[0] = box[2] = px;
+      box[1] = box[3] = py;
+    }
+    box[0] = min(box[0], px);
+    box[1] = min(box[1], py);
+    box[2] = max(box[2], px);
+    box[3] = max(box[3], py);
+  }
+}
+
+static gdsSTR child_STR()
+{
+  gdsSTR foo;
+  foo.name = "CHILD";
+  const int *b = child_box;
+  foo.BOUNDARYarena.push_back(1, 0, 0, 0, {b[0], b[2], b[2], b[0], b[0]},
+                              {b[1], b[1], b[3], b[3], b[1]});
+  return foo;
+}
+
+static bool box_is(gdscpp &lib, const string &name, const int *expected)
+{
+  int b_box[4];
+  if (lib.calculate_STR_bounding_box(lib.STR_index(name), b_box))
+    return false;
+  return equal(b_box, b_box + 4, expected);
+}
+
+// Column references, classified SREFs and SREFs left to the trigonometry
+// all agree with the rotated corners
+static void every_orientation()
+{
+  const int x = 1000, y = -70;
+  for (unsigned int o = 0; o < 8; o++) {
+    const double angle = 90 * (o & 3);
+    const bool reflection = o & 4;
+    int expected[4];
+    trig_box(x, y, angle, reflection, expected);
+
+    gdscpp lib;
+    lib.push_back_STR(child_STR());
+
+    gdsSTR columns;
+    columns.name = "COLUMNS";
+    columns.SREFcols.push_back(gdsName("CHILD"), x, y, o & 3, reflection);
+    lib.push_back_STR(columns);
+
+    gdsSREF ref;
+    ref.name = gdsName("CHILD");
+    ref.xCor = x;
+    ref.yCor = y;
+    ref.angle = angle;
+    ref.reflection = reflection;
+    ref.classify();
+    CHECK(ref.orientation == (int)o);
+    gdsSTR classified;
+    classified.name = "CLASSIFIED";
+    classified.SREF.push_back(ref);
+    lib.push_back_STR(classified);
+
+    ref.orientation = -1;
+    gdsSTR trig;
+    trig.name = "TRIG";
+    trig.SREF.push_back(ref);
+    lib.push_back_STR(trig);
+
+    CHECK(box_is(lib, "COLUMNS", expected));
+    CHECK(box_is(lib, "CLASSIFIED", expected));
+    CHECK(box_is(lib, "TRIG", expected));
+  }
+}
+
+// Only whole quarter turns without a scale are Manhattan
+static void classification()
+{
+  gdsSREF ref;
+  const double angles[] = {-90, 360, 450, -630};
+  const int orientations[] = {3, 0, 1, 1};
+  for (int i = 0; i < 4; i++) {
+    ref.angle = angles[i];
+    ref.reflection = true;
+    ref.classify();
+    CHECK(ref.orientation == (orientations[i] | 4));
+  }
+  ref.angle = 45;
+  ref.classify();
+  CHECK(ref.orientation == -1);
+  ref.angle = 90;
+  ref.scale = 2;
+  ref.classify();
+  CHECK(ref.orientation == -1);
+}
+
+int main()
+{
+  every_orientation();
+  classification();
+  return TEST_RESULT();
+}
@@ -0,0 +1,158 @@
+/**
+ * Author:      J.F. de Villiers & H.F. Herbst
+ * Origin:  		E&E Engineering - Stellenbosch University
+ * For:					Supertools, Coldflux Project - IARPA
+ * Created: 		2019-10-14
+ * Modified:
+ * license:     MIT License
+ * Description: Composed transforms place points like their parts, and a
+ *              flattened hierarchy lands where its references put it
+ * File:				gdsTransformTest.cpp
+ */
+
+#include "gdscpp/gdsCpp.hpp"
+#include "testCheck.hpp"
+
+using namespace std;
+
+static const vector<int> points = {0,  0,  7, 0,   7,     3,      -5,
+                                   11, 13, -2, 1000, -4000, -123, 457};
+
+static vector<int> place(const gdsTransform &t, const vector<int> &inXY)
+{
+  vector<int> outXY(inXY.size());
+  t.apply(inXY.data(), outXY.data(), inXY.size() / 2);
+  return outXY;
+}
+
+// The table of manhattan agrees with the angle and reflection of GDS
+static void manhattan_is_trig()
+{
+  for (unsigned int o = 0; o < 8; o++) {
+    gdsTransform table = gdsTransform::manhattan(30, -40, o);
+    gdsTransform trig(30, -40, 90 * (o & 3), 1, o & 4);
+    CHECK(table.integral());
+    CHECK(place(table, points) == place(trig, points));
+  }
+  // Multiples of 90 outside of one turn
+  CHECK(place(gdsTransform(0, 0, -90), points) ==
+        place(gdsTransform::manhattan(0, 0, 3), points));
+  CHECK(place(gdsTransform(0, 0, 450), points) ==
+        place(gdsTransform::manhattan(0, 0, 1), points));
+}
+
+// (outer * inner) places a point where inner and then outer would
+static void composition()
+{
+  vector<gdsTransform> parts;
+  for (unsigned int o = 0; o < 8; o++)
+    parts.push_back(gdsTransform::manhattan(17 * o - 50, 3 - 11 * o, o));
+  parts.push_back(gdsTransform(5, 6, 90, 2, true));
+  parts.push_back(gdsTransform(-8, 9, 270, 3));
+
+  for (const auto &outer : parts) {
+    for (const auto &inner : parts) {
+      gdsTransform both = outer * inner;
+      CHECK(both.integral());
+      CHECK(place(both, points) == place(outer, place(inner, points)));
+      CHECK(both.magnification() ==
+            outer.magnification() * inner.magnification());
+    }
+  }
+
+  // Off the integral path the points are rounded once, after composing
+  gdsTransform outer(100, 0, 30), inner(0, 50, 60);
+  gdsTransform both = outer * inner;
+  CHECK(!both.integral());
+  vector<int> placed = place(both, points);
+  vector<int> quarter = place(gdsTransform(100, 0, 90), points);
+  vector<int> shifted = place(gdsTransform(0, 0, 30), {0, 50});
+  for (size_t i = 0; i < points.size(); i += 2) {
+    CHECK(placed[i] == quarter[i] + shifted[0]);
+    CHECK(placed[i + 1] == quarter[i + 1] + shifted[1]);
+  }
+}
+
+// Collects the flattened polygons in the order they arrive
+class polygonSink : public gdsFlatSink
+{
+public:
+  vector<vector<int>> polygons;
+  void onBoundary(unsigned int, unsigned int, const int *corXY,
+                  size_t cnt) override
+  {
+    polygons.emplace_back(corXY, corXY + 2 * cnt);
+  }
+};
+
+static vector<int> leaf_boundary()
+{
+  return {0, 0, 10, 0, 10, 4, 3, 9, 0, 0};
+}
+
+// Flattening a hierarchy gives the composed placements of its leaves
+static void flatten_hierarchy()
+{
+  gdscpp lib;
+  gdsSTR leaf;
+  leaf.name = "LEAF";
+  vector<int> corXY = leaf_boundary(), xCor, yCor;
+  for (size_t i = 0; i < corXY.size(); i += 2) {
+    xCor.push_back(corXY[i]);
+    yCor.push_back(corXY[i + 1]);
+  }
+  leaf.BOUNDARYarena.push_back(1, 0, 0, 0, xCor, yCor);
+  lib.push_back_STR(leaf);
+
+  gdsSTR mid;
+  mid.name = "MID";
+  mid.SREFcols.push_back(gdsName("LEAF"), 10, 20, 1);
+  mid.SREFcols.push_back(gdsName("LEAF"), -30, 5, 2, true);
+  lib.push_back_STR(mid);
+
+  gdsSTR top;
+  top.name = "TOP";
+  gdsSREF ref;
+  ref.name = gdsName("MID");
+  ref.xCor = 1000;
+  ref.yCor = -200;
+  ref.angle = 270;
+  ref.reflection = true;
+  ref.classify();
+  top.SREF.push_back(ref);
+  ref.xCor = -500;
+  ref.angle = 45;
+  ref.reflection = false;
+  ref.scale = 2;
+  ref.classify();
+  top.SREF.push_back(ref);
+  top.SREFcols.push_back(gdsName("MID"), 0, 700, 3);
+  lib.push_back_STR(top);
+
+  const vector<gdsTransform> outer = {
+      gdsTransform(1000, -200, 270, 1, true), gdsTransform(-500, -200, 45, 2),
+      gdsTransform::manhattan(0, 700, 3)};
+  const vector<gdsTransform> inner = {gdsTransform::manhattan(10, 20, 1),
+                                      gdsTransform::manhattan(-30, 5, 6)};
+  vector<vector<int>> expected;
+  for (const auto &o : outer)
+    for (const auto &i : inner)
+      expected.push_back(place(o * i, leaf_boundary()));
+
+  polygonSink serial;
+  CHECK(!lib.flatten(lib.STR_index("TOP"), serial, 1));
+  CHECK(serial.polygons == expected);
+
+  // The threads hand their polygons over in the same order
+  polygonSink parallel;
+  CHECK(!lib.flatten(lib.STR_index("TOP"), parallel, 4));
+  CHECK(parallel.polygons == expected);
+}
+
+int main()
+{
+  manhattan_is_trig();
+  composition();
+  flatten_hierarchy();
+  return TEST_RESULT();
+}
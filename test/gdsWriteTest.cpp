@@ -0,0 +1,141 @@
+/**
+ * Author:      Jude de Villiers
+ * Origin:      E&E Engineering - Stellenbosch University
+ * For:         Supertools, Coldflux Project - IARPA
+ * Created:     2020-04-21
+ * Modified:
+ * license:
+ * Description: A library written on several threads is byte for byte the
+ *              library written on one
+ * File:        gdsWriteTest.cpp
+ */
+
+#include "gdscpp/gdsCpp.hpp"
+#include <fstream>
+#include <iterator>
+#include "testCheck.hpp"
+
+using namespace std;
+
+// The file with the dates of BGNLIB and BGNSTR zeroed, empty if it does not
+// read as records
+static vector<unsigned char> withoutDates(const string &fileName){
+  ifstream inFile(fileName, ios::binary);
+  vector<unsigned char> bytes((istreambuf_iterator<char>(inFile)), istreambuf_iterator<char>());
+  for(size_t pos = 0; pos + 4 <= bytes.size();){
+    size_t length = (bytes[pos] << 8) | bytes[pos + 1];
+    if(length < 4 || pos + length > bytes.size()) return {};
+    if(bytes[pos + 2] == 0x01 || bytes[pos + 2] == 0x05){
+      fill(bytes.begin() + pos + 4, bytes.begin() + pos + length, 0);
+    }
+    pos += length;
+  }
+  return bytes;
+}
+
+// Written on 1 thread and on several, the bytes match
+static bool sameForAllThreads(gdscpp &lib, const string &fileName){
+  if(lib.write(fileName, 1)) return false;
+  vector<unsigned char> serial = withoutDates(fileName);
+  if(serial.empty()) return false;
+  for(unsigned int threads: {2u, 4u, 0u}){
+    if(lib.write(fileName, threads)) return false;
+    if(withoutDates(fileName) != serial) return false;
+  }
+  return true;
+}
+
+// Every kind of element, and more of them than one task holds so that
+// structures are split between tasks
+static void buildLibrary(gdscpp &lib){
+  gdsSTR leaf;
+  leaf.name = "LEAF";
+  leaf.compact_geometry = true;
+  leaf.BOUNDARYarena.push_back(1, 0, 0, 0, {0, 10, 10, 0, 0}, {0, 0, 10, 10, 0});
+  lib.push_back_STR(leaf);
+
+  gdsSTR big;
+  big.name = "BIG";
+  big.compact_geometry = true;
+  for(int i = 0; i < 9000; i++){
+    int x = (i % 100) * 20, y = (i / 100) * 20;
+    big.BOUNDARYarena.push_back(1 + i % 3, 0, 0, 0, {x, x + 10, x + 10, x, x}, {y, y, y + 10, y + 10, y});
+    if(i % 3 == 0) big.PATHarena.push_back(5, 0, 0, 4, {x, x + 15, x + 15}, {y, y, y + 5});
+    if(i % 5 == 0) big.SREFcols.push_back(gdsName("LEAF"), x, y, i % 4, i % 2);
+  }
+  for(int i = 0; i < 100; i++){
+    gdsBOUNDARY boundary;
+    boundary.layer = 7;
+    boundary.xCor = {0, i, i, 0, 0};
+    boundary.yCor = {0, 0, i + 1, i + 1, 0};
+    big.BOUNDARY.push_back(boundary);
+    gdsPATH path;
+    path.layer = 8;
+    path.width = 2;
+    path.xCor = {i, i + 30};
+    path.yCor = {-i, -i};
+    big.PATH.push_back(path);
+    gdsSREF ref;
+    ref.name = gdsName("LEAF");
+    ref.xCor = -100 * i;
+    ref.yCor = 7;
+    ref.angle = 90;
+    big.SREF.push_back(ref);
+    gdsAREF array;
+    array.name = gdsName("LEAF");
+    array.colCnt = 2 + i % 3;
+    array.rowCnt = 3;
+    array.xCor = i;
+    array.yCor = -i;
+    array.xCorRow = i + 20 * array.colCnt;
+    array.yCorRow = -i;
+    array.xCorCol = i;
+    array.yCorCol = -i + 60;
+    big.AREF.push_back(array);
+    gdsTEXT text;
+    text.layer = 9;
+    text.textbody = "T" + to_string(i);
+    text.xCor = i;
+    text.yCor = 2 * i;
+    big.TEXT.push_back(text);
+    gdsBOX box;
+    box.layer = 10;
+    box.xCor = {i, i + 5, i + 5, i, i};
+    box.yCor = {0, 0, 5, 5, 0};
+    big.BOX.push_back(box);
+  }
+  lib.push_back_STR(big);
+
+  // Many small structures end up in one task
+  for(int i = 0; i < 50; i++){
+    gdsSTR small;
+    small.name = "SMALL" + to_string(i);
+    small.compact_geometry = true;
+    small.BOUNDARYarena.push_back(2, 0, 0, 0, {0, i + 1, i + 1, 0, 0}, {0, 0, 3, 3, 0});
+    small.SREFcols.push_back(gdsName("BIG"), i * 3000, 0);
+    lib.push_back_STR(small);
+  }
+}
+
+int main(){
+  const string fileName = "gdsWriteTest.gds";
+  const string rewritten = "gdsWriteTest.rewritten.gds";
+  gdscpp lib;
+  buildLibrary(lib);
+  CHECK(sameForAllThreads(lib, fileName));
+
+  // Lazily imported structures are copied out of the mapped file
+  gdscpp lazy;
+  CHECK(!lazy.import_lazy(fileName));
+  CHECK(lazy.STR.size() == lib.STR.size());
+  CHECK(sameForAllThreads(lazy, rewritten));
+  // The same bytes as the library they were read from
+  CHECK(withoutDates(fileName) == withoutDates(rewritten));
+
+  // Loaded and lazy structures mixed
+  CHECK(!lazy.load_STR(lazy.STR_index("BIG")));
+  CHECK(lazy.STR[lazy.STR_index("BIG")].is_loaded());
+  CHECK(!lazy.STR[lazy.STR_index("SMALL7")].is_loaded());
+  CHECK(sameForAllThreads(lazy, rewritten));
+  return TEST_RESULT();
+}
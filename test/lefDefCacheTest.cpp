@@ -0,0 +1,93 @@
+/**
+ * Author:      Jude de Villiers
+ * Origin:      E&E Engineering - Stellenbosch University
+ * For:         Supertools, Coldflux Project - IARPA
+ * Created:     2020-04-21
+ * Modified:
+ * license:
+ * Description: LEF and DEF snapshots give back what was parsed, and only
+ *              what was parsed successfully gets one
+ * File:        lefDefCacheTest.cpp
+ */
+
+#include "chipsmith/ParserDef.hpp"
+#include "chipsmith/ParserLef.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "testCheck.hpp"
+
+using namespace std;
+
+static const string cacheDir = "lefDefCacheTest.cache";
+
+static string readText(const string &fileName){
+  ifstream inFile(fileName);
+  stringstream text;
+  text << inFile.rdbuf();
+  return text.str();
+}
+
+static void writeText(const string &fileName, const string &text){
+  ofstream outFile(fileName, ios::trunc);
+  outFile << text;
+}
+
+static void lefRoundTrip(){
+  const string lefName = "small.lef";
+  writeText(lefName, readText(TEST_DATA_DIR "/small.lef"));
+  remove(cacheFileName(lefName, cacheDir).c_str());
+
+  lef_file parsed;
+  CHECK(parsed.importFile(lefName));
+  CHECK(parsed.macros.size() == 3);
+  CHECK(!parsed.saveCache(lefName, cacheDir));
+
+  lef_file cached;
+  CHECK(!cached.loadCache(lefName, cacheDir));
+  CHECK(cached == parsed);
+
+  // A changed file does not use the old snapshot
+  writeText(lefName, readText(TEST_DATA_DIR "/small.lef") + "\n");
+  lef_file stale;
+  CHECK(stale.loadCache(lefName, cacheDir));
+}
+
+// A LEF file that stops early, or cannot be read, is an error
+static void lefErrors(){
+  const string text = readText(TEST_DATA_DIR "/small.lef");
+  writeText("truncated.lef", text.substr(0, text.find("MACRO DFF")));
+  lef_file truncated;
+  CHECK(!truncated.importFile("truncated.lef"));
+
+  lef_file missing;
+  CHECK(!missing.importFile("missing.lef"));
+}
+
+static void defRoundTrip(){
+  const string defName = "small.def";
+  writeText(defName, readText(TEST_DATA_DIR "/small.def"));
+  remove(cacheFileName(defName, cacheDir).c_str());
+
+  def_file parsed;
+  CHECK(parsed.importFile(defName));
+  CHECK(parsed.comps.size() == 21);
+  CHECK(parsed.nets.size() == 19);
+  CHECK(parsed.snets.size() == 1);
+  CHECK(!parsed.saveCache(defName, cacheDir));
+
+  def_file cached;
+  CHECK(!cached.loadCache(defName, cacheDir));
+  CHECK(cached == parsed);
+
+  writeText(defName, readText(TEST_DATA_DIR "/small.def") + "\n");
+  def_file stale;
+  CHECK(stale.loadCache(defName, cacheDir));
+}
+
+int main(){
+  lefRoundTrip();
+  lefErrors();
+  defRoundTrip();
+  return TEST_RESULT();
+}
@@ -0,0 +1,108 @@
+/**
+ * Author:      Jude de Villiers
+ * Origin:      E&E Engineering - Stellenbosch University
+ * For:         Supertools, Coldflux Project - IARPA
+ * Created:     2020-04-21
+ * Modified:
+ * license:
+ * Description: Box and point queries find what checking every item finds,
+ *              once each
+ * File:        spatialIndexTest.cpp
+ */
+
+#include "chipsmith/spatialIndex.hpp"
+#include <algorithm>
+#include <random>
+#include "testCheck.hpp"
+
+using namespace std;
+
+// Every item that touches or overlaps the box, the slow way
+static vector<unsigned int> bruteForce(const spatialIndex &index, int x0, int y0, int x1, int y1){
+  if(x0 > x1) swap(x0, x1);
+  if(y0 > y1) swap(y0, y1);
+  vector<unsigned int> found;
+  for(unsigned int i = 0; i < index.size(); i++){
+    const int *box = index.item(i).box;
+    if(box[0] <= x1 && box[2] >= x0 && box[1] <= y1 && box[3] >= y0) found.push_back(i);
+  }
+  return found;
+}
+
+static bool sameAsBruteForce(const spatialIndex &index, int x0, int y0, int x1, int y1){
+  vector<unsigned int> found;
+  size_t cnt = index.queryBox(x0, y0, x1, y1, found);
+  if(cnt != found.size()) return false;
+  sort(found.begin(), found.end());
+  return found == bruteForce(index, x0, y0, x1, y1);
+}
+
+// Gates, long thin tracks and points, corners in any order
+static void fillRandom(spatialIndex &index, mt19937 &random, unsigned int cnt){
+  uniform_int_distribution<int> place(-5000, 5000), small(0, 60), track(0, 4000), pick(0, 2);
+  for(unsigned int i = 0; i < cnt; i++){
+    int x = place(random), y = place(random);
+    switch(pick(random)){
+      case 0: index.insert(x, y, x + small(random), y + small(random), spatialIndex::gate, i); break;
+      case 1: index.insert(x + track(random), y, x, y + 2, spatialIndex::net, i); break;
+      default: index.insert(x, y, x, y, spatialIndex::via, i); break;
+    }
+  }
+}
+
+static void randomQueries(){
+  mt19937 random(2020);
+  uniform_int_distribution<int> place(-6000, 6000), size(0, 800);
+  for(unsigned int itemsPerBin: {1u, 4u, 64u}){
+    spatialIndex index;
+    fillRandom(index, random, 2000);
+    index.build(itemsPerBin);
+    for(int q = 0; q < 500; q++){
+      int x = place(random), y = place(random);
+      CHECK(sameAsBruteForce(index, x, y, x + size(random), y + size(random)));
+      // Reversed corners and single points
+      CHECK(sameAsBruteForce(index, x + size(random), y, x, y - size(random)));
+      CHECK(sameAsBruteForce(index, x, y, x, y));
+    }
+    // Everything, and nothing beyond the items
+    CHECK(sameAsBruteForce(index, -10000, -10000, 10000, 10000));
+    CHECK(sameAsBruteForce(index, 20000, 20000, 30000, 30000));
+  }
+}
+
+// Edges and corners are part of a box
+static void edges(){
+  spatialIndex index;
+  index.insert(0, 0, 100, 10, spatialIndex::net, 0);
+  index.insert(100, 10, 200, 20, spatialIndex::net, 1);
+  index.insert(-50, -50, -40, -40, spatialIndex::gate, 0);
+  index.build(1);
+  vector<unsigned int> found;
+  CHECK(index.queryPoint(100, 10, found) == 2);
+  CHECK(index.queryPoint(101, 10, found) == 1 && found[0] == 1);
+  CHECK(index.queryPoint(-40, -40, found) == 1 && index.item(found[0]).kind == spatialIndex::gate);
+  CHECK(index.queryBox(-39, -39, -1, -1, found) == 0);
+  CHECK(index.queryBox(-39, -39, 0, 0, found) == 1 && found[0] == 0);
+}
+
+// Nothing is found before build, or after a clear
+static void unbuilt(){
+  spatialIndex index;
+  vector<unsigned int> found = {7};
+  CHECK(index.queryBox(-10, -10, 10, 10, found) == 0 && found.empty());
+  index.build();
+  CHECK(!index.built());
+  index.insert(0, 0, 5, 5, spatialIndex::bias, 3);
+  CHECK(index.queryPoint(1, 1, found) == 0);
+  index.build();
+  CHECK(index.queryPoint(1, 1, found) == 1 && index.item(found[0]).index == 3);
+  index.clear();
+  CHECK(index.size() == 0 && index.queryPoint(1, 1, found) == 0);
+}
+
+int main(){
+  randomQueries();
+  edges();
+  unbuilt();
+  return TEST_RESULT();
+}
@@ -0,0 +1,33 @@
+/**
+ * Author:      J.F. de Villiers & H.F. Herbst
+ * Origin:  		E&E Engineering - Stellenbosch University
+ * For:					Supertools, Coldflux Project - IARPA
+ * Created: 		2019-08-26
+ * Modified:
+ * license:     MIT License
+ * Description: Checks shared by the test programs
+ * File:				testCheck.hpp
+ */
+
+#ifndef testCheck
+#define testCheck
+
+#include <iostream>
+
+// Number of checks that failed in this test program
+static int testFailures = 0;
+
+// Reports a failed condition and carries on, so one run shows every failure
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cout << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed" \
+                << std::endl;                                                  \
+      testFailures++;                                                          \
+    }                                                                          \
+  } while (0)
+
+// Return value of main
+#define TEST_RESULT() (testFailures == 0 ? 0 : 1)
+
+#endif